@@ -0,0 +1,130 @@
+/*
+ * bench_ai_drivers.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+/*
+ * Times the AI's decisions for growing fields of cars on a long circuit, with the pool at one
+ * thread and doubling up to the hardware's, so the cost per car and the gain from the cores can
+ * be read off.
+ *
+ *   bench_ai_drivers [cars] [ticks]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/parallel.h"
+#include "geometry/racing_line.h"
+#include "geometry/track_index.h"
+#include "systems/ai_driver_system.h"
+
+static glm::vec2 circuit( double t )		// t in [0, 1)
+{
+	const double pi = 3.141592653589793;
+	const double straight = 2000.0, radius = 300.0;
+	double perimeter = 2.0 * straight + 2.0 * pi * radius;
+	double s = t * perimeter;
+
+	if( s < straight )
+		return glm::vec2( s, 40.0 * std::sin( s / 150.0 ) );
+	s -= straight;
+	if( s < pi * radius )
+		return glm::vec2( straight + radius * std::sin( s / radius ), radius - radius * std::cos( s / radius ) );
+	s -= pi * radius;
+	if( s < straight )
+		return glm::vec2( straight - s, 2.0 * radius );
+
+	s -= straight;
+	return glm::vec2( -radius * std::sin( s / radius ), radius + radius * std::cos( s / radius ) );
+}
+
+int main( int argc, char ** argv )
+{
+	size_t most = argc > 1 ? std::stoul( argv[1] ) : 100000;
+	int ticks = argc > 2 ? std::stoi( argv[2] ) : 50;
+
+	std::vector<glm::vec2> centreline;
+	for( int i = 0; i < 4000; ++i )
+		centreline.push_back( circuit( i / 4000.0 ) );
+
+	TrackIndex index;
+	index.build( centreline, true, 14.0f );
+
+	RacingLine line;
+	auto start = std::chrono::steady_clock::now();
+	line.build( index );
+	auto end = std::chrono::steady_clock::now();
+
+	std::cout << "racing line of " << line.size() << " samples in " << std::chrono::duration<double, std::milli>( end - start ).count() << " ms\n";
+
+	unsigned hardware = std::max( 1u, std::thread::hardware_concurrency() );
+
+	for( size_t cars = most / 100 ? most / 100 : 1; cars <= most; cars *= 10 ) {
+
+		std::mt19937 random( 5 );
+		std::uniform_real_distribution<float> unit( 0.0f, 1.0f );
+
+		DriverBatch field;
+		field.resize( cars );
+
+		for( size_t i = 0; i < cars; ++i ) {
+			float arc = unit( random ) * index.length();
+			glm::vec2 ahead = index.point_at( arc + 1.0f ) - index.point_at( arc );
+
+			field.position[i] = index.point_at( arc ) + glm::vec2( unit( random ) - 0.5f, unit( random ) - 0.5f ) * 8.0f;
+			field.heading[i] = std::atan2( ahead.y, ahead.x );
+			field.speed[i] = 20.0f + unit( random ) * 40.0f;
+			field.grip[i] = 1.2f * 9.81f * 0.9f;
+			field.drive[i] = 7.5f;
+			field.wheelbase[i] = 2.5f;
+			field.max_steer[i] = 0.5f;
+			field.look_ahead[i] = 0.6f;
+			field.min_look_ahead[i] = 6.0f;
+			field.segment[i] = uint32_t( index.query( field.position[i] ).segment );
+		}
+
+		for( unsigned threads = 1; threads <= hardware; threads *= 2 ) {
+
+			WorkerPool pool( threads );
+			DriverBatch batch = field;
+
+			AIDriverSystem::decide( index, line, batch, pool );
+
+			start = std::chrono::steady_clock::now();
+			for( int tick = 0; tick < ticks; ++tick )
+				AIDriverSystem::decide( index, line, batch, pool );
+			end = std::chrono::steady_clock::now();
+
+			double ms = std::chrono::duration<double, std::milli>( end - start ).count() / ticks;
+
+			std::cout << cars << " cars, " << threads << " threads: " << ms << " ms per tick, "
+				<< ms * 1e6 / cars << " ns per car\n";
+
+			if( threads * 2 > hardware && threads != hardware )
+				threads = hardware / 2;
+		}
+	}
+
+	return 0;
+}
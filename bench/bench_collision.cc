@@ -0,0 +1,117 @@
+/*
+ * bench_collision.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+/*
+ * Times the contacts for a pack of cars driving round a ring road, tick after tick, at growing pack
+ * sizes so the growth in cost can be read off. The first tick of each size is checked against
+ * testing every pair.
+ *
+ *   bench_collision [cars] [ticks]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "geometry/collision.h"
+
+struct Car
+{
+	float lane, along, speed;
+};
+
+static void place( const std::vector<Car>& cars, float radius, std::vector<Box>& boxes )
+{
+	boxes.resize( cars.size() );
+
+	for( size_t i = 0; i < cars.size(); ++i ) {
+
+		float angle = cars[i].along / radius;
+		float r = radius + cars[i].lane;
+
+		boxes[i].centre = glm::vec2( r * std::cos( angle ), r * std::sin( angle ) );
+		boxes[i].axis = glm::vec2( -std::sin( angle ), std::cos( angle ) );
+		boxes[i].half_extents = glm::vec2( 2.2f, 0.9f );
+	}
+}
+
+static size_t every_pair( const std::vector<Box>& boxes )
+{
+	size_t count = 0;
+	Contact contact;
+
+	for( size_t a = 0; a < boxes.size(); ++a )
+		for( size_t b = a + 1; b < boxes.size(); ++b )
+			count += collide( boxes[a], boxes[b], contact );
+
+	return count;
+}
+
+int main( int argc, char ** argv )
+{
+	size_t most = argc > 1 ? std::stoul( argv[1] ) : 10000;
+	int ticks = argc > 2 ? std::stoi( argv[2] ) : 100;
+
+	for( size_t count = most / 100 ? most / 100 : 1; count <= most; count *= 10 ) {
+
+		// the same density of cars whatever their number: 12 m of a 20 m wide road per car
+		float radius = float( count ) * 12.0f / 6.2831853f;
+
+		std::mt19937 random( 11 );
+		std::uniform_real_distribution<float> unit( 0.0f, 1.0f );
+
+		std::vector<Car> cars( count );
+		for( auto& car : cars )
+			car = { ( unit( random ) - 0.5f ) * 20.0f, unit( random ) * 6.2831853f * radius, 40.0f + unit( random ) * 20.0f };
+
+		std::vector<Box> boxes;
+		std::vector<Contact> contacts;
+		SweepAndPrune sweep;
+
+		place( cars, radius, boxes );
+		sweep.contacts( boxes, contacts );
+
+		if( count <= 10000 && every_pair( boxes ) != contacts.size() )
+			std::cout << "MISMATCH against every pair at " << count << " cars\n";
+
+		size_t total = 0;
+		auto start = std::chrono::steady_clock::now();
+
+		for( int tick = 0; tick < ticks; ++tick ) {
+
+			for( auto& car : cars )
+				car.along += car.speed / 120.0f;
+
+			place( cars, radius, boxes );
+			sweep.contacts( boxes, contacts );
+			total += contacts.size();
+		}
+
+		auto end = std::chrono::steady_clock::now();
+		double ms = std::chrono::duration<double, std::milli>( end - start ).count() / ticks;
+
+		std::cout << count << " cars: " << ms << " ms per tick, " << double( total ) / ticks << " contacts\n";
+	}
+
+	return 0;
+}
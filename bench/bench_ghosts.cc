@@ -0,0 +1,167 @@
+/*
+ * bench_ghosts.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+/*
+ * Races a field of AI cars in a headless world with every car's laps recorded as ghosts, and
+ * reports what each car's best lap takes. One car's transforms are kept as they were, to time the
+ * encoding and decoding on their own and to measure how far the decoded transforms are off.
+ *
+ *   bench_ghosts [cars] [seconds]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "core/engine.h"
+#include "platforms/headless_platform.h"
+#include "systems/ghost_system.h"
+#include "systems/vehicle_system.h"
+#include "components/components.h"
+
+static glm::vec2 circuit( double t )		// t in [0, 1)
+{
+	const double pi = 3.141592653589793;
+	const double straight = 400.0, radius = 80.0;
+	double perimeter = 2.0 * straight + 2.0 * pi * radius;
+	double s = t * perimeter;
+
+	if( s < straight )
+		return glm::vec2( s, 25.0 * std::sin( s / 60.0 ) );
+	s -= straight;
+	if( s < pi * radius )
+		return glm::vec2( straight + radius * std::sin( s / radius ), radius - radius * std::cos( s / radius ) );
+	s -= pi * radius;
+	if( s < straight )
+		return glm::vec2( straight - s, 2.0 * radius );
+
+	s -= straight;
+	return glm::vec2( -radius * std::sin( s / radius ), radius + radius * std::cos( s / radius ) );
+}
+
+int main( int argc, char ** argv )
+{
+	size_t cars = argc > 1 ? std::stoul( argv[1] ) : 8;
+	double seconds = argc > 2 ? std::stod( argv[2] ) : 180.0;
+
+	HeadlessPlatform platform;
+	Engine engine( platform, true );
+	engine.init();
+
+	auto& registry = engine.get_registry();
+	auto& world = engine.get_world();
+	auto * ghosts = engine.get_system<GhostSystem>();
+
+	Entity track = registry.create_entity();
+	registry.create_component( track, "TrackComponent" );
+	auto * t = world.get_component<TrackComponent>( track );
+	for( int i = 0; i < 400; ++i )
+		t->centreline.push_back( circuit( i / 400.0 ) );
+	t->width = 14.0f;
+	t->closed = true;
+	t->dirty = true;
+
+	std::vector<Entity> field;
+	for( size_t i = 0; i < cars; ++i ) {
+
+		Entity car = registry.create_entity();
+		for( const char * name : { "TransformComponent", "VehicleComponent", "ColliderComponent", "AIDriverComponent" } )
+			registry.create_component( car, name );
+
+		world.get_component<TransformComponent>( car )->translation = glm::vec3( -10.0f - float( i / 2 ) * 8.0f, ( i % 2 ) ? 3.0f : -3.0f, 0.0f );
+		world.get_component<AIDriverComponent>( car )->pace = 0.8f + 0.1f * float( i % 3 );
+
+		ghosts->record( car );
+		field.push_back( car );
+	}
+
+	std::vector<double> times;
+	std::vector<TransformComponent> transforms;
+
+	for( double time = 0.0; time < seconds; time += VehicleSystem::step ) {
+		engine.step( VehicleSystem::step );
+		times.push_back( engine.get_system<VehicleSystem>()->get_time() );
+		transforms.push_back( *world.get_component<TransformComponent>( field[0] ) );
+	}
+
+	for( Entity car : field )
+		if( auto lap = ghosts->get_best( car ) )
+			std::cout << "car " << car << ": best lap " << lap->lap_time << " s, " << lap->samples << " samples in "
+				<< lap->bytes.size() / 1024.0 << " KiB, " << double( lap->bytes.size() ) / lap->samples << " bytes per sample\n";
+		else
+			std::cout << "car " << car << ": no lap\n";
+
+	// the first car's whole run through the encoder and back
+	GhostEncoder encoder;
+
+	auto start = std::chrono::steady_clock::now();
+	for( size_t i = 0; i < times.size(); ++i )
+		encoder.add( times[i], transforms[i] );
+	auto lap = std::make_shared<const GhostLap>( encoder.finish() );
+	auto end = std::chrono::steady_clock::now();
+
+	double encode_ns = std::chrono::duration<double, std::nano>( end - start ).count() / times.size();
+
+	GhostPlayer player( lap );
+	std::vector<TransformComponent> decoded( times.size() );
+
+	start = std::chrono::steady_clock::now();
+	for( size_t i = 0; i < times.size(); ++i )
+		player.transform_at( times[i] - times[0], decoded[i] );
+	end = std::chrono::steady_clock::now();
+
+	double decode_ns = std::chrono::duration<double, std::nano>( end - start ).count() / times.size();
+
+	float position_error = 0.0f, heading_error = 0.0f;
+	for( size_t i = 0; i < times.size(); ++i ) {
+		position_error = std::max( position_error, glm::length( decoded[i].translation - transforms[i].translation ) );
+		heading_error = std::max( heading_error, std::abs( decoded[i].rotation.z - transforms[i].rotation.z ) );
+	}
+
+	std::cout << times.size() << " samples of car " << field[0] << ": " << double( lap->bytes.size() ) / times.size() << " bytes per sample against "
+		<< sizeof( TransformComponent ) + sizeof( double ) << " raw, encoded in " << encode_ns << " ns and decoded in " << decode_ns
+		<< " ns per sample, off by at most " << position_error * 1000.0f << " mm and " << heading_error * 1000.0f << " mrad\n";
+
+	// the fastest lap as a ghost, a lap later it should be back where it started
+	if( auto fastest = ghosts->get_best() ) {
+
+		Entity ghost = ghosts->spawn( fastest );
+		glm::vec3 first = world.get_component<TransformComponent>( ghost )->translation;
+		float travelled = 0.0f;
+
+		glm::vec3 previous = first;
+		for( double time = 0.0; time < fastest->lap_time; time += VehicleSystem::step ) {
+			engine.step( VehicleSystem::step );
+			glm::vec3 now = world.get_component<TransformComponent>( ghost )->translation;
+			travelled += glm::length( now - previous );
+			previous = now;
+		}
+
+		std::cout << "ghost of the " << fastest->lap_time << " s lap drove " << travelled << " m and ended "
+			<< glm::length( previous - first ) << " m from where it started\n";
+	}
+
+	engine.shutdown();
+
+	return 0;
+}
@@ -0,0 +1,151 @@
+/*
+ * bench_kernels.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+/*
+ * Times the geometry kernels on every instruction set the processor has, against the plain loops they
+ * replaced, and checks that all instruction sets give the same bits.
+ *
+ *   bench_kernels [count]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "geometry/kernels.h"
+
+struct Buffers
+{
+	std::vector<float> angles, x, y;
+	std::vector<float> sines, cosines, noise, nx, ny, mx, my, length;
+
+	explicit Buffers( size_t count ) : angles( count ), x( count ), y( count ), sines( count ), cosines( count ),
+		noise( count ), nx( count ), ny( count ), mx( count ), my( count ), length( count )
+	{
+		for( size_t i = 0; i < count; ++i ) {
+			angles[i] = float( i ) / count * 6.2831853f;
+			x[i] = 300.0f * std::cos( angles[i] ) + 20.0f * std::sin( angles[i] * 17.0f );
+			y[i] = 200.0f * std::sin( angles[i] );
+		}
+	}
+
+	std::vector<float> results() const
+	{
+		std::vector<float> all;
+		for( auto * v : { &sines, &cosines, &noise, &nx, &ny, &mx, &my, &length } )
+			all.insert( all.end(), v->begin(), v->end() );
+		return all;
+	}
+};
+
+// what the ellipse, lake and ribbon code did per point before the kernels
+static void reference( Buffers& b )
+{
+	size_t count = b.angles.size();
+
+	for( size_t i = 0; i < count; ++i ) {
+		b.sines[i] = std::sin( b.angles[i] );
+		b.cosines[i] = std::cos( b.angles[i] );
+	}
+
+	for( size_t i = 0; i < count; ++i ) {
+		float t = b.angles[i] * 4.0f;
+		b.noise[i] = ( std::sin( t * 1.3f ) + std::sin( t * 0.7f + 2.0f ) + std::sin( t * 2.1f + 1.3f ) ) * 0.33f * 0.15f;
+	}
+
+	for( size_t i = 0; i + 1 < count; ++i ) {
+		float dx = b.x[i+1] - b.x[i], dy = b.y[i+1] - b.y[i];
+		float l = std::sqrt( dx * dx + dy * dy );
+		b.nx[i] = l > 1e-6f ? -dy / l : 0.0f;
+		b.ny[i] = l > 1e-6f ? dx / l : 0.0f;
+	}
+
+	for( size_t i = 0; i + 2 < count; ++i ) {
+		float x = b.nx[i] + b.nx[i+1], y = b.ny[i] + b.ny[i+1];
+		float l = std::sqrt( x * x + y * y );
+		float ratio = l > 1e-6f ? 2.0f / l : 0.0f;
+		b.mx[i] = l > 1e-6f ? x * ratio / l : 0.0f;
+		b.my[i] = l > 1e-6f ? y * ratio / l : 0.0f;
+		b.length[i] = ratio;
+	}
+}
+
+static void batched( Buffers& b )
+{
+	size_t count = b.angles.size();
+
+	kernels::sincos( b.angles.data(), b.sines.data(), b.cosines.data(), count );
+	kernels::lake_noise( b.angles.data(), 4.0f, 0.15f, b.noise.data(), count );
+	kernels::segment_normals( b.x.data(), b.y.data(), b.nx.data(), b.ny.data(), count );
+	kernels::miters( b.nx.data(), b.ny.data(), b.mx.data(), b.my.data(), b.length.data(), count - 1 );
+}
+
+static double time( const std::function<void()>& f )
+{
+	const int repeats = 20;
+
+	f();
+	auto start = std::chrono::steady_clock::now();
+	for( int i = 0; i < repeats; ++i )
+		f();
+	auto end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::milli>( end - start ).count() / repeats;
+}
+
+int main( int argc, char ** argv )
+{
+	size_t count = argc > 1 ? std::stoul( argv[1] ) : 1000003;
+
+	Buffers buffers( count );
+	std::cout << count << " points\n";
+
+	double base = time( [&]() { reference( buffers ); } );
+	std::cout << "  reference: " << base << " ms\n";
+
+	std::vector<float> expected;
+	bool identical = true;
+
+	for( auto isa : { kernels::Isa::Scalar, kernels::Isa::SSE2, kernels::Isa::AVX2 } ) {
+
+		if( isa > kernels::best_isa() )
+			break;
+
+		kernels::use_isa( isa );
+		double ms = time( [&]() { batched( buffers ); } );
+
+		std::vector<float> results = buffers.results();
+		if( expected.empty() )
+			expected = results;
+		else if( std::memcmp( results.data(), expected.data(), results.size() * sizeof(float) ) != 0 )
+			identical = false;
+
+		std::cout << "  " << kernels::isa_name( isa ) << ": " << ms << " ms, " << base / ms << "x\n";
+	}
+
+	kernels::use_isa( kernels::best_isa() );
+
+	std::cout << ( identical ? "  results identical on every instruction set\n" : "  results DIFFER between instruction sets\n" );
+
+	return identical ? 0 : 1;
+}
@@ -0,0 +1,115 @@
+/*
+ * bench_load.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+/*
+ * Compares peak memory and load time of LoadRequest (DOM) and StreamLoadRequest (SAX) on a
+ * generated scene with one long track. Each loader runs in its own process so that the peak
+ * resident set size reported by getrusage belongs to that loader alone.
+ *
+ *   bench_load [points]            generate the scene and run both loaders
+ *   bench_load dom|stream <file>   run one loader on an existing scene
+ */
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <sys/resource.h>
+
+#include "core/engine.h"
+#include "core/platform.h"
+#include "commands/load_request.h"
+#include "commands/stream_load_request.h"
+
+class NullPlatform : public IPlatform
+{
+public:
+	bool create_window( InputQueue& ) override { return true; }
+	void destroy_window() override {}
+
+	void begin_render() override {}
+	void present_frame() override {}
+
+	double get_time() override { return 0.0; }
+	void poll_events() override {}
+	bool should_close() override { return false; }
+};
+
+static long peak_rss_kb()
+{
+	rusage usage;
+	getrusage( RUSAGE_SELF, &usage );
+	return usage.ru_maxrss;
+}
+
+static void write_scene( const std::string& filename, int points )
+{
+	std::ofstream out( filename );
+
+	out << "{ \"entities\": [ { \"components\": { \"Track\": {\n";
+	out << "\"width\": 2.0, \"closed\": true, \"colour\": [0.0, 0.0, 0.0],\n\"points\": [\n";
+
+	for( int i = 0; i < points; ++i ) {
+		double t = 6.283185307179586 * i / points;
+		out << "[" << 500.0 * std::cos(t) << ", " << 300.0 * std::sin(3.0 * t) << ", 0.0]" << ( i + 1 < points ? ",\n" : "\n" );
+	}
+
+	out << "] } } } ] }\n";
+}
+
+static int run_loader( const std::string& mode, const std::string& filename )
+{
+	NullPlatform platform;
+	Engine engine( platform );
+
+	long baseline = peak_rss_kb();
+	auto start = std::chrono::steady_clock::now();
+
+	if( mode == "dom" )
+		LoadRequest( filename ).execute( engine );
+	else
+		StreamLoadRequest( filename ).execute( engine );
+
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	long peak = peak_rss_kb();
+
+	std::cout << mode << ":\tload " << elapsed.count() << " ms\tpeak rss " << peak << " kB\t(+" << peak - baseline << " kB during load)\n";
+
+	return 0;
+}
+
+int main( int argc, char** argv )
+{
+	if( argc == 3 )
+		return run_loader( argv[1], argv[2] );
+
+	int points = ( argc == 2 ) ? std::stoi( argv[1] ) : 500000;
+	std::string filename = "bench_track.json";
+
+	write_scene( filename, points );
+	std::cout << points << " centreline points" << std::endl;
+
+	std::string self = argv[0];
+	std::system( ( self + " dom " + filename ).c_str() );
+	std::system( ( self + " stream " + filename ).c_str() );
+
+	return 0;
+}
@@ -0,0 +1,214 @@
+/*
+ * bench_replication.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+/*
+ * Serves a headless world of moving and standing entities to viewers on the same machine and
+ * reports the bandwidth each viewer takes when it joins and once it keeps up, what gathering and
+ * encoding a state costs the server and decoding and applying it a viewer, and whether the viewers
+ * end up with the server's world. Viewer k reads its socket every k + 1 ticks, so the slower ones
+ * get their deltas against older states.
+ *
+ *   bench_replication [entities] [viewers] [ticks]
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "core/engine.h"
+#include "core/replication.h"
+#include "core/view.h"
+#include "platforms/headless_platform.h"
+#include "components/components.h"
+
+// half the entities drive round in circles, the other half are scenery
+static void build( Engine& engine, size_t entities )
+{
+	auto& registry = engine.get_registry();
+	auto& world = engine.get_world();
+
+	for( size_t i = 0; i < entities; ++i ) {
+
+		Entity e = registry.create_entity();
+		registry.create_component( e, "TransformComponent" );
+
+		float angle = float( i ) * 0.37f;
+		float radius = 50.0f + float( i % 100 );
+		world.get_component<TransformComponent>( e )->translation = glm::vec3( radius * std::cos( angle ), radius * std::sin( angle ), 0.0f );
+
+		if( i % 2 ) {
+			registry.create_component( e, "TriangleComponent" );
+			continue;
+		}
+
+		registry.create_component( e, "PointComponent" );
+		registry.create_component( e, "VelocityComponent" );
+		world.get_component<PointComponent>( e )->colour = glm::vec3( float( i % 7 ) / 7.0f, 0.5f, 1.0f );
+	}
+}
+
+static void steer( World& world, int tick )
+{
+	for( auto [entity, velocity, transform] : world.view<VelocityComponent, TransformComponent>() ) {
+		float angle = float( entity ) * 0.37f + float( tick ) * 0.01f;
+		velocity.speed = glm::vec3( -std::sin( angle ), std::cos( angle ), 0.0f ) * 20.0f;
+	}
+}
+
+// a few entities come and go every tick
+static void churn( Engine& engine, int tick, std::vector<Entity>& spawned )
+{
+	auto& registry = engine.get_registry();
+
+	if( spawned.size() > 20 ) {
+		registry.remove_entity( spawned.front() );
+		spawned.erase( spawned.begin() );
+	}
+
+	Entity e = registry.create_entity();
+	registry.create_component( e, "TransformComponent" );
+	registry.create_component( e, "PointComponent" );
+	engine.get_world().get_component<TransformComponent>( e )->translation.z = float( tick );
+	spawned.push_back( e );
+}
+
+// the world's replicated components in an order that does not depend on the entity numbers
+static std::vector<std::vector<float>> contents( World& world )
+{
+	std::vector<std::vector<float>> result;
+
+	for( auto [entity, transform] : world.view<TransformComponent>() ) {
+
+		std::vector<float> row;
+		auto add = [&row]( const glm::vec3& v ) { row.insert( row.end(), { v.x, v.y, v.z } ); };
+
+		add( transform.translation );
+		add( transform.rotation );
+		add( transform.scale );
+		if( auto * velocity = world.get_component<VelocityComponent>( entity ) )
+			add( velocity->speed );
+		if( auto * point = world.get_component<PointComponent>( entity ) )
+			add( point->colour );
+		if( auto * triangle = world.get_component<TriangleComponent>( entity ) )
+			for( auto& v : triangle->vertices )
+				add( v );
+
+		result.push_back( row );
+	}
+
+	std::sort( result.begin(), result.end() );
+	return result;
+}
+
+int main( int argc, char ** argv )
+{
+	size_t most = argc > 1 ? std::stoul( argv[1] ) : 10000;
+	size_t viewers = argc > 2 ? std::stoul( argv[2] ) : 4;
+	int ticks = argc > 3 ? std::stoi( argv[3] ) : 300;
+
+	const double step = 1.0 / 60.0;
+
+	for( size_t entities = most / 10 ? most / 10 : 1; entities <= most; entities *= 10 ) {
+
+		HeadlessPlatform platform;
+		Engine server( platform, true );
+		server.init();
+		build( server, entities );
+
+		if( !server.serve( 0 ) ) {
+			std::cerr << "bench_replication: can not open a socket\n";
+			return 1;
+		}
+
+		uint16_t port = server.get_replication_server()->get_port();
+
+		std::vector<std::unique_ptr<Engine>> clients;
+		for( size_t k = 0; k < viewers; ++k ) {
+			clients.push_back( std::make_unique<Engine>( platform, true ) );
+			clients.back()->init();
+			clients.back()->spectate( "127.0.0.1", port );
+		}
+
+		std::vector<Entity> spawned;
+		std::vector<uint64_t> joined( viewers, 0 );		// bytes received up to the first state
+		uint64_t sent_before = 0;
+		double serialise_before = 0.0;
+
+		for( int tick = 0; tick < ticks; ++tick ) {
+
+			steer( server.get_world(), tick );
+			churn( server, tick, spawned );
+			server.step( step );
+
+			// the viewers extrapolate nothing, so their worlds can be held against the server's
+			for( size_t k = 0; k < viewers; ++k ) {
+				if( tick % ( k + 1 ) )
+					continue;
+
+				clients[k]->step( 0.0 );
+
+				auto& stats = clients[k]->get_replication_client()->get_stats();
+				if( !joined[k] && stats.states )
+					joined[k] = stats.bytes_received;
+			}
+
+			if( tick == ticks / 2 ) {
+				sent_before = server.get_replication_server()->get_stats().bytes_sent;
+				serialise_before = server.get_replication_server()->get_stats().total_serialise_ms;
+			}
+		}
+
+		// the last state through to every viewer
+		server.step( step );
+		for( auto& client : clients )
+			client->step( 0.0 );
+
+		auto& stats = server.get_replication_server()->get_stats();
+		int measured = ticks - ticks / 2;
+		double per_tick = double( stats.bytes_sent - sent_before ) / measured / viewers;
+
+		std::cout << entities << " entities, " << viewers << " viewers: joining takes " << joined[0] / 1024 << " KiB, then "
+			<< per_tick / 1024.0 << " KiB per viewer a tick (" << per_tick * 60.0 * 8.0 / 1e6 << " Mbit/s at 60 Hz), "
+			<< stats.full_states << " full states sent\n";
+
+		std::cout << "  server gathers and encodes in " << ( stats.total_serialise_ms - serialise_before ) / measured
+			<< " ms a tick, " << stats.packets_sent / ( ticks + 1 ) << " datagrams a tick\n";
+
+		auto expected = contents( server.get_world() );
+
+		for( size_t k = 0; k < viewers; ++k ) {
+			auto& client = *clients[k]->get_replication_client();
+			auto& got = client.get_stats();
+			bool same = contents( clients[k]->get_world() ) == expected;
+
+			std::cout << "  viewer " << k << " applied " << got.states << " states, " << got.total_serialise_ms / got.states
+				<< " ms each to decode and apply, " << got.bytes_received / 1024 << " KiB in, world "
+				<< ( same ? "matches" : "DIFFERS" ) << "\n";
+		}
+
+		for( auto& client : clients )
+			client->shutdown();
+		server.shutdown();
+	}
+
+	return 0;
+}
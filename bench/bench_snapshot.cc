@@ -0,0 +1,161 @@
+/*
+ * bench_snapshot.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+/*
+ * Times snapshots and restores of a headless world racing growing fields of AI cars: a full copy
+ * of the stores, a delta against the snapshot a tick before, and putting the stores back with and
+ * without the systems catching up. Each size also checks that the race run again from a restored
+ * snapshot ends where it did the first time.
+ *
+ *   bench_snapshot [cars] [repeats]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "core/engine.h"
+#include "core/view.h"
+#include "platforms/headless_platform.h"
+#include "systems/vehicle_system.h"
+#include "components/components.h"
+
+static glm::vec2 circuit( double t, double straight )		// t in [0, 1)
+{
+	const double pi = 3.141592653589793;
+	const double radius = 300.0;
+	double perimeter = 2.0 * straight + 2.0 * pi * radius;
+	double s = t * perimeter;
+
+	if( s < straight )
+		return glm::vec2( s, 0.0 );
+	s -= straight;
+	if( s < pi * radius )
+		return glm::vec2( straight + radius * std::sin( s / radius ), radius - radius * std::cos( s / radius ) );
+	s -= pi * radius;
+	if( s < straight )
+		return glm::vec2( straight - s, 2.0 * radius );
+
+	s -= straight;
+	return glm::vec2( -radius * std::sin( s / radius ), radius + radius * std::cos( s / radius ) );
+}
+
+static void build( Engine& engine, size_t cars )
+{
+	auto& registry = engine.get_registry();
+	auto& world = engine.get_world();
+
+	// a car every 10 m on either side of a 14 m wide road
+	double straight = std::max( 2000.0, cars * 2.5 );
+
+	Entity track = registry.create_entity();
+	registry.create_component( track, "TrackComponent" );
+	auto * t = world.get_component<TrackComponent>( track );
+	for( int i = 0; i < 4000; ++i )
+		t->centreline.push_back( circuit( i / 4000.0, straight ) );
+	t->width = 14.0f;
+	t->closed = true;
+	t->dirty = true;
+
+	for( size_t i = 0; i < cars; ++i ) {
+
+		Entity car = registry.create_entity();
+		for( const char * name : { "TransformComponent", "VehicleComponent", "ColliderComponent", "AIDriverComponent" } )
+			registry.create_component( car, name );
+
+		auto * transform = world.get_component<TransformComponent>( car );
+		transform->translation = glm::vec3( float( i / 2 ) * 5.0f, ( i % 2 ) ? 3.0f : -3.0f, 0.0f );
+	}
+}
+
+static std::vector<float> positions( World& world )
+{
+	std::vector<float> result;
+	for( auto [entity, transform] : world.view<TransformComponent>() ) {
+		result.push_back( transform.translation.x );
+		result.push_back( transform.translation.y );
+	}
+	return result;
+}
+
+int main( int argc, char ** argv )
+{
+	size_t most = argc > 1 ? std::stoul( argv[1] ) : 10000;
+	int repeats = argc > 2 ? std::stoi( argv[2] ) : 100;
+
+	for( size_t cars = most / 100 ? most / 100 : 1; cars <= most; cars *= 10 ) {
+
+		HeadlessPlatform platform;
+		Engine engine( platform, true );
+		engine.init();
+
+		build( engine, cars );
+		for( int frame = 0; frame < 60; ++frame )
+			engine.step( VehicleSystem::step );
+
+		Registry::Snapshot full, previous, delta;
+		engine.snapshot( full );
+
+		// each one timed after a tick, so it meets the caches as a rollback buffer would
+		auto time = [&engine, repeats]( auto&& before, auto&& fn )
+		{
+			double ms = 0.0;
+			for( int i = 0; i < repeats; ++i ) {
+				before();
+				engine.step( VehicleSystem::step );
+
+				auto start = std::chrono::steady_clock::now();
+				fn();
+				ms += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+			}
+			return ms / repeats;
+		};
+
+		auto nothing = []() {};
+
+		double snapshot_ms = time( nothing, [&]() { engine.snapshot( full ); } );
+		double delta_ms = time( [&]() { engine.snapshot( previous ); }, [&]() { engine.snapshot( delta, &previous ); } );
+		double restore_ms = time( nothing, [&]() { engine.get_registry().restore( full ); } );
+		double rewind_ms = time( nothing, [&]() { engine.restore( full ); } );
+
+		engine.snapshot( full );
+		for( int frame = 0; frame < 240; ++frame )
+			engine.step( VehicleSystem::step );
+		auto first = positions( engine.get_world() );
+
+		engine.restore( full );
+		for( int frame = 0; frame < 240; ++frame )
+			engine.step( VehicleSystem::step );
+		auto again = positions( engine.get_world() );
+
+		bool same = first.size() == again.size() && !std::memcmp( first.data(), again.data(), first.size() * sizeof(float) );
+
+		engine.shutdown();
+
+		std::cout << cars << " cars: snapshot " << snapshot_ms << " ms, delta " << delta_ms << " ms, restore "
+			<< restore_ms << " ms, " << rewind_ms << " ms with the systems rewound, rerun from the snapshot "
+			<< ( same ? "matches" : "DIFFERS" ) << "\n";
+	}
+
+	return 0;
+}
@@ -0,0 +1,171 @@
+/*
+ * bench_telemetry.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+/*
+ * Pushes the telemetry of a field of cars going round a circle, tick after tick, from one or more
+ * threads, and reports what a push costs the producer, whether it allocated, what the file takes
+ * per record plain and delta encoded, and that the records read back are the ones pushed. A last
+ * run with small rings shows the drops being counted when the writer can not keep up.
+ *
+ *   bench_telemetry [cars] [ticks] [threads]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/telemetry.h"
+
+// counted on the producing threads only, once they have their ring
+static std::atomic<size_t> allocations { 0 };
+static thread_local bool producing = false;
+
+void * operator new( size_t size )
+{
+	if( producing )
+		++allocations;
+	if( void * p = std::malloc( size ? size : 1 ) )
+		return p;
+	throw std::bad_alloc();
+}
+
+void operator delete( void * p ) noexcept { std::free( p ); }
+void operator delete( void * p, size_t ) noexcept { std::free( p ); }
+
+static TelemetryRecord car_at( Entity car, uint64_t tick )
+{
+	float t = float( tick ) / 120.0f;
+	float angle = car * 0.01f + t * 0.1f;
+	float radius = 500.0f + ( car % 10 ) * 1.5f;
+
+	return { tick, car, radius * std::cos( angle ), radius * std::sin( angle ), angle + 1.5707963f,
+		-std::sin( angle ) * 50.0f, std::cos( angle ) * 50.0f, 0.1f, 0.8f, 0.0f, 0.05f };
+}
+
+// what making the records costs without pushing them, to take off the pushes' time
+static double making_ns( size_t cars, uint64_t ticks )
+{
+	volatile float sink = 0.0f;
+	auto start = std::chrono::steady_clock::now();
+
+	for( uint64_t tick = 0; tick <= ticks; ++tick )
+		for( Entity car = 0; car < cars; ++car )
+			sink = sink + car_at( car, tick ).x;
+
+	return std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - start ).count() / double( cars * ( ticks + 1 ) );
+}
+
+struct Run
+{
+	double push_ns;
+	size_t allocations;
+	TelemetryStats stats;
+};
+
+// threads split the cars between them
+static Run run( const std::string& filename, bool delta, size_t cars, uint64_t ticks, unsigned threads, size_t ring )
+{
+	Telemetry telemetry;
+	telemetry.open( filename, delta, ring );
+
+	std::vector<double> seconds( threads );
+
+	auto produce = [&]( unsigned thread )
+	{
+		Entity first = Entity( cars * thread / threads ), last = Entity( cars * ( thread + 1 ) / threads );
+
+		telemetry.push( car_at( first, 0 ) );		// takes this thread's ring
+		producing = true;
+
+		auto start = std::chrono::steady_clock::now();
+
+		for( uint64_t tick = 0; tick <= ticks; ++tick )
+			for( Entity car = tick ? first : first + 1; car < last; ++car )
+				telemetry.push( car_at( car, tick ) );
+
+		seconds[thread] = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+		producing = false;
+	};
+
+	allocations = 0;
+	std::vector<std::thread> pool;
+	for( unsigned t = 1; t < threads; ++t )
+		pool.emplace_back( produce, t );
+	produce( 0 );
+	for( auto& thread : pool )
+		thread.join();
+
+	telemetry.close();
+
+	double total = 0.0;
+	for( double s : seconds )
+		total += s;
+
+	return { total * 1e9 / double( cars * ( ticks + 1 ) - threads ), allocations, telemetry.get_stats() };
+}
+
+int main( int argc, char ** argv )
+{
+	size_t cars = argc > 1 ? std::stoul( argv[1] ) : 1000;
+	uint64_t ticks = argc > 2 ? std::stoull( argv[2] ) : 1200;
+	unsigned threads = argc > 3 ? unsigned( std::stoul( argv[3] ) ) : 2;
+
+	size_t records = cars * ( ticks + 1 );
+	double making = making_ns( cars, ticks );
+
+	for( bool delta : { false, true } ) {
+
+		// rings that hold everything, so nothing is dropped however the writer is scheduled
+		Run result = run( "bench_telemetry.rttm", delta, cars, ticks, threads, records );
+
+		std::vector<TelemetryRecord> read;
+		bool ok = read_telemetry( "bench_telemetry.rttm", read ) && read.size() == records;
+
+		if( ok ) {
+			std::sort( read.begin(), read.end(), []( auto& a, auto& b ) { return a.entity != b.entity ? a.entity < b.entity : a.tick < b.tick; } );
+
+			for( size_t i = 0; ok && i < read.size(); ++i ) {
+				TelemetryRecord expected = car_at( Entity( i / ( ticks + 1 ) ), i % ( ticks + 1 ) );
+				ok = !std::memcmp( &expected, &read[i], sizeof( TelemetryRecord ) );
+			}
+		}
+
+		std::cout << ( delta ? "delta" : "plain" ) << ": " << result.push_ns - making << " ns per push, " << result.allocations
+			<< " allocations while pushing, " << double( result.stats.bytes ) / records << " bytes per record ("
+			<< sizeof( TelemetryRecord ) << " in memory), read back " << ( ok ? "matches" : "DIFFERS" ) << "\n";
+	}
+
+	Run small = run( "bench_telemetry.rttm", true, cars, ticks, threads, 1024 );
+
+	std::cout << "1024 record rings: " << small.stats.written << " written, " << small.stats.dropped << " dropped, fullest ring at "
+		<< small.stats.peak_fill * 100.0 << "%\n";
+
+	std::remove( "bench_telemetry.rttm" );
+
+	return 0;
+}
@@ -0,0 +1,99 @@
+/*
+ * bench_tessellation.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+/*
+ * Times the track tessellation on generated circuits and reports how many vertices it produces. The
+ * circuits are a stadium with a wavy back straight, once given densely with evenly spaced points and
+ * once with only a handful of points per corner.
+ *
+ *   bench_tessellation [dense points]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "components/track_component.h"
+#include "components/mesh_component.h"
+#include "systems/track_system.h"
+
+static glm::vec2 circuit( double t )		// t in [0, 1)
+{
+	const double pi = 3.141592653589793;
+	const double straight = 2000.0, radius = 300.0;
+	double perimeter = 2.0 * straight + 2.0 * pi * radius;
+	double s = t * perimeter;
+
+	if( s < straight )
+		return glm::vec2( s, 40.0 * std::sin( s / 150.0 ) );
+	s -= straight;
+	if( s < pi * radius )
+		return glm::vec2( straight + radius * std::sin( s / radius ), radius - radius * std::cos( s / radius ) );
+	s -= pi * radius;
+	if( s < straight )
+		return glm::vec2( straight - s, 2.0 * radius );
+
+	s -= straight;
+	return glm::vec2( -radius * std::sin( s / radius ), radius + radius * std::cos( s / radius ) );
+}
+
+static void run( const std::string& name, const TrackComponent& track )
+{
+	std::cout << name << ": " << track.centreline.size() << " points\n";
+
+	for( float tolerance : { 1.0f, 0.1f, 0.01f, 0.001f } ) {
+
+		const int repeats = 5;
+		MeshData mesh;
+
+		auto start = std::chrono::steady_clock::now();
+		for( int i = 0; i < repeats; ++i )
+			mesh = TrackSystem::generate_mesh( track, tolerance );
+		auto end = std::chrono::steady_clock::now();
+
+		double ms = std::chrono::duration<double, std::milli>( end - start ).count() / repeats;
+
+		std::cout << "  tolerance " << tolerance << ": " << mesh.vertices.size() << " vertices, "
+				  << mesh.indices.size() / 3 << " triangles, " << ms << " ms\n";
+	}
+}
+
+int main( int argc, char ** argv )
+{
+	int dense = argc > 1 ? std::stoi( argv[1] ) : 200000;
+
+	TrackComponent track;
+	track.width = 12.0f;
+	track.closed = true;
+
+	for( int i = 0; i < dense; ++i )
+		track.centreline.push_back( circuit( double(i) / dense ) );
+
+	run( "dense", track );
+
+	track.centreline.clear();
+	for( int i = 0; i < 64; ++i )
+		track.centreline.push_back( circuit( i / 64.0 ) );
+
+	run( "sparse", track );
+
+	return 0;
+}
@@ -0,0 +1,117 @@
+/*
+ * bench_track_index.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+/*
+ * Times on-track queries for a field of cars against a long circuit: the scan over every segment,
+ * the grid one car at a time, batched and batched over a pool of threads. Every grid answer is checked against the scan.
+ *
+ *   bench_track_index [segments] [cars]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/parallel.h"
+#include "geometry/track_index.h"
+
+static glm::vec2 circuit( double t )		// t in [0, 1)
+{
+	const double pi = 3.141592653589793;
+	const double straight = 2000.0, radius = 300.0;
+	double perimeter = 2.0 * straight + 2.0 * pi * radius;
+	double s = t * perimeter;
+
+	if( s < straight )
+		return glm::vec2( s, 40.0 * std::sin( s / 150.0 ) );
+	s -= straight;
+	if( s < pi * radius )
+		return glm::vec2( straight + radius * std::sin( s / radius ), radius - radius * std::cos( s / radius ) );
+	s -= pi * radius;
+	if( s < straight )
+		return glm::vec2( straight - s, 2.0 * radius );
+
+	s -= straight;
+	return glm::vec2( -radius * std::sin( s / radius ), radius + radius * std::cos( s / radius ) );
+}
+
+static double time( const std::function<void()>& f )
+{
+	const int repeats = 10;
+
+	f();
+	auto start = std::chrono::steady_clock::now();
+	for( int i = 0; i < repeats; ++i )
+		f();
+	auto end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::milli>( end - start ).count() / repeats;
+}
+
+int main( int argc, char ** argv )
+{
+	size_t segments = argc > 1 ? std::stoul( argv[1] ) : 20000;
+	size_t cars = argc > 2 ? std::stoul( argv[2] ) : 1000;
+
+	std::vector<glm::vec2> line;
+	for( size_t i = 0; i < segments; ++i )
+		line.push_back( circuit( double(i) / segments ) );
+
+	TrackIndex index;
+	double build = time( [&]() { index.build( line, true, 12.0f ); } );
+
+	// cars spread around the circuit, some of them off the track
+	std::mt19937 random( 1 );
+	std::uniform_real_distribution<float> along( 0.0f, 1.0f ), across( -20.0f, 20.0f );
+
+	std::vector<glm::vec2> positions;
+	for( size_t i = 0; i < cars; ++i )
+		positions.push_back( circuit( along( random ) ) + glm::vec2( across( random ), across( random ) ) );
+
+	std::vector<TrackQuery> linear( cars ), single( cars ), batched( cars );
+
+	double scan = time( [&]() { for( size_t i = 0; i < cars; ++i ) linear[i] = index.query_linear( positions[i] ); } );
+	double grid = time( [&]() { for( size_t i = 0; i < cars; ++i ) single[i] = index.query( positions[i] ); } );
+	double batch = time( [&]() { index.query( positions.data(), batched.data(), cars ); } );
+
+	WorkerPool pool;
+	std::vector<TrackQuery> pooled( cars );
+	double in_pool = time( [&]() { index.query( positions.data(), pooled.data(), cars, &pool ); } );
+
+	size_t wrong = 0, on_surface = 0;
+	for( size_t i = 0; i < cars; ++i ) {
+		if( single[i].segment != linear[i].segment || single[i].distance != linear[i].distance || batched[i].segment != linear[i].segment || pooled[i].segment != linear[i].segment )
+			++wrong;
+		on_surface += linear[i].on_surface;
+	}
+
+	std::cout << index.segment_count() << " segments, " << index.length() << " long, built in " << build << " ms\n"
+			  << cars << " cars, " << on_surface << " on the surface\n"
+			  << "  scan:    " << scan << " ms\n"
+			  << "  grid:    " << grid << " ms, " << scan / grid << "x\n"
+			  << "  batched: " << batch << " ms, " << scan / batch << "x\n"
+			  << "  pooled:  " << in_pool << " ms, " << scan / in_pool << "x\n"
+			  << "  " << wrong << " answers differ from the scan\n";
+
+	return wrong == 0 ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+/*
+ * bench_vehicles.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+/*
+ * Times a second of racing for a field of cars, one fixed step after another, under each
+ * instruction set the machine has, and checks every run ends with the same bits.
+ *
+ *   bench_vehicles [cars]
+ */
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "geometry/kernels.h"
+#include "systems/vehicle_system.h"
+
+static VehicleState grid( size_t cars )
+{
+	std::mt19937 random( 7 );
+	std::uniform_real_distribution<float> unit( 0.0f, 1.0f );
+
+	VehicleState state;
+	state.resize( cars );
+
+	for( size_t i = 0; i < cars; ++i ) {
+		state.x[i] = float( i % 100 ) * 10.0f;
+		state.y[i] = float( i / 100 ) * 10.0f;
+		state.heading[i] = unit( random ) * 6.2831853f;
+		state.vx[i] = unit( random ) * 30.0f;
+
+		state.drive[i] = unit( random ) * 7.5f;
+		state.brake[i] = unit( random ) < 0.2f ? 15.0f : 0.0f;
+		state.drag[i] = 0.0005f;
+		state.turn[i] = ( unit( random ) - 0.5f ) * 0.4f;
+		state.grip[i] = 1.2f * 9.81f * ( unit( random ) < 0.1f ? 0.5f : 1.0f );
+	}
+
+	return state;
+}
+
+static bool same( const std::vector<float>& a, const std::vector<float>& b )
+{
+	return a.size() == b.size() && std::memcmp( a.data(), b.data(), a.size() * sizeof( float ) ) == 0;
+}
+
+int main( int argc, char ** argv )
+{
+	size_t cars = argc > 1 ? std::stoul( argv[1] ) : 10000;
+	const int steps = int( 1.0 / VehicleSystem::step );
+
+	const char * names[] = { "scalar", "sse2", "avx2" };
+	VehicleState reference;
+
+	for( kernels::Isa isa : { kernels::Isa::Scalar, kernels::Isa::SSE2, kernels::Isa::AVX2 } ) {
+
+		if( isa > kernels::best_isa() )
+			break;
+		kernels::use_isa( isa );
+
+		VehicleState state = grid( cars );
+
+		auto start = std::chrono::steady_clock::now();
+		VehicleSystem::integrate( state, 0, cars, float( VehicleSystem::step ), steps );
+		auto end = std::chrono::steady_clock::now();
+
+		double ms = std::chrono::duration<double, std::milli>( end - start ).count();
+
+		bool deterministic = true;
+		if( reference.size() == 0 )
+			reference = state;
+		else
+			deterministic = same( state.x, reference.x ) && same( state.y, reference.y ) && same( state.heading, reference.heading )
+				&& same( state.vx, reference.vx ) && same( state.vy, reference.vy );
+
+		std::cout << names[int( isa )] << ": " << cars << " cars x " << steps << " steps in " << ms << " ms, "
+			<< double( cars ) * steps / ms << " car steps per ms" << ( deterministic ? "" : ", DIFFERS from scalar" ) << "\n";
+	}
+
+	kernels::use_isa( kernels::best_isa() );
+
+	return 0;
+}
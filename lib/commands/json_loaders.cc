@@ -0,0 +1,322 @@
+/*
+ * json_loaders.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "json_loaders.h"
+
+#include "../core/registry.h"
+#include "../core/parallel.h"
+#include "../core/hash.h"
+
+#include "../components/components.h"
+
+#include <stdexcept>
+
+void load_from_json( PointComponent& comp, const nlohmann::json& json )
+{
+	auto [r,g,b] = json.value( "colour", std::array<float,3> {1.0f, 0.0f, 0.0f} );
+	comp.colour = glm::vec3( r, g, b );
+}
+
+void load_from_json( GeometryComponent& comp, const nlohmann::json& json )
+{
+	comp.axis_a = json.value( "axis_a", 1.0f );
+	comp.axis_b = json.value( "axis_b", 1.0f );
+	comp.segments = json.value( "segments", 4.0f );
+	comp.closed = json.value( "closed", true );
+	comp.filled = json.value( "filled", true );
+
+	auto [r,g,b] = json.value( "colour", std::array<float,3> {1.0f, 0.0f, 0.0f} );
+	comp.colour = glm::vec3( r, g, b );
+
+	comp.dirty = true;
+}
+
+void load_from_json( LakeComponent& comp, const nlohmann::json& json )
+{
+	comp.lake_axis_length = { json.value( "lake_axis_length", std::array<float,2> {15.0f, 25.0f} ) };
+	comp.lake_freq = json.value("lake_freq", 4.0f );
+	comp.lake_amp  = json.value("lake_amp", 0.15f );
+	comp.island_radius = json.value("island_radius", 6.0f );
+	comp.island_freq = json.value("island_freq", 3.0f );
+	comp.island_amp  = json.value("island_amp", 0.25f );
+	comp.segments = json.value("segments", 200);
+
+	comp.dirty = true;
+}
+
+void load_from_json( TrackComponent& track, const nlohmann::json& json )
+{
+	if( !json.contains("points") )
+		throw std::runtime_error("JSON error: missing required key 'points'");
+
+	if( !json["points"].is_array() )
+		throw std::runtime_error("JSON error: 'points' must be an array");
+
+	track.width = json["width"];
+	track.closed = json["closed"];
+	track.colour = {json["colour"][0], json["colour"][1],json["colour"][2] };
+	track.sectors = json.value( "sectors", std::vector<float>{} );
+
+	track.centreline.clear();
+	for( auto& p : json["points"] )
+		track.centreline.emplace_back( glm::vec2( p[0], p[1]) );
+
+	track.dirty = true;
+}
+
+void load_from_json( TransformComponent& comp, const nlohmann::json& json )
+{
+	auto [tx,ty,tz] = json.value( "translation", std::array<float, 3>{0.0f, 0.0f, 0.0f} );
+	comp.translation = glm::vec3( tx, ty, tz );
+
+	auto [rx,ry,rz] = json.value( "rotation", std::array<float, 3>{0.0f, 0.0f, 0.0f} );
+	comp.rotation = glm::vec3( rx, ry, rz );
+
+	auto [sx,sy,sz] = json.value( "scale", std::array<float, 3>{1.0f, 1.0f, 1.0f} );
+	comp.scale = glm::vec3( sx, sy, sz );
+}
+
+void load_from_json( TriangleComponent& comp, const nlohmann::json& json )
+{
+	std::array< std::array<float,3>, 3> defaults = {{
+		{{-1.0f, 0.0f, 0.0f}},
+		{{0.0f, 1.0f, 0.0f}},
+		{{1.0f, 0.0f, 0.0f}}
+	}};
+
+	for( int i=0; i < 3; ++i ) {
+		auto [vx,vy,vz] = json.value( std::string( "v" + std::to_string(i+1) ).c_str(), defaults[i] );
+		comp.vertices[i] = glm::vec3( vx,vy,vz );
+	}
+
+	auto [r,g,b] = json.value( "colour", std::array<float,3> {1.0f, 0.0f, 0.0f} );
+	comp.colour = glm::vec3( r, g, b );
+}
+
+void load_from_json( VelocityComponent& comp, const nlohmann::json& json )
+{
+	auto [vx,vy,vz] = json.value( "speed", std::array<float, 3>{0.0f, 0.0f, 0.0f} );
+	comp.speed = glm::vec3( vx, vy, vz );
+}
+
+void load_from_json( VehicleComponent& comp, const nlohmann::json& json )
+{
+	comp.mass = json.value( "mass", 800.0f );
+	comp.engine_force = json.value( "engine_force", 6000.0f );
+	comp.brake_force = json.value( "brake_force", 12000.0f );
+	comp.max_steer = json.value( "max_steer", 0.5f );
+	comp.wheelbase = json.value( "wheelbase", 2.5f );
+	comp.grip = json.value( "grip", 1.2f );
+	comp.drag = json.value( "drag", 0.4f );
+
+	auto [vx,vy] = json.value( "velocity", std::array<float, 2>{0.0f, 0.0f} );
+	comp.velocity = glm::vec2( vx, vy );
+}
+
+void load_from_json( ColliderComponent& comp, const nlohmann::json& json )
+{
+	auto [x,y] = json.value( "half_extents", std::array<float, 2>{2.2f, 0.9f} );
+	comp.half_extents = glm::vec2( x, y );
+}
+
+void load_from_json( AIDriverComponent& comp, const nlohmann::json& json )
+{
+	comp.look_ahead = json.value( "look_ahead", 0.6f );
+	comp.min_look_ahead = json.value( "min_look_ahead", 6.0f );
+	comp.pace = json.value( "pace", 0.9f );
+}
+
+#define STR(x) #x
+#define XSTR(x) STR(x)
+#define CAT(a,b) a##b
+
+#define X(Name) \
+    { STR(Name),\
+		{\
+			STR(Name), \
+			XSTR(CAT(Name,Component)), \
+			[](void* ptr, const nlohmann::json& j)\
+				{ load_from_json(*static_cast<Name##Component*>(ptr), j); },\
+			[](const nlohmann::json& j)\
+				{ Name##Component comp {}; load_from_json(comp, j); return std::any( std::move(comp) ); },\
+			[](void* ptr, std::any& value)\
+				{ *static_cast<Name##Component*>(ptr) = std::move( *std::any_cast<Name##Component>(&value) ); }\
+		}\
+	},
+
+
+const std::unordered_map<std::string, JsonData> json_loaders =
+{
+	#include "../components/loadable_components.def"
+};
+
+#undef X
+
+void decode_components( std::vector<ComponentPayload>& payloads, unsigned max_threads )
+{
+	// decoding does not touch the registry, so it can run on all cores
+	parallel_for( payloads.size(), [&payloads]( size_t i )
+	{
+		if( !payloads[i].component.has_value() )
+			payloads[i].component = payloads[i].json_data->decode( *payloads[i].json );
+	}, max_threads );
+}
+
+void store_components( Registry& registry, const std::vector<Entity>& entities, std::vector<ComponentPayload>& payloads )
+{
+	for( auto& payload : payloads ) {
+
+		auto& type_name = payload.json_data->type_name;
+		Entity e = entities[payload.entity];
+
+		registry.create_component( e, type_name );
+		registry.with_component( e, type_name, [&](void *ptr)
+		{
+			if( !ptr )		// worthy of an exception
+				return;
+
+			payload.json_data->store( ptr, payload.component );
+		} );
+	}
+}
+
+std::string scene_entity_id( const nlohmann::json& entity, size_t index )
+{
+	auto it = entity.find( "id" );
+
+	if( it != entity.end() && it->is_string() )
+		return it->get<std::string>();
+
+	return "#" + std::to_string( index );
+}
+
+uint64_t component_hash( const nlohmann::json& component, uint64_t points_hash )
+{
+	Hasher hasher;
+
+	for( auto& [key, value] : component.items() )
+		if( key != "points" )
+			hasher.add( key ).add( value.dump() );
+
+	return hasher.add( points_hash ).value();
+}
+
+uint64_t component_hash( const nlohmann::json& component )
+{
+	Hasher points;
+
+	auto it = component.find( "points" );
+	if( it != component.end() && it->is_array() )
+		for( auto& p : *it )
+			points.add( p[0].get<float>() ).add( p[1].get<float>() );
+
+	return component_hash( component, points.value() );
+}
+
+PrefabLibrary::PrefabLibrary( const nlohmann::json &definitions )
+{
+	if( !definitions.is_object() )
+		return;
+
+	std::vector<ComponentPayload> payloads;
+	std::vector<PrefabComponent*> targets;
+
+	for( auto& [prefab_name, definition] : definitions.items() ) {
+
+		Prefab& prefab = prefabs[prefab_name];
+
+		auto components = definition.find( "components" );
+		if( components == definition.end() )
+			continue;
+
+		for( auto& [name, component_data] : components->items() ) {
+
+			auto it = json_loaders.find( name );
+			if( it == json_loaders.end() )
+				continue;
+
+			PrefabComponent& component = prefab[name];
+			component.json = component_data;
+			component.hash = component_hash( component_data );
+
+			payloads.push_back( { 0, &it->second, &component.json } );
+			targets.push_back( &component );
+		}
+	}
+
+	decode_components( payloads );
+
+	for( size_t i = 0; i < payloads.size(); ++i )
+		targets[i]->component = std::move( payloads[i].component );
+}
+
+void PrefabLibrary::resolve( const nlohmann::json &entity, size_t index, std::vector<ComponentPayload> &payloads,
+							 std::unordered_map<std::string, uint64_t> &hashes, std::deque<nlohmann::json> &merged ) const
+{
+	const Prefab * prefab = nullptr;
+
+	auto prefab_name = entity.find( "prefab" );
+	if( prefab_name != entity.end() && prefab_name->is_string() ) {
+
+		auto it = prefabs.find( prefab_name->get<std::string>() );
+		if( it == prefabs.end() )
+			throw std::runtime_error( "JSON error: unknown prefab '" + prefab_name->get<std::string>() + "'" );
+
+		prefab = &it->second;
+	}
+
+	auto components = entity.find( "components" );
+	bool has_components = ( components != entity.end() && components->is_object() );
+
+	if( has_components ) {
+
+		for( auto& [name, component_data] : components->items() ) {
+
+			auto it = json_loaders.find( name );
+			if( it == json_loaders.end() )
+				continue;
+
+			const nlohmann::json * json = &component_data;
+
+			if( prefab ) {
+				auto base = prefab->find( name );
+				if( base != prefab->end() ) {
+					merged.push_back( base->second.json );
+					merged.back().merge_patch( component_data );
+					json = &merged.back();
+				}
+			}
+
+			payloads.push_back( { index, &it->second, json } );
+			hashes[name] = component_hash( *json );
+		}
+	}
+
+	if( !prefab )
+		return;
+
+	for( auto& [name, component] : *prefab ) {
+
+		if( has_components && components->contains( name ) )
+			continue;
+
+		payloads.push_back( { index, &json_loaders.at( name ), &component.json, component.component } );
+		hashes[name] = component.hash;
+	}
+}
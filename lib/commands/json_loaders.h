@@ -0,0 +1,97 @@
+/*
+ * json_loaders.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <any>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../vendor/nlohmann/json.hpp"
+
+#include "../core/world.h"
+
+class Registry;
+
+using JsonLoaderFn = void(*)(void*, const nlohmann::json&);
+using JsonDecodeFn = std::any(*)(const nlohmann::json&);
+using ComponentStoreFn = void(*)(void*, std::any&);
+
+struct JsonData
+{
+	std::string name;
+	std::string type_name;
+	JsonLoaderFn loader;
+	JsonDecodeFn decode;		// loads into a detached component, safe to call from any thread
+	ComponentStoreFn store;		// moves a decoded component into the registry owned one
+};
+
+// maps the component name used in the scene files onto the registered component type and its loader
+extern const std::unordered_map<std::string, JsonData> json_loaders;
+
+// one component of the scene file on its way into the registry
+struct ComponentPayload
+{
+	size_t entity = 0;			// index into the entity list handed to store_components
+	const JsonData * json_data = nullptr;
+	const nlohmann::json * json = nullptr;
+	std::any component {};		// already set when copied from a prefab
+};
+
+void decode_components( std::vector<ComponentPayload>& payloads, unsigned max_threads = 0 );
+void store_components( Registry& registry, const std::vector<Entity>& entities, std::vector<ComponentPayload>& payloads );
+
+// the "id" of an entity in the scene file, entities without one are identified by their position
+std::string scene_entity_id( const nlohmann::json& entity, size_t index );
+
+// fingerprint of a component's json. Track points are hashed by value on the side so that the
+// streaming loader, which never holds them as json, can produce the same fingerprint.
+uint64_t component_hash( const nlohmann::json& component, uint64_t points_hash );
+uint64_t component_hash( const nlohmann::json& component );
+
+/*
+ * The "prefabs" of a scene file. An entity naming a prefab gets all of its components; the ones the
+ * entity lists itself are merged over the prefab's json (RFC 7386 merge patch). Prefab components are
+ * decoded once and instances that do not override them get a copy of the decoded component.
+ */
+class PrefabLibrary
+{
+public:
+	PrefabLibrary() = default;
+	explicit PrefabLibrary( const nlohmann::json& prefabs );
+
+	// appends the payloads of one entity and records the fingerprint of each of its components
+	void resolve( const nlohmann::json& entity, size_t index, std::vector<ComponentPayload>& payloads,
+				  std::unordered_map<std::string, uint64_t>& hashes, std::deque<nlohmann::json>& merged ) const;
+
+private:
+	struct PrefabComponent
+	{
+		nlohmann::json json;
+		std::any component;
+		uint64_t hash;
+	};
+
+	using Prefab = std::unordered_map<std::string, PrefabComponent>;
+
+	std::unordered_map<std::string, Prefab> prefabs;
+};
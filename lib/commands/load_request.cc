@@ -20,164 +20,65 @@
 #include "load_request.h"
 
 #include "../core/engine.h"
+#include "../core/binary_stream.h"
 #include "../core/world.h"
 #include "../core/registry.h"
 
 #include <fstream>
+#include <stdexcept>
 
-#include "../components/components.h"
+#include "json_loaders.h"
 
-void load_from_json( PointComponent& comp, const nlohmann::json& json )
-{
-	auto [r,g,b] = json.value( "colour", std::array<float,3> {1.0f, 0.0f, 0.0f} );
-	comp.colour = glm::vec3( r, g, b );
-}
-
-void load_from_json( GeometryComponent& comp, const nlohmann::json& json )
+void LoadRequest::execute( Engine &engine )
 {
-	comp.axis_a = json.value( "axis_a", 1.0f );
-	comp.axis_b = json.value( "axis_b", 1.0f );
-	comp.segments = json.value( "segments", 4.0f );
-	comp.closed = json.value( "closed", true );
-	comp.filled = json.value( "filled", true );
-
-	auto [r,g,b] = json.value( "colour", std::array<float,3> {1.0f, 0.0f, 0.0f} );
-	comp.colour = glm::vec3( r, g, b );
-
-	comp.dirty = true;
-}
+	auto& registry = engine.get_registry();
 
-void load_from_json( LakeComponent& comp, const nlohmann::json& json )
-{
-	comp.lake_axis_length = { json.value( "lake_axis_length", std::array<float,2> {15.0f, 25.0f} ) };
-	comp.lake_freq = json.value("lake_freq", 4.0f );
-	comp.lake_amp  = json.value("lake_amp", 0.15f );
-	comp.island_radius = json.value("island_radius", 6.0f );
-	comp.island_freq = json.value("island_freq", 3.0f );
-	comp.island_amp  = json.value("island_amp", 0.25f );
-	comp.segments = json.value("segments", 200);
-
-	comp.generate_lake();
-}
+    std::ifstream datafile( filename );
 
-void load_from_json( TrackComponent& track, const nlohmann::json& json )
-{
-	if( !json.contains("points") )
-		throw std::runtime_error("JSON error: missing required key 'points'");
+    if( !datafile.is_open() )
+        return;
 
-	if( !json["points"].is_array() )
-		throw std::runtime_error("JSON error: 'points' must be an array");
+    nlohmann::json data;
+    datafile >> data;
 
-	track.width = json["width"];
-	track.closed = json["closed"];
-	track.colour = {json["colour"][0], json["colour"][1],json["colour"][2] };
+	auto& entities = data["entities"];
 
-	track.centreline.clear();
-	for( auto& p : json["points"] )
-		track.centreline.emplace_back( glm::vec2( p[0], p[1]) );
+	PrefabLibrary prefabs( data.value( "prefabs", nlohmann::json::object() ) );
 
-	track.dirty = true;
-}
+	Scene scene { filename };
+	std::vector<std::string> ids;
+	std::vector<ComponentPayload> payloads;
+	std::deque<nlohmann::json> merged;
 
-void load_from_json( TransformComponent& comp, const nlohmann::json& json )
-{
-	auto [tx,ty,tz] = json.value( "translation", std::array<float, 3>{0.0f, 0.0f, 0.0f} );
-	comp.translation = glm::vec3( tx, ty, tz );
+	for( size_t i = 0; i < entities.size(); ++i ) {
 
-	auto [rx,ry,rz] = json.value( "rotation", std::array<float, 3>{0.0f, 0.0f, 0.0f} );
-	comp.rotation = glm::vec3( rx, ry, rz );
+		ids.push_back( scene_entity_id( entities[i], i ) );
 
-	auto [sx,sy,sz] = json.value( "scale", std::array<float, 3>{1.0f, 1.0f, 1.0f} );
-	comp.scale = glm::vec3( sx, sy, sz );
-}
+		auto [slot, inserted] = scene.entities.try_emplace( ids.back() );
+		if( !inserted )
+			throw std::runtime_error( "JSON error: duplicate entity id '" + ids.back() + "'" );
 
-void load_from_json( TriangleComponent& comp, const nlohmann::json& json )
-{
-	std::array< std::array<float,3>, 3> defaults = {{
-		{{-1.0f, 0.0f, 0.0f}},
-		{{0.0f, 1.0f, 0.0f}},
-		{{1.0f, 0.0f, 0.0f}}
-	}};
-
-	for( int i=0; i < 3; ++i ) {
-		auto [vx,vy,vz] = json.value( std::string( "v" + std::to_string(i+1) ).c_str(), defaults[i] );
-		comp.vertices[i] = glm::vec3( vx,vy,vz );
+		prefabs.resolve( entities[i], i, payloads, slot->second.components, merged );
 	}
 
-	auto [r,g,b] = json.value( "colour", std::array<float,3> {1.0f, 0.0f, 0.0f} );
-	comp.colour = glm::vec3( r, g, b );
-}
-
-void load_from_json( VelocityComponent& comp, const nlohmann::json& json )
-{
-	auto [vx,vy,vz] = json.value( "speed", std::array<float, 3>{0.0f, 0.0f, 0.0f} );
-	comp.speed = glm::vec3( vx, vy, vz );
-}
-
-#define STR(x) #x
-#define XSTR(x) STR(x)
-#define CAT(a,b) a##b
-
-using JsonLoaderFn = void(*)(void*, const nlohmann::json&);
-struct JsonData
-{
-	std::string type_name;
-	JsonLoaderFn loader;
-};
-
-#define X(Name) \
-    { STR(Name),\
-		{\
-			XSTR(CAT(Name,Component)), \
-			[](void* ptr, const nlohmann::json& j)\
-				{ load_from_json(*static_cast<Name##Component*>(ptr), j); }\
-		}\
-	},
-
-
-const std::unordered_map<std::string, JsonData> json_loaders =
-{
-	#include "../components/loadable_components.def"
-};
-
-#undef X
-
-void LoadRequest::execute( Engine &engine )
-{
-	auto& registry = engine.get_registry();
-
-    std::ifstream datafile( filename );
-
-    if( !datafile.is_open() )
-        return;
-
-    nlohmann::json data;
-    datafile >> data;
+	decode_components( payloads );
 
 	registry.clear();
 
-    for( auto& ent : data["entities"] ) {
-
-        Entity e = registry.create_entity();
+	auto entity_ids = registry.create_entities( entities.size() );
 
-        for( auto [name, component_data] : ent["components"].items() )
-		{
-			auto it = json_loaders.find( name );
+	store_components( registry, entity_ids, payloads );
 
-			if( ( it == json_loaders.end() ) )
-				continue;
+	for( size_t i = 0; i < ids.size(); ++i )
+		scene.entities[ids[i]].entity = entity_ids[i];
 
-			auto type_name = it->second.type_name;
-			auto loader = it->second.loader;
+	engine.get_scene() = std::move( scene );
+}
 
-            registry.create_component( e, type_name );
-			registry.with_component( e, type_name, [&](void *ptr)
-			{
-				if( !ptr )		// worthy of an exception
-					return;
+LoadRequest::LoadRequest( BinaryReader& in ) : filename( in.get_string() )
+{}
 
-				loader( ptr, component_data );
-			} );
-		}
-    }
+void LoadRequest::write( BinaryWriter& out ) const
+{
+	out.put( filename );
 }
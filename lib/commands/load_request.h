@@ -23,12 +23,16 @@
 
 #include "../core/command.h"
 
+class BinaryReader;
+
 class LoadRequest : public ICommand
 {
 public:
 	LoadRequest( std::string filename ) : filename( filename ) {}
+	LoadRequest( BinaryReader& in );
 
 	void execute( Engine& engine ) override;
+	void write( BinaryWriter& out ) const override;
 
 private:
 	std::string filename;
@@ -0,0 +1,62 @@
+/*
+ * region_load_request.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "region_load_request.h"
+
+#include <filesystem>
+
+#include "../core/engine.h"
+#include "../core/binary_stream.h"
+#include "../core/hash.h"
+
+#include "scene_partition.h"
+#include "../systems/resource_system.h"
+#include "../systems/streaming_system.h"
+
+void RegionLoadRequest::execute( Engine &engine )
+{
+	auto * streaming = engine.get_system<StreamingSystem>();
+	if( !streaming )
+		return;
+
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "racetrack";
+
+	if( auto * resources = engine.get_system<ResourceSystem>(); resources && !resources->get_cache_directory().empty() )
+		directory = resources->get_cache_directory();
+
+	std::error_code error;
+	Hasher source;
+	source.add( std::filesystem::absolute( filename, error ).string() );
+
+	CellIndex index;
+
+	if( !partition_scene( filename, cell_size, directory / "cells" / std::to_string( source.value() ), index ) )
+		return;
+
+	streaming->open( std::move( index ) );
+}
+
+RegionLoadRequest::RegionLoadRequest( BinaryReader& in ) : filename( in.get_string() ), cell_size( in.get<float>() )
+{}
+
+void RegionLoadRequest::write( BinaryWriter& out ) const
+{
+	out.put( filename );
+	out.put( cell_size );
+}
@@ -0,0 +1,44 @@
+/*
+ * region_load_request.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "../core/command.h"
+
+class BinaryReader;
+
+/*
+ * Loads a scene for streaming: the file is cut into cells of cell_size world units (see
+ * scene_partition.h) which the StreamingSystem then loads around the focus as it moves.
+ */
+class RegionLoadRequest : public ICommand
+{
+public:
+	RegionLoadRequest( std::string filename, float cell_size = 100.0f ) : filename( filename ), cell_size( cell_size ) {}
+	RegionLoadRequest( BinaryReader& in );
+
+	void execute( Engine& engine ) override;
+	void write( BinaryWriter& out ) const override;
+
+private:
+	std::string filename;
+	float cell_size;
+};
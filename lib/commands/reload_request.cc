@@ -0,0 +1,142 @@
+/*
+ * reload_request.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "reload_request.h"
+
+#include "../core/engine.h"
+#include "../core/binary_stream.h"
+#include "../core/world.h"
+#include "../core/registry.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "json_loaders.h"
+#include "load_request.h"
+
+void ReloadRequest::execute( Engine &engine )
+{
+	try {
+		apply( engine );
+	}
+	catch( const std::exception& e ) {
+		std::cerr << "racetrack: can not reload " << filename << ": " << e.what() << "\n";
+	}
+}
+
+void ReloadRequest::apply( Engine &engine )
+{
+	auto& registry = engine.get_registry();
+	auto& scene = engine.get_scene();
+
+	if( scene.filename != filename ) {		// nothing loaded to compare against
+		LoadRequest( filename ).execute( engine );
+		return;
+	}
+
+	std::ifstream datafile( filename );
+
+	if( !datafile.is_open() )
+		return;
+
+	nlohmann::json data;
+	datafile >> data;
+
+	auto& entities = data["entities"];
+
+	PrefabLibrary prefabs( data.value( "prefabs", nlohmann::json::object() ) );
+
+	std::unordered_map<std::string, SceneEntity> next;
+	std::vector<std::string> ids;
+	std::vector<Entity> targets;
+	std::vector<ComponentPayload> payloads;
+	std::deque<nlohmann::json> merged;
+	std::vector<std::pair<Entity, std::string>> stale_components;
+
+	for( size_t i = 0; i < entities.size(); ++i ) {
+
+		ids.push_back( scene_entity_id( entities[i], i ) );
+
+		auto [slot, inserted] = next.try_emplace( ids.back() );
+		if( !inserted )
+			throw std::runtime_error( "JSON error: duplicate entity id '" + ids.back() + "'" );
+
+		auto& scene_entity = slot->second;
+		auto previous = scene.entities.find( ids.back() );
+		bool existing = ( previous != scene.entities.end() );
+
+		scene_entity.entity = existing ? previous->second.entity : InvalidEntity;
+		targets.push_back( scene_entity.entity );
+
+		size_t first = payloads.size();
+		prefabs.resolve( entities[i], i, payloads, scene_entity.components, merged );
+
+		if( !existing )
+			continue;
+
+		auto& old_components = previous->second.components;
+
+		// keep only the payloads of components that changed
+		auto unchanged = [&]( const ComponentPayload& payload )
+		{
+			auto old = old_components.find( payload.json_data->name );
+			return old != old_components.end() && old->second == scene_entity.components[payload.json_data->name];
+		};
+
+		payloads.erase( std::remove_if( payloads.begin() + first, payloads.end(), unchanged ), payloads.end() );
+
+		for( auto& [name, hash] : old_components )
+			if( !scene_entity.components.count( name ) )
+				stale_components.push_back( { scene_entity.entity, name } );
+	}
+
+	decode_components( payloads );		// may throw, the world is left alone until here
+
+	for( auto& [id, scene_entity] : scene.entities )
+		if( !next.count( id ) )
+			registry.remove_entity( scene_entity.entity );
+
+	for( auto& [e, name] : stale_components ) {
+
+		registry.remove_component( e, json_loaders.at( name ).type_name );
+
+		if( name == "Geometry" || name == "Track" )		// the mesh was generated from it
+			registry.remove_component( e, "MeshComponent" );
+	}
+
+	for( size_t i = 0; i < targets.size(); ++i )
+		if( targets[i] == InvalidEntity ) {
+			targets[i] = registry.create_entity();
+			next[ids[i]].entity = targets[i];
+		}
+
+	store_components( registry, targets, payloads );
+
+	scene.entities = std::move( next );
+}
+
+ReloadRequest::ReloadRequest( BinaryReader& in ) : filename( in.get_string() )
+{}
+
+void ReloadRequest::write( BinaryWriter& out ) const
+{
+	out.put( filename );
+}
@@ -0,0 +1,48 @@
+/*
+ * reload_request.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "../core/command.h"
+
+class BinaryReader;
+
+/*
+ * Re-reads the scene file the world was loaded from and applies only the differences: entities are
+ * matched on their "id", new ones are created, vanished ones removed, and only components whose json
+ * changed are decoded again. Untouched entities keep their components, meshes and dirty state.
+ * A file that does not load, saved half way through an edit say, is reported on stderr and the
+ * world is left as it was.
+ */
+class ReloadRequest : public ICommand
+{
+public:
+	ReloadRequest( std::string filename ) : filename( filename ) {}
+	ReloadRequest( BinaryReader& in );
+
+	void execute( Engine& engine ) override;
+	void write( BinaryWriter& out ) const override;
+
+private:
+	std::string filename;
+
+	void apply( Engine& engine );
+};
@@ -0,0 +1,142 @@
+/*
+ * scene_partition.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "scene_partition.h"
+
+#include <deque>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include "json_loaders.h"
+
+std::filesystem::path cell_filename( uint64_t key )
+{
+	return std::to_string( cell_x( key ) ) + "_" + std::to_string( cell_y( key ) ) + ".json";
+}
+
+static glm::vec2 entity_position( const nlohmann::json& components )
+{
+	auto transform = components.find( "Transform" );
+	if( transform == components.end() )
+		return glm::vec2( 0.0f );
+
+	auto [tx,ty,tz] = transform->value( "translation", std::array<float, 3>{0.0f, 0.0f, 0.0f} );
+
+	return glm::vec2( tx, ty );
+}
+
+// one piece per run of points in the same cell, each piece ends on the first point of the next one so the pieces join up
+static void split_track( const std::string& id, const nlohmann::json& components, float cell_size,
+						 std::unordered_map<uint64_t, nlohmann::json>& cells )
+{
+	const nlohmann::json& track = components["Track"];
+
+	std::vector<nlohmann::json> points( track["points"].begin(), track["points"].end() );
+	if( track.value( "closed", false ) )
+		points.push_back( points.front() );
+
+	auto cell_of_point = [cell_size]( const nlohmann::json& point )
+		{ return cell_of( glm::vec2( point[0].get<float>(), point[1].get<float>() ), cell_size ); };
+
+	size_t start = 0;
+	size_t piece = 0;
+
+	while( start + 1 < points.size() ) {
+
+		uint64_t key = cell_of_point( points[start] );
+
+		size_t end = start + 1;
+		while( end + 1 < points.size() && cell_of_point( points[end] ) == key )
+			++end;
+
+		nlohmann::json piece_components = components;
+		piece_components["Track"]["points"] = std::vector<nlohmann::json>( points.begin() + start, points.begin() + end + 1 );
+		piece_components["Track"]["closed"] = false;
+
+		cells[key].push_back( { { "id", id + "/" + std::to_string( piece++ ) }, { "components", std::move( piece_components ) } } );
+
+		start = end;
+	}
+}
+
+bool partition_scene( const std::string& filename, float cell_size, const std::filesystem::path& directory, CellIndex& index )
+{
+	std::ifstream datafile( filename );
+
+	if( !datafile.is_open() )
+		return false;
+
+	if( !( cell_size > 0.0f ) )
+		throw std::runtime_error( "Streaming error: cell size must be positive" );
+
+	std::unordered_map<uint64_t, nlohmann::json> cells;		// cell key -> the entities in it
+
+	{
+		nlohmann::json data;
+		datafile >> data;
+
+		auto& entities = data["entities"];
+
+		PrefabLibrary prefabs( data.value( "prefabs", nlohmann::json::object() ) );
+
+		for( size_t i = 0; i < entities.size(); ++i ) {
+
+			std::vector<ComponentPayload> payloads;
+			std::unordered_map<std::string, uint64_t> hashes;
+			std::deque<nlohmann::json> merged;
+
+			prefabs.resolve( entities[i], i, payloads, hashes, merged );
+
+			nlohmann::json components = nlohmann::json::object();
+			for( auto& payload : payloads )
+				components[payload.json_data->name] = *payload.json;
+
+			std::string id = scene_entity_id( entities[i], i );
+
+			auto track = components.find( "Track" );
+			if( track != components.end() && track->contains( "points" ) && (*track)["points"].size() >= 2 ) {
+				split_track( id, components, cell_size, cells );
+				continue;
+			}
+
+			uint64_t key = cell_of( entity_position( components ), cell_size );
+			cells[key].push_back( { { "id", id }, { "components", std::move( components ) } } );
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::remove_all( directory, error );
+	std::filesystem::create_directories( directory, error );
+
+	index = CellIndex { cell_size, directory };
+
+	for( auto& [key, entities] : cells ) {
+
+		std::ofstream out( directory / cell_filename( key ) );
+		if( !out.is_open() )
+			throw std::runtime_error( "Streaming error: can not write " + ( directory / cell_filename( key ) ).string() );
+
+		out << nlohmann::json { { "entities", entities } };
+
+		index.cells[key] = entities.size();
+	}
+
+	return true;
+}
@@ -0,0 +1,57 @@
+/*
+ * scene_partition.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+#include <glm/glm.hpp>
+
+/*
+ * A scene cut into square cells of the world plane so that it can be streamed. Every cell is written
+ * to a file of its own in the directory; only this index stays in memory.
+ */
+struct CellIndex
+{
+	float cell_size = 100.0f;
+	std::filesystem::path directory;
+	std::unordered_map<uint64_t, size_t> cells {};		// cell key -> number of entities in its file
+};
+
+inline uint64_t cell_key( int32_t x, int32_t y ) { return ( uint64_t( uint32_t( x ) ) << 32 ) | uint32_t( y ); }
+inline int32_t cell_x( uint64_t key ) { return int32_t( uint32_t( key >> 32 ) ); }
+inline int32_t cell_y( uint64_t key ) { return int32_t( uint32_t( key ) ); }
+
+inline uint64_t cell_of( glm::vec2 position, float cell_size )
+{
+	return cell_key( int32_t( std::floor( position.x / cell_size ) ), int32_t( std::floor( position.y / cell_size ) ) );
+}
+
+std::filesystem::path cell_filename( uint64_t key );
+
+/*
+ * Resolves the prefabs of a scene file and distributes its entities over the cells: an entity goes to
+ * the cell of its TransformComponent translation and a track is cut into one piece per cell it passes
+ * through. Returns false when the file can not be opened.
+ */
+bool partition_scene( const std::string& filename, float cell_size, const std::filesystem::path& directory, CellIndex& index );
@@ -0,0 +1,321 @@
+/*
+ * stream_load_request.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "stream_load_request.h"
+
+#include "../core/engine.h"
+#include "../core/binary_stream.h"
+#include "../core/world.h"
+#include "../core/registry.h"
+#include "../core/scene.h"
+#include "../core/hash.h"
+
+#include <fstream>
+#include <stdexcept>
+
+#include "json_loaders.h"
+#include "../components/track_component.h"
+
+class SceneSaxHandler : public nlohmann::json_sax<nlohmann::json>
+{
+public:
+	SceneSaxHandler( Registry& registry, Scene& scene ) : registry( registry ), scene( scene ) {}
+
+	bool null() override { return value( nullptr ); }
+	bool boolean( bool val ) override { return value( val ); }
+	bool number_integer( number_integer_t val ) override { return number( val ); }
+	bool number_unsigned( number_unsigned_t val ) override { return number( val ); }
+	bool number_float( number_float_t val, const string_t& ) override { return number( val ); }
+	bool string( string_t& val ) override { return value( val ); }
+	bool binary( binary_t& ) override { return true; }
+
+	bool key( string_t& val ) override { current_key = val; return true; }
+
+	bool start_object( std::size_t ) override;
+	bool end_object() override;
+	bool start_array( std::size_t ) override;
+	bool end_array() override;
+
+	bool parse_error( std::size_t, const std::string&, const nlohmann::json::exception& ex ) override
+		{ throw std::runtime_error( std::string( "JSON error: " ) + ex.what() ); }
+
+private:
+	enum class Scope { Document, Scene, Prefabs, Entities, Entity, Components, Component, Points, Point, Skip };
+
+	Registry& registry;
+	Scene& scene;
+	std::vector<Scope> scopes { Scope::Document };
+	std::string current_key;
+
+	nlohmann::json prefab_json;
+	PrefabLibrary prefabs;
+
+	Entity entity = InvalidEntity;
+	size_t entity_index = 0;
+	nlohmann::json entity_json;			// id, prefab and the components of the entity being parsed
+
+	std::string component_name;
+	std::vector<nlohmann::json*> capture;
+
+	bool stream_points = false;
+	std::vector<glm::vec2> points;
+	std::vector<float> coordinates;
+	Hasher points_hash;
+
+	template<typename T> bool value( T&& val );
+	template<typename T> bool number( T val );
+
+	nlohmann::json* insert( nlohmann::json&& val );
+	void begin_entity();
+	void commit_entity();
+};
+
+template <typename T>
+bool SceneSaxHandler::value( T&& val )
+{
+	Scope scope = scopes.back();
+
+	if( scope == Scope::Component || scope == Scope::Prefabs )
+		insert( nlohmann::json( std::forward<T>(val) ) );
+
+	else if( scope == Scope::Entity && ( current_key == "id" || current_key == "prefab" ) )
+		entity_json[current_key] = std::forward<T>(val);
+
+	return true;
+}
+
+template <typename T>
+bool SceneSaxHandler::number( T val )
+{
+	if( scopes.back() == Scope::Point )
+		coordinates.push_back( static_cast<float>( val ) );
+	else
+		value( val );
+
+	return true;
+}
+
+nlohmann::json* SceneSaxHandler::insert( nlohmann::json&& val )
+{
+	nlohmann::json& parent = *capture.back();
+
+	if( parent.is_array() ) {
+		parent.push_back( std::move(val) );
+		return &parent.back();
+	}
+
+	return &( parent[current_key] = std::move(val) );
+}
+
+void SceneSaxHandler::begin_entity()
+{
+	entity = registry.create_entity();
+	entity_json = { { "components", nlohmann::json::object() } };
+
+	stream_points = false;
+	points.clear();
+	points_hash = Hasher();
+}
+
+void SceneSaxHandler::commit_entity()
+{
+	std::string id = scene_entity_id( entity_json, entity_index++ );
+
+	auto [slot, inserted] = scene.entities.try_emplace( id );
+	if( !inserted )
+		throw std::runtime_error( "JSON error: duplicate entity id '" + id + "'" );
+
+	auto& scene_entity = slot->second;
+	scene_entity.entity = entity;
+
+	std::vector<ComponentPayload> payloads;
+	std::deque<nlohmann::json> merged;
+
+	prefabs.resolve( entity_json, 0, payloads, scene_entity.components, merged );
+
+	if( stream_points )		// the fingerprint has to cover the points the json never saw
+		for( auto& payload : payloads )
+			if( payload.json_data->name == "Track" )
+				scene_entity.components["Track"] = component_hash( *payload.json, points_hash.value() );
+
+	decode_components( payloads, 1 );
+	store_components( registry, { entity }, payloads );
+
+	if( stream_points )
+		registry.with_component( entity, "TrackComponent", [&](void *ptr)
+		{
+			if( ptr )
+				static_cast<TrackComponent*>( ptr )->centreline = std::move( points );
+		} );
+
+	entity = InvalidEntity;
+	entity_json = nlohmann::json();
+}
+
+bool SceneSaxHandler::start_object( std::size_t )
+{
+	Scope next = Scope::Skip;
+
+	switch( scopes.back() ) {
+	case Scope::Document:
+		next = Scope::Scene;
+		break;
+
+	case Scope::Scene:
+		if( current_key == "prefabs" ) {
+			prefab_json = nlohmann::json::object();
+			capture.assign( 1, &prefab_json );
+			next = Scope::Prefabs;
+		}
+		break;
+
+	case Scope::Entities:
+		begin_entity();
+		next = Scope::Entity;
+		break;
+
+	case Scope::Entity:
+		if( current_key == "components" )
+			next = Scope::Components;
+		break;
+
+	case Scope::Components:
+		if( json_loaders.find( current_key ) != json_loaders.end() ) {
+			component_name = current_key;
+			capture.assign( 1, &( entity_json["components"][component_name] = nlohmann::json::object() ) );
+			next = Scope::Component;
+		}
+		break;
+
+	case Scope::Component:
+	case Scope::Prefabs:
+		capture.push_back( insert( nlohmann::json::object() ) );
+		next = scopes.back();
+		break;
+
+	default:
+		break;
+	}
+
+	scopes.push_back( next );
+	return true;
+}
+
+bool SceneSaxHandler::end_object()
+{
+	Scope scope = scopes.back();
+	scopes.pop_back();
+
+	if( scope == Scope::Component || scope == Scope::Prefabs )
+		capture.pop_back();
+
+	if( scope == Scope::Prefabs && capture.empty() ) {
+		prefabs = PrefabLibrary( prefab_json );
+		prefab_json = nlohmann::json();
+	}
+
+	if( scope == Scope::Entity )
+		commit_entity();
+
+	return true;
+}
+
+bool SceneSaxHandler::start_array( std::size_t )
+{
+	Scope next = Scope::Skip;
+
+	switch( scopes.back() ) {
+	case Scope::Scene:
+		if( current_key == "entities" )
+			next = Scope::Entities;
+		break;
+
+	case Scope::Component:
+		if( component_name == "Track" && capture.size() == 1 && current_key == "points" ) {
+			insert( nlohmann::json::array() );		// keeps the loader's 'points' check happy, the points go to the side
+			stream_points = true;
+			next = Scope::Points;
+		} else {
+			capture.push_back( insert( nlohmann::json::array() ) );
+			next = Scope::Component;
+		}
+		break;
+
+	case Scope::Prefabs:
+		capture.push_back( insert( nlohmann::json::array() ) );
+		next = Scope::Prefabs;
+		break;
+
+	case Scope::Points:
+		coordinates.clear();
+		next = Scope::Point;
+		break;
+
+	default:
+		break;
+	}
+
+	scopes.push_back( next );
+	return true;
+}
+
+bool SceneSaxHandler::end_array()
+{
+	Scope scope = scopes.back();
+	scopes.pop_back();
+
+	if( scope == Scope::Component || scope == Scope::Prefabs )
+		capture.pop_back();
+
+	if( scope == Scope::Point ) {
+		if( coordinates.size() < 2 )
+			throw std::runtime_error( "JSON error: track point needs at least two coordinates" );
+
+		points.emplace_back( coordinates[0], coordinates[1] );
+		points_hash.add( coordinates[0] ).add( coordinates[1] );
+	}
+
+	return true;
+}
+
+void StreamLoadRequest::execute( Engine &engine )
+{
+	auto& registry = engine.get_registry();
+
+	std::ifstream datafile( filename );
+
+	if( !datafile.is_open() )
+		return;
+
+	registry.clear();
+
+	auto& scene = engine.get_scene();
+	scene = Scene { filename };
+
+	SceneSaxHandler handler( registry, scene );
+	nlohmann::json::sax_parse( datafile, &handler );
+}
+
+StreamLoadRequest::StreamLoadRequest( BinaryReader& in ) : filename( in.get_string() )
+{}
+
+void StreamLoadRequest::write( BinaryWriter& out ) const
+{
+	out.put( filename );
+}
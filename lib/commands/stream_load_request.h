@@ -0,0 +1,45 @@
+/*
+ * stream_load_request.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "../core/command.h"
+
+class BinaryReader;
+
+/*
+ * Loads a scene like LoadRequest but feeds the file through the SAX interface of nlohmann::json.
+ * Each entity is created as it opens and gets its components when it closes; track points are read
+ * straight into TrackComponent::centreline. Only the entity being parsed (and the prefabs, which
+ * have to come before the entities in the file) is ever held as a json value.
+ */
+class StreamLoadRequest : public ICommand
+{
+public:
+	StreamLoadRequest( std::string filename ) : filename( filename ) {}
+	StreamLoadRequest( BinaryReader& in );
+
+	void execute( Engine& engine ) override;
+	void write( BinaryWriter& out ) const override;
+
+private:
+	std::string filename;
+};
@@ -0,0 +1,34 @@
+/*
+ * ai_driver_component.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include "../vendor/nlohmann/json.hpp"
+
+#include "../core/registry.h"
+
+// sets the inputs of the entity's VehicleComponent each tick to follow the racing line
+struct AIDriverComponent
+{
+    float look_ahead = 0.6f;        // seconds of travel to the point steered at
+    float min_look_ahead = 6.0f;    // m
+    float pace = 0.9f;              // of the grip used in the corners
+};
@@ -0,0 +1,32 @@
+/*
+ * collider_component.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include "../vendor/nlohmann/json.hpp"
+
+#include "../core/registry.h"
+
+// a box around the entity's TransformComponent, turned with its rotation about z, for CollisionSystem
+struct ColliderComponent
+{
+    glm::vec2 half_extents {2.2f, 0.9f};    // m, along and across the heading
+};
@@ -19,12 +19,16 @@
 
 #pragma once
 
+#include "ai_driver_component.h"
+#include "collider_component.h"
 #include "geometry_component.h"
+#include "ghost_component.h"
 #include "lake_component.h"
 #include "mesh_component.h"
 #include "point_component.h"
 #include "track_component.h"
 #include "transform_component.h"
 #include "triangle_component.h"
+#include "vehicle_component.h"
 #include "velocity_component.h"
 #include "target_component.h"
@@ -26,6 +26,8 @@
 
 #include "../core/registry.h"
 
+#include "mesh_component.h"
+
 struct GeometryComponent
 {
     float axis_a;
@@ -35,6 +37,11 @@ struct GeometryComponent
     bool filled;
     glm::vec3 colour;
 
+    std::vector<MeshHandle> lods;   // the mesh at each level of detail, finest first (see geometry/lod.h)
+    int lod = 0;
+
     bool dirty = false;
+
+    bool operator==( const GeometryComponent& ) const = default;
 };
 
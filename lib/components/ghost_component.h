@@ -0,0 +1,33 @@
+/*
+ * ghost_component.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include "../geometry/ghost_stream.h"
+
+// plays a recorded lap on the entity's TransformComponent, see GhostSystem
+struct GhostComponent
+{
+    GhostPlayer player;
+    double time = 0.0;      // s into the lap
+    bool loop = true;       // back to the start at the end of the lap, or stop on the last sample
+
+    bool operator==( const GhostComponent& ) const = default;
+};
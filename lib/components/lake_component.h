@@ -19,16 +19,35 @@
 
 #pragma once
 
+#include <array>
+#include <memory>
+#include <vector>
+
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp>
 #include "../vendor/nlohmann/json.hpp"
 
 #include "../core/registry.h"
+#include "../geometry/kernels.h"
+
+#include "mesh_component.h"
+
+class DistanceField;
+
+struct LakeOutline
+{
+    std::vector<glm::vec2> lake;
+    std::vector<glm::vec2> island;
+};
 
 struct LakeComponent
 {
-    std::vector<glm::vec2> lake_outline;
-    std::vector<glm::vec2> island_outline;
+    std::shared_ptr<const LakeOutline> outline;     // shared between lakes made from identical parameters
+    MeshHandle surface;                             // the water around the island and the island, triangulated
+    std::vector<MeshHandle> surfaces;               // the surface at each level of detail, finest first (see geometry/lod.h)
+    int lod = 0;
+
+    std::shared_ptr<const DistanceField> field;     // negative on the water, when LakeSystem is asked for one
 
     std::array<float,2> lake_axis_length = { 1.0f, 1.0f };
     float lake_freq = 4.0f;        // jaggedness frequency
@@ -40,38 +59,43 @@ struct LakeComponent
 
     int segments = 200;
 
-    float smooth_noise( float t, float frequency, float amplitude )
-    {
-        float v1 = sin(t * frequency * 1.3f);
-        float v2 = sin(t * frequency * 0.7f + 2.0f);
-        float v3 = sin(t * frequency * 2.1f + 1.3f);
-        return (v1 + v2 + v3) * 0.33f * amplitude;
-    }
+    bool dirty = false;
+
+    LakeOutline generate_lake() const { return generate_lake( segments ); }
 
-    void generate_lake()
+    LakeOutline generate_lake( int outline_segments ) const
     {
-        lake_outline.clear();
-        island_outline.clear();
+        LakeOutline outline;
 
-        float a = glm::max(lake_axis_length[0], lake_axis_length[1]);
-        float b = glm::min(lake_axis_length[0], lake_axis_length[1]);
-        float c = sqrt(glm::max(0.0f, a*a - b*b)) / 2.0f;
+        size_t count = outline_segments > 0 ? size_t( outline_segments ) : 0;
+
+        std::vector<float> t( count ), sines( count ), cosines( count ), lake_jag( count ), island_jag( count );
+
+        for( size_t i = 0; i < count; i++ )
+            t[i] = (float)i / outline_segments * glm::two_pi<float>();
 
-        for (int i = 0; i < segments; i++) {
+        kernels::sincos( t.data(), sines.data(), cosines.data(), count );
+        kernels::lake_noise( t.data(), lake_freq, lake_amp, lake_jag.data(), count );
+        kernels::lake_noise( t.data(), island_freq, island_amp, island_jag.data(), count );
 
-            float t = (float)i / segments * glm::two_pi<float>();
+        outline.lake.reserve( count );
+        outline.island.reserve( count );
 
-            float lake_r = 1.0f + smooth_noise( t, lake_freq, lake_amp );
-            glm::vec2 lake_point( a * cos(t) * lake_r, b * sin(t) * lake_r );
+        float a = glm::max(lake_axis_length[0], lake_axis_length[1]);
+        float b = glm::min(lake_axis_length[0], lake_axis_length[1]);
+        float c = sqrt(glm::max(0.0f, a*a - b*b)) / 2.0f;
 
-            lake_outline.push_back( lake_point );
+        for( size_t i = 0; i < count; i++ ) {
 
-            float island_r = island_radius * (1.0f + smooth_noise( t, island_freq, island_amp ));
-            glm::vec2 island_point( glm::vec2( c, 0.0f ) + glm::vec2( cos(t), sin(t) ) * island_r );
+            float lake_r = 1.0f + lake_jag[i];
+            outline.lake.push_back( glm::vec2( a * cosines[i] * lake_r, b * sines[i] * lake_r ) );
 
-            island_outline.push_back( island_point );
+            float island_r = island_radius * (1.0f + island_jag[i]);
+            outline.island.push_back( glm::vec2( c, 0.0f ) + glm::vec2( cosines[i], sines[i] ) * island_r );
         }
+
+        return outline;
     }
 
+    bool operator==( const LakeComponent& ) const = default;
 };
-
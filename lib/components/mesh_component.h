@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include <glm/glm.hpp>
@@ -26,16 +27,38 @@
 
 #include "../core/registry.h"
 
-struct MeshComponent
+struct MeshPatch
 {
-    enum class Topology { POINTS, LINES, LINE_STRIP, LINE_LOOP, TRIANGLES, TRIANGLE_STRIP, TRIANGLE_FAN };
+    size_t vertex_first, vertex_count;
+    size_t index_first, index_count;
+};
 
-    Topology topology;
+struct MeshData
+{
     std::vector<glm::vec3> vertices;
     std::vector<uint32_t> indices;
     std::vector<glm::vec3> colours;
 
+    // a mesh edited in place counts its edits, patches is what the last one rewrote
+    uint64_t version = 0;
+    std::vector<MeshPatch> patches;
+};
+
+// meshes are immutable once made, entities generated from identical parameters share one. The
+// exception is a track being edited, which gets a mesh of its own (see geometry/track_mesh.h).
+using MeshHandle = std::shared_ptr<const MeshData>;
+
+struct MeshComponent
+{
+    enum class Topology { POINTS, LINES, LINE_STRIP, LINE_LOOP, TRIANGLES, TRIANGLE_STRIP, TRIANGLE_FAN };
+
+    Topology topology;
+    MeshHandle data;
+
+    glm::vec3 scale {1.0f};     // the size of this entity's copy of a shared mesh, before its transform
+
     bool filled = true;
 
+    bool operator==( const MeshComponent& ) const = default;
 };
 
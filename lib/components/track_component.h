@@ -19,6 +19,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 #include <glm/glm.hpp>
@@ -26,14 +29,38 @@
 
 #include "../core/registry.h"
 
+class TrackIndex;
+class DistanceField;
+
 struct TrackComponent
 {
     std::vector<glm::vec2> centreline;
     float width = 1.0f;
     bool closed = false;
     glm::vec3 colour = {1.0, 1.0, 1.0};
+    std::vector<float> sectors;         // where the sectors end as fractions of a lap, the finish line is at the first point
 
     bool dirty = false;
+
+    std::shared_ptr<const TrackIndex> index;      // for on-track queries, made by TrackSystem
+    std::shared_ptr<const DistanceField> field;   // negative on the track surface, when TrackSystem is asked for one
+
+    // moving control points only re-tessellates the part of the track around them, adding or
+    // removing points has to set dirty
+    void move_point( size_t index, glm::vec2 position )
+    {
+        centreline[index] = position;
+        edit_first = std::min( edit_first, index );
+        edit_last = std::max( edit_last, index );
+    }
+
+    bool edited() const { return edit_first <= edit_last; }
+    void clear_edits() { edit_first = SIZE_MAX; edit_last = 0; }
+
+    size_t edit_first = SIZE_MAX;      // range of control points moved since the mesh was last made
+    size_t edit_last = 0;
+
+    bool operator==( const TrackComponent& ) const = default;    // shared data is the same when it is the same object
 };
 
 
@@ -0,0 +1,49 @@
+/*
+ * vehicle_component.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "../vendor/nlohmann/json.hpp"
+
+#include "../core/registry.h"
+
+// a car driven by VehicleSystem, which places it through the entity's TransformComponent
+struct VehicleComponent
+{
+    float mass = 800.0f;            // kg
+    float engine_force = 6000.0f;   // N at full throttle
+    float brake_force = 12000.0f;   // N at full brake
+    float max_steer = 0.5f;         // radians at the front wheels
+    float wheelbase = 2.5f;         // m
+    float grip = 1.2f;              // tyre friction coefficient on the track surface
+    float drag = 0.4f;              // N per (m/s)^2
+
+    // driver inputs
+    float throttle = 0.0f;          // 0 to 1
+    float brake = 0.0f;             // 0 to 1
+    float steer = 0.0f;             // -1 to 1, positive to the left
+
+    // as of the last tick
+    glm::vec2 velocity {0.0f};
+    float yaw_rate = 0.0f;
+    bool on_track = true;
+    uint64_t tick = 0;              // of VehicleSystem's clock, taken back with the car on a restore
+};
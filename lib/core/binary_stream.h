@@ -0,0 +1,147 @@
+/*
+ * binary_stream.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// values appended as their bytes in the machine's order, strings with their length in front
+class BinaryWriter
+{
+public:
+	template<typename T>
+	void put( const T& value )
+	{
+		static_assert( std::is_trivially_copyable_v<T> );
+
+		auto first = reinterpret_cast<const uint8_t*>( &value );
+		bytes.insert( bytes.end(), first, first + sizeof( T ) );
+	}
+
+	void put( const std::string& text )
+	{
+		put( uint32_t( text.size() ) );
+		bytes.insert( bytes.end(), text.begin(), text.end() );
+	}
+
+	void put( const void * data, size_t size )
+	{
+		auto first = static_cast<const uint8_t*>( data );
+		bytes.insert( bytes.end(), first, first + size );
+	}
+
+	// seven bits to a byte, low bits first, so small values take a byte or two
+	void put_varint( uint64_t value )
+	{
+		while( value >= 0x80 ) {
+			bytes.push_back( uint8_t( value | 0x80 ) );
+			value >>= 7;
+		}
+		bytes.push_back( uint8_t( value ) );
+	}
+
+	const std::vector<uint8_t>& data() const { return bytes; }
+	size_t size() const { return bytes.size(); }
+	void clear() { bytes.clear(); }
+
+private:
+	std::vector<uint8_t> bytes;
+};
+
+// reads back what a BinaryWriter wrote, throws when the data runs out part way through a value
+class BinaryReader
+{
+public:
+	BinaryReader( const uint8_t * data, size_t size ) : data( data ), size( size ) {}
+	BinaryReader( const std::vector<uint8_t>& bytes ) : data( bytes.data() ), size( bytes.size() ) {}
+
+	template<typename T>
+	T get()
+	{
+		static_assert( std::is_trivially_copyable_v<T> );
+
+		need( sizeof( T ) );
+
+		T value;
+		std::memcpy( &value, data + at, sizeof( T ) );
+		at += sizeof( T );
+
+		return value;
+	}
+
+	std::string get_string()
+	{
+		uint32_t length = get<uint32_t>();
+		need( length );
+
+		std::string text( reinterpret_cast<const char*>( data + at ), length );
+		at += length;
+
+		return text;
+	}
+
+	uint64_t get_varint()
+	{
+		uint64_t value = 0;
+
+		for( int shift = 0; shift < 64; shift += 7 ) {
+			need( 1 );
+			uint8_t byte = data[at++];
+			value |= uint64_t( byte & 0x7f ) << shift;
+			if( !( byte & 0x80 ) )
+				return value;
+		}
+
+		throw std::runtime_error( "binary stream: varint too long" );
+	}
+
+	void get( void * out, size_t count )
+	{
+		need( count );
+		std::memcpy( out, data + at, count );
+		at += count;
+	}
+
+	bool at_end() const { return at == size; }
+	size_t position() const { return at; }
+
+	uint8_t peek() const
+	{
+		need( 1 );
+		return data[at];
+	}
+
+private:
+	const uint8_t * data;
+	size_t size;
+	size_t at = 0;
+
+	void need( size_t count ) const
+	{
+		if( size - at < count )
+			throw std::runtime_error( "binary stream: unexpected end of data" );
+	}
+};
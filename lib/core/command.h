@@ -20,6 +20,7 @@
 #pragma once
 
 class Engine;
+class BinaryWriter;
 
 class ICommand
 {
@@ -27,4 +28,7 @@ public:
 	virtual ~ICommand() = default;
 
 	virtual void execute( Engine& engine ) = 0;
+
+	// for the session log, read back by a constructor taking a BinaryReader (see commands.def)
+	virtual void write( BinaryWriter& out ) const = 0;
 };
@@ -41,6 +41,8 @@ public:
 		return cmd;
 	}
 
+	void clear() { commands = {}; }
+
 private:
 	std::queue<std::unique_ptr<ICommand>> commands;
 };
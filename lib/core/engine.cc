@@ -20,12 +20,23 @@
 #include "world.h"
 #include "engine.h"
 #include "platform.h"
+#include "session_log.h"
+#include "telemetry.h"
+#include "replication.h"
 
 #include "../systems/render_system.h"
 #include "../systems/resource_system.h"
 #include "../systems/physics_system.h"
+#include "../systems/streaming_system.h"
 #include "../systems/geometry_system.h"
 #include "../systems/track_system.h"
+#include "../systems/lake_system.h"
+#include "../systems/ai_driver_system.h"
+#include "../systems/vehicle_system.h"
+#include "../systems/collision_system.h"
+#include "../systems/timing_system.h"
+#include "../systems/ghost_system.h"
+#include "../systems/hot_reload_system.h"
 
 #include "../components/components.h"
 
@@ -33,9 +44,12 @@
 #define XSTR(x) STR(x)
 #define CAT(a,b) a##b
 
-Engine::Engine( IPlatform& platform ) : platform(platform)
+Engine::Engine( IPlatform& platform, bool headless ) : platform(platform)
 {
 #define X(Name) systems.push_back( std::make_unique<CAT(Name,System)>( this ) );
+	if( !headless ) {
+		#include "../systems/interactive_systems.def"
+	}
 	#include "../systems/systems.def"
 #undef X
 
@@ -73,14 +87,7 @@ void Engine::run()
 
 		running = !platform.should_close();
 
-		while( auto event = input_queue.pop() )
-			event->process( *this );
-
-		while( auto command = command_queue.pop() )
-			command->execute( *this );
-
-        for( auto& system : systems )
-            system->update( elapsed );
+		step( elapsed );
 
 		platform.begin_render();
 
@@ -88,15 +95,130 @@ void Engine::run()
             system->draw();
 
 		platform.present_frame();
-
-		registry.flush();
     }
 }
 
+bool Engine::record_session( const std::string& filename )
+{
+	recorder = std::make_unique<SessionRecorder>();
+
+	if( !recorder->open( filename ) )
+		recorder.reset();
+
+	return recorder != nullptr;
+}
+
+bool Engine::replay_session( const std::string& filename )
+{
+	player = std::make_unique<SessionReplay>();
+
+	if( !player->open( filename ) )
+		player.reset();
+
+	return player != nullptr;
+}
+
+bool Engine::record_telemetry( const std::string& filename, bool delta )
+{
+	telemetry = std::make_unique<Telemetry>();
+
+	if( !telemetry->open( filename, delta ) )
+		telemetry.reset();
+
+	return telemetry != nullptr;
+}
+
+bool Engine::serve( uint16_t port )
+{
+	server = std::make_unique<ReplicationServer>();
+
+	if( !server->open( port ) )
+		server.reset();
+
+	return server != nullptr;
+}
+
+bool Engine::spectate( const std::string& host, uint16_t port )
+{
+	client = std::make_unique<ReplicationClient>();
+
+	if( !client->connect( host, port ) )
+		client.reset();
+
+	return client != nullptr;
+}
+
+void Engine::step( double elapsed )
+{
+	// when replaying, what the platform and the systems queued is dropped for what the session
+	// recorded, the commands the replayed events push included
+	if( player ) {
+
+		input_queue.clear();
+
+		if( !player->read_events( elapsed, input_queue ) ) {
+			running = false;
+			return;
+		}
+	}
+
+	if( recorder )
+		recorder->begin_frame( elapsed );
+
+	while( auto event = input_queue.pop() ) {
+		if( recorder )
+			recorder->record( *event );
+		event->process( *this );
+	}
+
+	CommandQueue recorded;
+
+	if( player ) {
+		command_queue.clear();
+		player->read_commands( recorded );
+	}
+
+	CommandQueue& commands = player ? recorded : command_queue;
+
+	while( auto command = commands.pop() ) {
+		if( recorder )
+			recorder->record( *command );
+		command->execute( *this );
+	}
+
+	if( player )
+		command_queue.clear();
+
+	if( recorder )
+		recorder->end_frame();
+
+	if( client )
+		client->update( registry, world );
+
+	for( auto& system : systems )
+		system->update( elapsed );
+
+	registry.flush();
+
+	if( server )
+		server->update( world );
+}
+
+void Engine::restore( const Registry::Snapshot& snapshot )
+{
+	registry.restore( snapshot );
+
+	for( auto& system : systems )
+		system->rewind();
+}
+
 void Engine::shutdown()
 {
-    for( auto& system : systems )
-        system->shutdown();
+	for( auto& system : systems )
+		system->shutdown();
+
+	if( telemetry )
+		telemetry->close();
 
 	platform.destroy_window();
 }
@@ -20,32 +20,72 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "commandqueue.h"
 #include "inputqueue.h"
 #include "registry.h"
+#include "scene.h"
+#include "system.h"
 #include "world.h"
 
-class ISystem;
 class IEvent;
 class IPlatform;
+class ReplicationClient;
+class ReplicationServer;
+class SessionRecorder;
+class SessionReplay;
+class Telemetry;
 
 
 class Engine
 {
 public:
-    Engine( IPlatform& platform );
+    // a headless engine leaves out the systems of interactive_systems.def, it has no window to draw
+    // in and is advanced with step() rather than run()
+    Engine( IPlatform& platform, bool headless = false );
 	~Engine();
 
     void init();
     void run();
     void shutdown();
 
+    // one frame without input or drawing: queued events and commands, the updates and the flush
+    void step( double elapsed );
+
     void stop_running() { running = false; }
+    bool is_running() const { return running; }
+
+    // writes every frame's timestep, events and commands to the file from the next step on
+    bool record_session( const std::string& filename );
+
+    // takes the timesteps, events and commands from a recorded session instead of the platform,
+    // and stops running when it is played out
+    bool replay_session( const std::string& filename );
+
+    // every car's state at the end of each frame, written out on a thread of its own (see telemetry.h)
+    bool record_telemetry( const std::string& filename, bool delta = true );
+    Telemetry* get_telemetry() { return telemetry.get(); }
+
+    // sends the components of replicated_components.def to the viewers that connect, after every step
+    bool serve( uint16_t port );
+    ReplicationServer* get_replication_server() { return server.get(); }
+
+    // keeps the world in step with an engine that serves, before the systems update (see replication.h)
+    bool spectate( const std::string& host, uint16_t port );
+    ReplicationClient* get_replication_client() { return client.get(); }
+
+    // the state of every component, for going back to. With the previous snapshot, the stores that
+    // did not change since are shared with it rather than copied
+    void snapshot( Registry::Snapshot& into, const Registry::Snapshot * previous = nullptr ) { registry.snapshot( into, previous ); }
+    void restore( const Registry::Snapshot& snapshot );
 
 	World& get_world() { return world; }
 	Registry& get_registry() { return registry; }
+	Scene& get_scene() { return scene; }
+
+	template<typename T> T* get_system();
 
 	void push_command( std::unique_ptr<ICommand> cmd ) { command_queue.push( std::move(cmd) ); }
 
@@ -54,7 +94,24 @@ private:
 	IPlatform & platform;
     World world;
 	Registry registry {world};
+	Scene scene;
     std::vector<std::unique_ptr<ISystem>> systems;
 	CommandQueue command_queue;
 	InputQueue input_queue;
+
+	std::unique_ptr<SessionRecorder> recorder;
+	std::unique_ptr<SessionReplay> player;
+	std::unique_ptr<Telemetry> telemetry;
+	std::unique_ptr<ReplicationServer> server;
+	std::unique_ptr<ReplicationClient> client;
 };
+
+template <typename T>
+T* Engine::get_system()
+{
+	for( auto& system : systems )
+		if( system->type() == typeid(T) )
+			return static_cast<T*>( system.get() );
+
+	return nullptr;
+}
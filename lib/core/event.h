@@ -20,6 +20,7 @@
 #pragma once
 
 class Engine;
+class BinaryWriter;
 
 class IEvent
 {
@@ -27,4 +28,7 @@ public:
 	virtual ~IEvent() = default;
 
 	virtual void process( Engine& engine ) = 0;
+
+	// for the session log, read back by a constructor taking a BinaryReader (see events.def)
+	virtual void write( BinaryWriter& out ) const = 0;
 };
@@ -0,0 +1,55 @@
+/*
+ * hash.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// FNV-1a, 64 bit. Used to fingerprint scene content and the parameters generated geometry is made from.
+class Hasher
+{
+public:
+	Hasher& add( const void * data, size_t size )
+	{
+		auto bytes = static_cast<const unsigned char*>( data );
+
+		for( size_t i = 0; i < size; ++i ) {
+			state ^= bytes[i];
+			state *= 1099511628211ull;
+		}
+		return *this;
+	}
+
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	Hasher& add( const T& value ) { return add( &value, sizeof(T) ); }
+
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	Hasher& add( const std::vector<T>& values ) { add( values.size() ); return add( values.data(), values.size() * sizeof(T) ); }
+
+	Hasher& add( const std::string& text ) { add( text.size() ); return add( text.data(), text.size() ); }
+
+	uint64_t value() const { return state; }
+
+private:
+	uint64_t state = 14695981039346656037ull;
+};
@@ -0,0 +1,79 @@
+/*
+ * headless_runner.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include "headless_runner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "engine.h"
+#include "parallel.h"
+
+#include "../platforms/headless_platform.h"
+#include "../systems/timing_system.h"
+#include "../components/vehicle_component.h"
+
+void HeadlessRunner::run( size_t worlds, double duration, double step, const Setup& setup, unsigned threads )
+{
+	results.assign( worlds, RaceResult() );
+
+	size_t steps = size_t( std::ceil( duration / step ) );
+	auto start = std::chrono::steady_clock::now();
+
+	parallel_for( worlds, [&]( size_t w )
+	{
+		// the worlds are what runs in parallel, their systems keep to the one thread
+		ThreadLimit in_line( 1 );
+
+		HeadlessPlatform platform;
+		Engine engine( platform, true );
+
+		engine.init();
+
+		setup( engine, w );
+
+		for( size_t i = 0; i < steps; ++i )
+			engine.step( step );
+
+		RaceResult& result = results[w];
+		result.world = w;
+
+		engine.get_world().for_each_entity<VehicleComponent>( [&result]( Entity ) { ++result.cars; } );
+
+		if( auto * timing = engine.get_system<TimingSystem>() ) {
+
+			double total = 0.0;
+
+			for( auto& lap : timing->get_laps() ) {
+				result.best_lap = result.laps == 0 ? lap.time : std::min( result.best_lap, lap.time );
+				total += lap.time;
+				++result.laps;
+			}
+
+			result.mean_lap = result.laps ? float( total / result.laps ) : 0.0f;
+		}
+
+		engine.shutdown();
+	}, threads );
+
+	wall_seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+	simulated_seconds = double( worlds ) * steps * step;
+}
@@ -0,0 +1,65 @@
+/*
+ * headless_runner.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class Engine;
+
+// how one world's race went, from its TimingSystem
+struct RaceResult
+{
+	size_t world = 0;
+	size_t cars = 0;
+	uint32_t laps = 0;			// completed by all cars together
+	float best_lap = 0.0f;		// 0 when no lap was completed
+	float mean_lap = 0.0f;
+};
+
+/*
+ * Races many independent worlds without drawing them, each in its own headless Engine. The worlds
+ * are handed out one at a time to a thread per core, and each is made, set up, stepped at a fixed
+ * step for the whole race and taken down on that thread, so only as many are alive at once as
+ * there are threads. The systems inside a world keep to its thread: a world runs with a thread_limit
+ * of one (see core/parallel.h), so every parallel_for and WorkerPool in it runs in line.
+ */
+class HeadlessRunner
+{
+public:
+	// loads a world's scene and sets whatever differs between the runs
+	using Setup = std::function<void( Engine&, size_t world )>;
+
+	void run( size_t worlds, double duration, double step, const Setup& setup, unsigned threads = 0 );
+
+	const std::vector<RaceResult>& get_results() const { return results; }
+
+	double simulated() const { return simulated_seconds; }
+	double wall() const { return wall_seconds; }
+	double throughput() const { return wall_seconds > 0.0 ? simulated_seconds / wall_seconds : 0.0; }
+
+private:
+	std::vector<RaceResult> results;
+	double simulated_seconds = 0.0;
+	double wall_seconds = 0.0;
+};
@@ -41,6 +41,8 @@ public:
 		return event;
 	}
 
+	void clear() { events = {}; }
+
 private:
 	std::queue<std::unique_ptr<IEvent>> events;
 };
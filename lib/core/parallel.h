@@ -0,0 +1,224 @@
+/*
+ * parallel.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// the most threads parallel_for and WorkerPool take on this thread, 0 for no limit. Work that is
+// spread over threads already runs with a limit of one, so whatever it spreads in turn runs in line
+inline thread_local unsigned thread_limit = 0;
+
+// sets thread_limit for the rest of a scope
+class ThreadLimit
+{
+public:
+	explicit ThreadLimit( unsigned threads ) : previous( thread_limit ) { thread_limit = threads; }
+	~ThreadLimit() { thread_limit = previous; }
+
+	ThreadLimit( const ThreadLimit& ) = delete;
+	ThreadLimit& operator=( const ThreadLimit& ) = delete;
+
+private:
+	unsigned previous;
+};
+
+inline unsigned limited_threads( unsigned requested )
+{
+	unsigned threads = requested ? requested : std::max( 1u, std::thread::hardware_concurrency() );
+	return thread_limit ? std::min( threads, thread_limit ) : threads;
+}
+
+/*
+ * Calls fn(i) for every i in [0, count), spread over the hardware threads (or max_threads when given),
+ * no more than thread_limit. Indices are handed out one at a time so uneven work balances itself. The
+ * first exception thrown by fn is rethrown on the calling thread once all workers have stopped.
+ */
+template<typename Fn>
+void parallel_for( std::size_t count, Fn&& fn, unsigned max_threads = 0 )
+{
+	std::size_t threads = std::min<std::size_t>( limited_threads( max_threads ), count );
+
+	if( threads <= 1 ) {
+		for( std::size_t i = 0; i < count; ++i )
+			fn( i );
+		return;
+	}
+
+	std::atomic<std::size_t> next = 0;
+	std::exception_ptr error;
+	std::mutex error_mutex;
+
+	auto worker = [&]()
+	{
+		ThreadLimit in_line( 1 );
+
+		try {
+			for( std::size_t i = next++; i < count; i = next++ )
+				fn( i );
+		}
+		catch( ... ) {
+			std::lock_guard<std::mutex> lock( error_mutex );
+			if( !error )
+				error = std::current_exception();
+			next = count;
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for( std::size_t t = 1; t < threads; ++t )
+		pool.emplace_back( worker );
+
+	worker();
+
+	for( auto& thread : pool )
+		thread.join();
+
+	if( error )
+		std::rethrow_exception( error );
+}
+
+/*
+ * parallel_for for work that comes round every tick: the threads are started once and wait between
+ * runs instead of being created and joined each time. The calling thread takes part, so a pool of
+ * one thread runs everything in line. The thread_limit of the thread making the pool holds for it.
+ * One run at a time.
+ */
+class WorkerPool
+{
+public:
+	explicit WorkerPool( unsigned threads = 0 )
+	{
+		unsigned total = limited_threads( threads );
+
+		for( unsigned t = 1; t < total; ++t )
+			workers.emplace_back( [this]() { work(); } );
+	}
+
+	~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock( mutex );
+			stopping = true;
+		}
+		wake.notify_all();
+
+		for( auto& worker : workers )
+			worker.join();
+	}
+
+	WorkerPool( const WorkerPool& ) = delete;
+	WorkerPool& operator=( const WorkerPool& ) = delete;
+
+	unsigned size() const { return unsigned( workers.size() ) + 1; }
+
+	template<typename Fn>
+	void run( std::size_t count, Fn&& fn )
+	{
+		if( workers.empty() || count <= 1 ) {
+			for( std::size_t i = 0; i < count; ++i )
+				fn( i );
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock( mutex );
+
+			context = const_cast<void*>( static_cast<const void*>( std::addressof( fn ) ) );
+			call = []( void * context, std::size_t i ) { ( *static_cast<std::remove_reference_t<Fn>*>( context ) )( i ); };
+			total = count;
+			next = 0;
+			error = nullptr;
+			active = workers.size();
+			++generation;
+		}
+		wake.notify_all();
+
+		drain();
+
+		std::unique_lock<std::mutex> lock( mutex );
+		finished.wait( lock, [this]() { return active == 0; } );
+
+		if( error )
+			std::rethrow_exception( std::exchange( error, nullptr ) );
+	}
+
+private:
+	std::vector<std::thread> workers;
+
+	std::mutex mutex;
+	std::condition_variable wake, finished;
+	std::uint64_t generation = 0;
+	std::size_t active = 0;
+	bool stopping = false;
+
+	void (*call)( void*, std::size_t ) = nullptr;
+	void * context = nullptr;
+	std::size_t total = 0;
+	std::atomic<std::size_t> next = 0;
+	std::exception_ptr error;
+
+	void drain()
+	{
+		ThreadLimit in_line( 1 );
+
+		try {
+			for( std::size_t i = next++; i < total; i = next++ )
+				call( context, i );
+		}
+		catch( ... ) {
+			std::lock_guard<std::mutex> lock( mutex );
+			if( !error )
+				error = std::current_exception();
+			next = total;
+		}
+	}
+
+	void work()
+	{
+		std::uint64_t seen = 0;
+
+		for( ;; ) {
+			{
+				std::unique_lock<std::mutex> lock( mutex );
+				wake.wait( lock, [&]() { return stopping || generation != seen; } );
+				if( stopping )
+					return;
+				seen = generation;
+			}
+
+			drain();
+
+			std::lock_guard<std::mutex> lock( mutex );
+			if( --active == 0 )
+				finished.notify_one();
+		}
+	}
+};
@@ -25,11 +25,28 @@ Entity Registry::create_entity()
 {
 	Entity e = world.create_entity();
 
+	typelist_image = nullptr;
 	entity_typelist.insert( {e, std::vector<std::type_index>()} );
 
 	return e;
 }
 
+std::vector<Entity> Registry::create_entities( size_t count )
+{
+	Entity first = world.create_entities( count );
+
+	std::vector<Entity> entities( count );
+	typelist_image = nullptr;
+	entity_typelist.reserve( entity_typelist.size() + count );
+
+	for( size_t i = 0; i < count; ++i ) {
+		entities[i] = first + i;
+		entity_typelist.insert( {entities[i], std::vector<std::type_index>()} );
+	}
+
+	return entities;
+}
+
 void Registry::remove_entity( Entity e )
 {
 	auto it = entity_typelist.find( e );
@@ -43,6 +60,7 @@ void Registry::remove_entity( Entity e )
 
 	world.remove_entity( e );
 
+	typelist_image = nullptr;
 	entity_typelist.erase( e );
 }
 
@@ -64,8 +82,10 @@ bool Registry::create_component( Entity e, const std::string &name )
 
 	auto& typelist = entity_typelist.at(e);
 
-	if( !std::count( typelist.begin(), typelist.end(), type ) )
+	if( !std::count( typelist.begin(), typelist.end(), type ) ) {
 		typelist.push_back( type );
+		typelist_image = nullptr;
+	}
 
     return true;
 }
@@ -115,6 +135,7 @@ bool Registry::remove_component( Entity e, const std::string& name )
 
 	auto it4 = std::find(typelist.begin(), typelist.end(), type );
     if (it4 != typelist.end()) {
+		typelist_image = nullptr;
 		*it4 = typelist.back();
 		typelist.pop_back();
 	}
@@ -132,10 +153,32 @@ bool Registry::flush()
 
 void Registry::clear()
 {
+	typelist_image = nullptr;
 	entity_typelist.clear();
 	world.clear();
 }
 
+void Registry::snapshot( Snapshot& into, const Snapshot * previous )
+{
+	world.snapshot( into.world, previous ? &previous->world : nullptr );
+
+	// entities rarely change, so snapshots mostly share one copy of their component lists
+	if( !typelist_image )
+		typelist_image = std::make_shared<const TypeListMap>( entity_typelist );
+
+	into.types = typelist_image;
+}
+
+void Registry::restore( const Snapshot& snapshot )
+{
+	world.restore( snapshot.world );
+
+	if( snapshot.types != typelist_image ) {
+		entity_typelist = snapshot.types ? *snapshot.types : TypeListMap();
+		typelist_image = snapshot.types;
+	}
+}
+
 bool Registry::remove_component( Entity e, std::type_index type )
 {
 	auto component_funcs_it = func_map.find( type );
@@ -151,6 +194,7 @@ bool Registry::remove_component( Entity e, std::type_index type )
 
 	auto it4 = std::find(typelist.begin(), typelist.end(), type );	// deregisters this component from this entity
     if (it4 != typelist.end()) {
+		typelist_image = nullptr;
 		*it4 = typelist.back();
 		typelist.pop_back();
 	}
@@ -24,6 +24,7 @@
 #include <functional>
 #include <typeindex>
 #include <cstdint>
+#include <memory>
 
 #include "world.h"
 
@@ -42,9 +43,17 @@ using TypeListMap = std::unordered_map<Entity, std::vector<std::type_index>>;
 class Registry
 {
 public:
+	// the world's stores and which components each entity has
+	struct Snapshot
+	{
+		World::Snapshot world;
+		std::shared_ptr<const TypeListMap> types;
+	};
+
 	Registry( World& world ) : world(world) {}
 
 	Entity create_entity();
+	std::vector<Entity> create_entities( size_t count );
 	void remove_entity( Entity e );
 
     template<typename T> void register_component( const std::string& name );
@@ -55,11 +64,17 @@ public:
     bool flush();
     void clear();
 
+	// well under a millisecond for the stores of a race. With the previous snapshot only the stores
+	// that changed since are copied. Pointers to components do not survive a restore
+	void snapshot( Snapshot& into, const Snapshot * previous = nullptr );
+	void restore( const Snapshot& snapshot );
+
 private:
 	World& world;
     TypeLookupMap type_lookup;
 	FunctionMap func_map;
     TypeListMap entity_typelist;
+	std::shared_ptr<const TypeListMap> typelist_image;		// a copy of entity_typelist until it changes
 
 	bool remove_component( Entity e, std::type_index type );
 };
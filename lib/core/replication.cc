@@ -0,0 +1,630 @@
+/*
+ * replication.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "replication.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+
+#include "registry.h"
+#include "../components/components.h"
+
+#define STR(x) #x
+#define XSTR(x) STR(x)
+#define CAT(a,b) a##b
+
+namespace
+{
+
+#define X(Name) sizeof( CAT(Name,Component) ),
+constexpr size_t component_sizes[] = {
+	#include "../components/replicated_components.def"
+};
+#undef X
+
+constexpr size_t component_count = std::size( component_sizes );
+static_assert( component_count <= 8, "the mask has a bit for each replicated component" );
+
+constexpr std::array<size_t, component_count + 1> offsets_of_components()
+{
+	std::array<size_t, component_count + 1> offsets {};
+	for( size_t i = 0; i < component_count; ++i )
+		offsets[i + 1] = offsets[i] + component_sizes[i];
+	return offsets;
+}
+
+constexpr auto component_offsets = offsets_of_components();
+constexpr size_t slot_size = component_offsets[component_count];
+
+constexpr size_t header_size = 1 + 4 + 4 + 2 + 2;
+constexpr size_t max_entry = 5 + 1 + component_count * 3 + slot_size;		// every word of every component changed
+
+const std::array<uint8_t, slot_size> zeros {};
+const ReplicaState empty;
+
+using Clock = std::chrono::steady_clock;
+
+double milliseconds_since( Clock::time_point start )
+{
+	return std::chrono::duration<double, std::milli>( Clock::now() - start ).count();
+}
+
+const uint8_t * slot_of( const ReplicaState& state, size_t i ) { return &state.slots[i * slot_size]; }
+
+template<typename T>
+void gather_component( const World& world, ReplicaState& state, const std::vector<uint32_t>& slots, size_t index )
+{
+	static_assert( std::is_trivially_copyable_v<T> && sizeof(T) % 4 == 0, "replicated components are sent as 32 bit words" );
+
+	world.for_each_entity<T>( [&]( Entity e ) {
+		uint32_t i = slots[e];
+		state.masks[i] |= 1 << index;
+		std::memcpy( &state.slots[i * slot_size + component_offsets[index]], world.get_component<T>( e ), sizeof(T) );
+	} );
+}
+
+// slots is scratch, by entity: first whether it has a replicated component, then where it went
+void gather( const World& world, ReplicaState& state, std::vector<uint32_t>& slots )
+{
+	std::fill( slots.begin(), slots.end(), 0 );
+
+	auto mark = [&slots]( Entity e ) {
+		if( e >= slots.size() )
+			slots.resize( e + 1, 0 );
+		slots[e] = 1;
+	};
+
+#define X(Name) world.for_each_entity<CAT(Name,Component)>( mark );
+	#include "../components/replicated_components.def"
+#undef X
+
+	state.entities.clear();
+
+	for( Entity e = 0; e < slots.size(); ++e )
+		if( slots[e] ) {
+			slots[e] = uint32_t( state.entities.size() );
+			state.entities.push_back( e );
+		}
+
+	state.masks.assign( state.entities.size(), 0 );
+	state.slots.assign( state.entities.size() * slot_size, 0 );
+
+	size_t index = 0;
+#define X(Name) gather_component<CAT(Name,Component)>( world, state, slots, index++ );
+	#include "../components/replicated_components.def"
+#undef X
+}
+
+// the components in the mask, each as the words that differ from the baseline's
+void put_entry( BinaryWriter& out, Entity gap, uint8_t mask, const uint8_t * slot, const uint8_t * baseline )
+{
+	out.put_varint( gap );
+	out.put( mask );
+
+	for( size_t c = 0; c < component_count; ++c ) {
+
+		if( !( mask & ( 1 << c ) ) )
+			continue;
+
+		const uint8_t * now = slot + component_offsets[c];
+		const uint8_t * before = baseline + component_offsets[c];
+		size_t words = component_sizes[c] / 4;
+
+		uint64_t changed = 0;
+		for( size_t w = 0; w < words; ++w )
+			if( std::memcmp( now + 4 * w, before + 4 * w, 4 ) )
+				changed |= uint64_t( 1 ) << w;
+
+		out.put_varint( changed );
+
+		for( size_t w = 0; w < words; ++w )
+			if( changed & ( uint64_t( 1 ) << w ) )
+				out.put( now + 4 * w, 4 );
+	}
+}
+
+template<typename T>
+void apply_component( Registry& registry, World& world, Entity e, bool present, const uint8_t * bytes, const char * name )
+{
+	T * component = world.get_component<T>( e );
+
+	if( !present ) {
+		if( component )
+			registry.remove_component( e, name );
+		return;
+	}
+
+	if( !component ) {
+		registry.create_component( e, name );
+		component = world.get_component<T>( e );
+	}
+
+	if( component )
+		std::memcpy( static_cast<void*>( component ), bytes, sizeof(T) );
+}
+
+void apply_slot( Registry& registry, World& world, Entity e, uint8_t mask, const uint8_t * slot )
+{
+	size_t index = 0;
+
+#define X(Name) apply_component<CAT(Name,Component)>( registry, world, e, mask & ( 1 << index ), slot + component_offsets[index], XSTR(CAT(Name,Component)) ); ++index;
+	#include "../components/replicated_components.def"
+#undef X
+}
+
+}
+
+bool ReplicationServer::open( uint16_t port, const std::string& host )
+{
+	return socket.bind( host, port );
+}
+
+void ReplicationServer::update( const World& world )
+{
+	receive();
+
+	auto start = Clock::now();
+
+	ReplicaState& state = states[++sequence % history];
+	state.sequence = sequence;
+	gather( world, state, slot_index );
+
+	encoded.clear();
+	double serialise_ms = milliseconds_since( start );		// the sending left out
+
+	for( auto& client : clients ) {
+
+		++client.unacked;
+
+		if( !client.paced.empty() ) {
+			send_paced( client );
+			continue;
+		}
+
+		uint32_t baseline = client.acked && sequence - client.acked < history ? client.acked : 0;
+		if( !baseline )
+			++stats.full_states;
+
+		auto encode_start = Clock::now();
+		auto& fragments = encode( state, baseline );
+		serialise_ms += milliseconds_since( encode_start );
+
+		size_t bytes = 0;
+		for( auto& fragment : fragments )
+			bytes += header_size + fragment.size();
+
+		// what the client's buffer would drop goes over the next updates instead
+		if( bytes > client.window ) {
+			client.paced_sequence = sequence;
+			client.paced_baseline = baseline;
+			client.paced = fragments;
+			client.next_fragment = 0;
+			send_paced( client );
+			continue;
+		}
+
+		for( size_t f = 0; f < fragments.size(); ++f )
+			send( client, sequence, baseline, fragments, f );
+	}
+
+	std::erase_if( clients, []( const Client& client ) { return client.unacked > timeout; } );
+
+	stats.states++;
+	stats.clients = clients.size();
+	stats.serialise_ms = serialise_ms;
+	stats.total_serialise_ms += serialise_ms;
+}
+
+void ReplicationServer::receive()
+{
+	UdpEndpoint from;
+	uint8_t ack[16];
+
+	while( size_t size = socket.receive( from, ack, sizeof(ack) ) ) {
+
+		++stats.packets_received;
+		stats.bytes_received += size;
+
+		if( ( size != 5 && size != 9 ) || ack[0] != 'A' )
+			continue;
+
+		uint32_t acked;
+		std::memcpy( &acked, ack + 1, sizeof(acked) );
+
+		uint32_t window = packet_size;
+		if( size == 9 )
+			std::memcpy( &window, ack + 5, sizeof(window) );
+
+		auto client = std::find_if( clients.begin(), clients.end(), [&]( const Client& client ) { return client.endpoint == from; } );
+
+		if( client == clients.end() ) {
+			if( acked == 0 ) {
+				clients.emplace_back();
+				clients.back().endpoint = from;
+				clients.back().window = window;
+			}
+			continue;
+		}
+
+		// joining again starts over, a late acknowledgement must not take the baseline back
+		if( acked == 0 ) {
+			client->acked = 0;
+			client->window = window;
+			client->paced.clear();
+		}
+		else if( acked > client->acked && acked <= sequence )
+			client->acked = acked;
+		client->unacked = 0;
+	}
+}
+
+size_t ReplicationServer::send( const Client& client, uint32_t sequence, uint32_t baseline, const std::vector<BinaryWriter>& fragments, size_t f )
+{
+	BinaryWriter header;
+	header.put( uint8_t( 'S' ) );
+	header.put( sequence );
+	header.put( baseline );
+	header.put( uint16_t( f ) );
+	header.put( uint16_t( fragments.size() ) );
+
+	datagram.assign( header.data().begin(), header.data().end() );
+	datagram.insert( datagram.end(), fragments[f].data().begin(), fragments[f].data().end() );
+
+	if( socket.send( client.endpoint, datagram.data(), datagram.size() ) ) {
+		++stats.packets_sent;
+		stats.bytes_sent += datagram.size();
+	}
+
+	return datagram.size();
+}
+
+// as many of the fragments still to go as the client's window takes
+void ReplicationServer::send_paced( Client& client )
+{
+	size_t bytes = 0;
+
+	while( client.next_fragment < client.paced.size() ) {
+
+		size_t size = header_size + client.paced[client.next_fragment].size();
+		if( bytes && bytes + size > client.window )
+			break;
+
+		bytes += send( client, client.paced_sequence, client.paced_baseline, client.paced, client.next_fragment++ );
+	}
+
+	if( client.next_fragment == client.paced.size() )
+		client.paced.clear();
+}
+
+// clients that acknowledged the same state share the encoding
+const std::vector<BinaryWriter>& ReplicationServer::encode( const ReplicaState& state, uint32_t baseline )
+{
+	auto found = encoded.find( baseline );
+	if( found != encoded.end() )
+		return found->second;
+
+	auto& fragments = encoded[baseline];
+	const ReplicaState& from = baseline ? states[baseline % history] : empty;
+
+	fragments.emplace_back();
+	Entity previous = 0;
+
+	auto entry = [&]( Entity e, uint8_t mask, const uint8_t * slot, const uint8_t * before ) {
+
+		if( fragments.back().size() + max_entry > packet_size - header_size ) {
+			fragments.emplace_back();
+			previous = 0;
+		}
+
+		put_entry( fragments.back(), e - previous, mask, slot, before );
+		previous = e;
+	};
+
+	size_t i = 0;
+	size_t j = 0;
+
+	while( i < state.entities.size() || j < from.entities.size() ) {
+
+		if( j == from.entities.size() || ( i < state.entities.size() && state.entities[i] < from.entities[j] ) ) {
+			entry( state.entities[i], state.masks[i], slot_of( state, i ), zeros.data() );
+			++i;
+		}
+		else if( i == state.entities.size() || from.entities[j] < state.entities[i] ) {
+			entry( from.entities[j], 0, nullptr, nullptr );
+			++j;
+		}
+		else {
+			if( state.masks[i] != from.masks[j] || std::memcmp( slot_of( state, i ), slot_of( from, j ), slot_size ) )
+				entry( state.entities[i], state.masks[i], slot_of( state, i ), slot_of( from, j ) );
+			++i;
+			++j;
+		}
+	}
+
+	return fragments;
+}
+
+bool ReplicationClient::connect( const std::string& host, uint16_t port, size_t buffer_size )
+{
+	socket.set_buffer_size( buffer_size );
+
+	if( !UdpSocket::resolve( host, port, server ) || !socket.bind( "0.0.0.0" ) )
+		return false;
+
+	datagram.resize( 65536 );
+	send_join();
+
+	return true;
+}
+
+bool ReplicationClient::update( Registry& registry, World& world )
+{
+	receive();
+
+	// a join is lost like anything else, so it is repeated until a state comes in
+	if( ++quiet >= rejoin_after ) {
+		rejoin();
+		quiet = 0;
+	}
+
+	// only the newest complete state is applied, it has what the ones before it changed as well
+	auto complete = std::find_if( pending.rbegin(), pending.rend(), []( const auto& entry ) {
+		return entry.second.received == entry.second.fragments.size();
+	} );
+
+	if( complete == pending.rend() )
+		return false;
+
+	auto start = Clock::now();
+
+	uint32_t sequence = complete->first;
+	bool decoded_ok = decode( sequence, complete->second );
+
+	pending.erase( pending.begin(), complete.base() );
+
+	if( !decoded_ok )
+		return false;
+
+	apply( registry, world );
+
+	std::swap( states[sequence % ReplicationServer::history], decoded );
+	newest = sequence;
+	previous = {};
+
+	send_ack( sequence );
+
+	stats.states++;
+	stats.serialise_ms = milliseconds_since( start );
+	stats.total_serialise_ms += stats.serialise_ms;
+
+	return true;
+}
+
+void ReplicationClient::receive()
+{
+	UdpEndpoint from;
+
+	while( size_t size = socket.receive( from, datagram.data(), datagram.size() ) ) {
+
+		++stats.packets_received;
+		stats.bytes_received += size;
+
+		if( !( from == server ) || size < header_size || datagram[0] != 'S' )
+			continue;
+
+		BinaryReader reader( datagram.data() + 1, header_size - 1 );
+		uint32_t sequence = reader.get<uint32_t>();
+		uint32_t baseline = reader.get<uint32_t>();
+		uint16_t fragment = reader.get<uint16_t>();
+		uint16_t count = reader.get<uint16_t>();
+
+		quiet = 0;
+
+		if( sequence <= newest || fragment >= count )
+			continue;
+
+		Pending& state = pending[sequence];
+
+		if( state.fragments.empty() ) {
+			state.baseline = baseline;
+			state.fragments.resize( count );
+			state.arrived.resize( count );
+		}
+
+		if( state.fragments.size() != count || state.arrived[fragment] )
+			continue;
+
+		state.fragments[fragment].assign( datagram.data() + header_size, datagram.data() + size );
+		state.arrived[fragment] = true;
+		++state.received;
+
+		// states that never complete are given up on
+		if( pending.size() > ReplicationServer::history )
+			pending.erase( pending.begin() );
+	}
+}
+
+// the baseline with the entries of the fragments worked in, into decoded
+bool ReplicationClient::decode( uint32_t sequence, const Pending& from )
+{
+	const ReplicaState * baseline = &empty;
+
+	if( from.baseline ) {
+		baseline = &states[from.baseline % ReplicationServer::history];
+		if( baseline->sequence != from.baseline )
+			return false;
+	}
+
+	decoded.sequence = sequence;
+	decoded.entities.clear();
+	decoded.masks.clear();
+	decoded.slots.clear();
+	decoded.slots.reserve( baseline->slots.size() );
+
+	size_t j = 0;
+
+	auto keep = [&]( size_t j ) {
+		decoded.entities.push_back( baseline->entities[j] );
+		decoded.masks.push_back( baseline->masks[j] );
+		decoded.slots.insert( decoded.slots.end(), slot_of( *baseline, j ), slot_of( *baseline, j ) + slot_size );
+	};
+
+	try {
+		bool first = true;
+		Entity last = 0;
+
+		for( auto& fragment : from.fragments ) {
+
+			BinaryReader reader( fragment );
+			Entity e = 0;
+
+			while( !reader.at_end() ) {
+
+				e += Entity( reader.get_varint() );
+				if( !first && e <= last )
+					return false;
+				first = false;
+				last = e;
+
+				while( j < baseline->entities.size() && baseline->entities[j] < e )
+					keep( j++ );
+
+				const uint8_t * before = zeros.data();
+				if( j < baseline->entities.size() && baseline->entities[j] == e )
+					before = slot_of( *baseline, j++ );
+
+				uint8_t mask = reader.get<uint8_t>();
+				if( !mask )
+					continue;
+				if( mask >> component_count )
+					return false;
+
+				decoded.entities.push_back( e );
+				decoded.masks.push_back( mask );
+				size_t at = decoded.slots.size();
+				decoded.slots.resize( at + slot_size );
+
+				for( size_t c = 0; c < component_count; ++c ) {
+
+					if( !( mask & ( 1 << c ) ) )
+						continue;
+
+					uint8_t * to = &decoded.slots[at + component_offsets[c]];
+					size_t words = component_sizes[c] / 4;
+
+					std::memcpy( to, before + component_offsets[c], component_sizes[c] );
+
+					uint64_t changed = reader.get_varint();
+					if( changed >> words )
+						return false;
+
+					for( size_t w = 0; w < words; ++w )
+						if( changed & ( uint64_t( 1 ) << w ) )
+							reader.get( to + 4 * w, 4 );
+				}
+			}
+		}
+	}
+	catch( const std::runtime_error& ) {
+		return false;
+	}
+
+	while( j < baseline->entities.size() )
+		keep( j++ );
+
+	return true;
+}
+
+// the differences between the state applied last and the decoded one go into the world
+void ReplicationClient::apply( Registry& registry, World& world )
+{
+	const ReplicaState& applied = newest ? states[newest % ReplicationServer::history] : previous;
+
+	size_t i = 0;
+	size_t j = 0;
+
+	while( i < decoded.entities.size() || j < applied.entities.size() ) {
+
+		if( j == applied.entities.size() || ( i < decoded.entities.size() && decoded.entities[i] < applied.entities[j] ) ) {
+			Entity e = registry.create_entity();
+			local[decoded.entities[i]] = e;
+			apply_slot( registry, world, e, decoded.masks[i], slot_of( decoded, i ) );
+			++i;
+		}
+		else if( i == decoded.entities.size() || applied.entities[j] < decoded.entities[i] ) {
+			auto found = local.find( applied.entities[j] );
+			if( found != local.end() ) {
+				registry.remove_entity( found->second );
+				local.erase( found );
+			}
+			++j;
+		}
+		else {
+			if( decoded.masks[i] != applied.masks[j] || std::memcmp( slot_of( decoded, i ), slot_of( applied, j ), slot_size ) )
+				apply_slot( registry, world, local[decoded.entities[i]], decoded.masks[i], slot_of( decoded, i ) );
+			++i;
+			++j;
+		}
+	}
+}
+
+void ReplicationClient::send_ack( uint32_t acked )
+{
+	uint8_t ack[5] = { 'A' };
+	std::memcpy( ack + 1, &acked, sizeof(acked) );
+
+	if( socket.send( server, ack, sizeof(ack) ) ) {
+		++stats.packets_sent;
+		stats.bytes_sent += sizeof(ack);
+	}
+}
+
+// a restarted server counts from 1 again and one that dropped the client sends it a whole state,
+// so what came in before is no baseline any more; the world is kept until the first new state
+void ReplicationClient::rejoin()
+{
+	if( newest )
+		previous = std::move( states[newest % ReplicationServer::history] );
+
+	for( auto& state : states )
+		state = {};
+
+	pending.clear();
+	newest = 0;
+
+	send_join();
+}
+
+// the buffer holds about half of what the system reports in datagrams of the packet size, and the
+// other half is left for a second update's worth arriving before this one takes the first in
+void ReplicationClient::send_join()
+{
+	uint32_t window = uint32_t( std::min<size_t>( socket.get_receive_buffer() / 4, UINT32_MAX ) );
+
+	uint8_t join[9] = { 'A' };
+	std::memcpy( join + 5, &window, sizeof(window) );
+
+	if( socket.send( server, join, sizeof(join) ) ) {
+		++stats.packets_sent;
+		stats.bytes_sent += sizeof(join);
+	}
+}
@@ -0,0 +1,162 @@
+/*
+ * replication.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "binary_stream.h"
+#include "world.h"
+#include "../platforms/udp_socket.h"
+
+class Registry;
+
+struct ReplicationStats
+{
+	uint64_t states = 0;			// sent by a server, applied by a client
+	uint64_t full_states = 0;		// sent without a baseline the client had
+	uint64_t packets_sent = 0;
+	uint64_t bytes_sent = 0;
+	uint64_t packets_received = 0;
+	uint64_t bytes_received = 0;
+	size_t clients = 0;
+
+	double serialise_ms = 0.0;		// of the last state: gathered and encoded, or decoded and applied
+	double total_serialise_ms = 0.0;
+};
+
+// the components of replicated_components.def of every entity with one of them, a fixed size slot
+// per entity with a bit in its mask for each component it has. Missing components are zeros
+struct ReplicaState
+{
+	uint32_t sequence = 0;
+	std::vector<Entity> entities;		// ascending
+	std::vector<uint8_t> masks;
+	std::vector<uint8_t> slots;
+};
+
+/*
+ * Sends the world to whoever asked for it, over UDP. Each update gathers the replicated components
+ * into a state and sends every client only what differs from the last state that client
+ * acknowledged: the entities that changed, and of those the 32 bit words of the components that
+ * changed. A client that acknowledged nothing, or nothing recent enough to still be kept, gets the
+ * whole state. A lost datagram costs nothing but a larger delta later, the server never resends.
+ * A client tells the server how much its receive buffer takes in when it joins; a state larger
+ * than that, a whole one usually, is sent a part at a time over the updates after it, and the
+ * client gets nothing newer until it is through.
+ *
+ * A state datagram is a kind byte 'S', the sequence, the sequence of the baseline (0 for none), the
+ * fragment's index and the number of fragments, then entries in ascending entity order: the gap
+ * from the entity before as a varint, the mask, and for each component in the mask a varint with
+ * a bit per changed word followed by those words. A mask of 0 removes the entity. A client
+ * acknowledges with 'A' and a sequence, and joins with 'A', 0 and the bytes it takes in an update.
+ */
+class ReplicationServer
+{
+public:
+	static constexpr uint32_t history = 32;			// states kept to delta against
+	static constexpr uint32_t timeout = 600;		// states sent without an acknowledgement before a client is dropped
+	static constexpr size_t packet_size = 8192;
+
+	bool open( uint16_t port, const std::string& host = "127.0.0.1" );
+	uint16_t get_port() const { return socket.get_port(); }
+
+	void update( const World& world );
+
+	const ReplicationStats& get_stats() const { return stats; }
+
+private:
+	struct Client
+	{
+		UdpEndpoint endpoint;
+		uint32_t acked = 0;
+		uint32_t unacked = 0;
+		size_t window = packet_size;		// bytes sent to it in an update, one datagram at least
+
+		// the fragments of a state too large for one update still to go
+		uint32_t paced_sequence = 0;
+		uint32_t paced_baseline = 0;
+		std::vector<BinaryWriter> paced;
+		size_t next_fragment = 0;
+	};
+
+	UdpSocket socket;
+	std::vector<Client> clients;
+	std::vector<ReplicaState> states = std::vector<ReplicaState>( history );		// by sequence modulo history
+	uint32_t sequence = 0;
+	ReplicationStats stats;
+
+	std::unordered_map<uint32_t, std::vector<BinaryWriter>> encoded;		// by baseline, for this update
+	std::vector<uint32_t> slot_index;
+	std::vector<uint8_t> datagram;
+
+	void receive();
+	const std::vector<BinaryWriter>& encode( const ReplicaState& state, uint32_t baseline );
+	size_t send( const Client& client, uint32_t sequence, uint32_t baseline, const std::vector<BinaryWriter>& fragments, size_t f );
+	void send_paced( Client& client );
+};
+
+// keeps a world in step with a ReplicationServer. The server's entities get entities of this world.
+// When no state comes in for a while, the server dropped it or was restarted, it joins again
+class ReplicationClient
+{
+public:
+	static constexpr uint32_t rejoin_after = 30;		// updates without a state datagram
+
+	// the receive buffer asked for is capped by the system, the server is told what it got
+	bool connect( const std::string& host, uint16_t port, size_t buffer_size = 4 << 20 );
+
+	// applies the newest state that came in complete, true when there was one
+	bool update( Registry& registry, World& world );
+
+	const ReplicationStats& get_stats() const { return stats; }
+	size_t get_entity_count() const { return local.size(); }
+
+private:
+	struct Pending
+	{
+		uint32_t baseline = 0;
+		uint16_t received = 0;
+		std::vector<std::vector<uint8_t>> fragments;
+		std::vector<bool> arrived;
+	};
+
+	UdpSocket socket;
+	UdpEndpoint server;
+	std::vector<ReplicaState> states = std::vector<ReplicaState>( ReplicationServer::history );
+	ReplicaState decoded;
+	std::map<uint32_t, Pending> pending;		// by sequence
+	ReplicaState previous;		// applied before joining again, the first state after is applied against it
+	uint32_t newest = 0;
+	uint32_t quiet = 0;		// updates since a state datagram came in
+	std::unordered_map<Entity, Entity> local;		// the server's entities to this world's
+	std::vector<uint8_t> datagram;
+	ReplicationStats stats;
+
+	void receive();
+	bool decode( uint32_t sequence, const Pending& from );
+	void apply( Registry& registry, World& world );
+	void send_ack( uint32_t acked );
+	void send_join();
+	void rejoin();
+};
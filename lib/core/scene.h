@@ -0,0 +1,39 @@
+/*
+ * scene.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "world.h"
+
+// what was loaded from the scene file, so that later edits of the file can be applied incrementally
+struct SceneEntity
+{
+	Entity entity = InvalidEntity;
+	std::unordered_map<std::string, uint64_t> components;		// component name -> fingerprint of its json
+};
+
+struct Scene
+{
+	std::string filename;
+	std::unordered_map<std::string, SceneEntity> entities {};		// keyed on the "id" of the entity in the scene file
+};
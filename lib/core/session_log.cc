@@ -0,0 +1,218 @@
+/*
+ * session_log.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include "session_log.h"
+
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <typeindex>
+#include <unordered_map>
+
+#include "../events/key_event.h"
+#include "../events/mouse_event.h"
+
+#include "../commands/load_request.h"
+#include "../commands/region_load_request.h"
+#include "../commands/reload_request.h"
+#include "../commands/stream_load_request.h"
+
+#define CAT(a,b) a##b
+
+constexpr uint32_t magic = 0x4c535452;		// "RTSL"
+constexpr uint32_t version = 1;
+
+using EventReader = std::unique_ptr<IEvent>(*)( BinaryReader& );
+using CommandReader = std::unique_ptr<ICommand>(*)( BinaryReader& );
+
+static const EventReader event_readers[] = {
+#define X(Name) []( BinaryReader& in ) -> std::unique_ptr<IEvent> { return std::make_unique<CAT(Name,Event)>( in ); },
+	#include "../events/events.def"
+#undef X
+};
+
+static const CommandReader command_readers[] = {
+#define X(Name) []( BinaryReader& in ) -> std::unique_ptr<ICommand> { return std::make_unique<CAT(Name,Request)>( in ); },
+	#include "../commands/commands.def"
+#undef X
+};
+
+static uint8_t event_type( const IEvent& event )
+{
+	static const std::unordered_map<std::type_index, uint8_t> types = []()
+	{
+		std::unordered_map<std::type_index, uint8_t> types;
+		uint8_t next = 0;
+#define X(Name) types.emplace( typeid(CAT(Name,Event)), next++ );
+		#include "../events/events.def"
+#undef X
+		return types;
+	}();
+
+	auto it = types.find( typeid( event ) );
+	if( it == types.end() )
+		throw std::runtime_error( "session log: event type missing from events.def" );
+
+	return it->second;
+}
+
+static uint8_t command_type( const ICommand& command )
+{
+	static const std::unordered_map<std::type_index, uint8_t> types = []()
+	{
+		std::unordered_map<std::type_index, uint8_t> types;
+		uint8_t next = 0;
+#define X(Name) types.emplace( typeid(CAT(Name,Request)), next++ );
+		#include "../commands/commands.def"
+#undef X
+		return types;
+	}();
+
+	auto it = types.find( typeid( command ) );
+	if( it == types.end() )
+		throw std::runtime_error( "session log: command type missing from commands.def" );
+
+	return it->second;
+}
+
+bool SessionRecorder::open( const std::string& filename )
+{
+	file.open( filename, std::ios::binary | std::ios::trunc );
+	if( !file.is_open() )
+		return false;
+
+	BinaryWriter header;
+	header.put( magic );
+	header.put( version );
+	file.write( reinterpret_cast<const char*>( header.data().data() ), header.size() );
+
+	return bool( file );
+}
+
+void SessionRecorder::begin_frame( double elapsed )
+{
+	frame.clear();
+	frame.put( 'F' );
+	frame.put( elapsed );
+}
+
+void SessionRecorder::record( const IEvent& event )
+{
+	frame.put( 'E' );
+	frame.put( event_type( event ) );
+	event.write( frame );
+}
+
+void SessionRecorder::record( const ICommand& command )
+{
+	frame.put( 'C' );
+	frame.put( command_type( command ) );
+	command.write( frame );
+}
+
+// a frame at a time, so a session that ends in a crash is on disk up to the frame before it
+void SessionRecorder::end_frame()
+{
+	file.write( reinterpret_cast<const char*>( frame.data().data() ), frame.size() );
+	file.flush();
+}
+
+bool SessionReplay::open( const std::string& filename )
+{
+	std::ifstream file( filename, std::ios::binary );
+	if( !file.is_open() )
+		return false;
+
+	this->filename = filename;
+	bytes.assign( std::istreambuf_iterator<char>( file ), std::istreambuf_iterator<char>() );
+	reader = BinaryReader( bytes );
+	frame_commands.clear();
+	frame_count = 0;
+
+	if( bytes.size() < 2 * sizeof( uint32_t ) || reader.get<uint32_t>() != magic || reader.get<uint32_t>() != version ) {
+		reader = BinaryReader( nullptr, 0 );
+		return false;
+	}
+
+	return true;
+}
+
+bool SessionReplay::read_events( double& elapsed, InputQueue& events )
+{
+	if( reader.at_end() )
+		return false;
+
+	// the whole frame is read before any of it is handed out, so a session that was cut short in
+	// the middle of a frame, by a crash say, ends at the frame before
+	InputQueue frame_events;
+	double frame_elapsed;
+
+	frame_commands.clear();
+
+	try {
+		if( reader.get<char>() != 'F' )
+			throw std::runtime_error( "frame expected" );
+
+		frame_elapsed = reader.get<double>();
+
+		while( !reader.at_end() && reader.peek() == 'E' ) {
+
+			reader.get<char>();
+			uint8_t type = reader.get<uint8_t>();
+
+			if( type >= std::size( event_readers ) )
+				throw std::runtime_error( "unknown event type" );
+
+			frame_events.push( event_readers[type]( reader ) );
+		}
+
+		while( !reader.at_end() && reader.peek() == 'C' ) {
+
+			reader.get<char>();
+			uint8_t type = reader.get<uint8_t>();
+
+			if( type >= std::size( command_readers ) )
+				throw std::runtime_error( "unknown command type" );
+
+			frame_commands.push( command_readers[type]( reader ) );
+		}
+	}
+	catch( const std::exception& e ) {
+		std::cerr << "racetrack: session " << filename << " ends after frame " << frame_count << ": " << e.what() << "\n";
+		reader = BinaryReader( nullptr, 0 );
+		frame_commands.clear();
+		return false;
+	}
+
+	elapsed = frame_elapsed;
+	while( auto event = frame_events.pop() )
+		events.push( std::move( event ) );
+
+	++frame_count;
+
+	return true;
+}
+
+void SessionReplay::read_commands( CommandQueue& commands )
+{
+	while( auto command = frame_commands.pop() )
+		commands.push( std::move( command ) );
+}
@@ -0,0 +1,73 @@
+/*
+ * session_log.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "binary_stream.h"
+#include "commandqueue.h"
+#include "inputqueue.h"
+
+/*
+ * A session as the engine saw it: for every frame its timestep, the events it processed and the
+ * commands it executed, in that order. The file starts with a magic word and a version; a frame is
+ * a 'F' and the timestep, followed by an 'E' or 'C', the type's place in events.def or commands.def
+ * and what the event or command writes, for each of them. Values are in the machine's byte order.
+ */
+class SessionRecorder
+{
+public:
+	bool open( const std::string& filename );
+
+	void begin_frame( double elapsed );
+	void record( const IEvent& event );
+	void record( const ICommand& command );
+	void end_frame();
+
+private:
+	std::ofstream file;
+	BinaryWriter frame;
+};
+
+// plays a recorded session back in place of the platform's clock and input
+class SessionReplay
+{
+public:
+	// false when the file is missing or not a session of this version
+	bool open( const std::string& filename );
+
+	// false when the session has no more frames; one cut short or damaged ends at the last
+	// whole frame, with what was wrong on stderr
+	bool read_events( double& elapsed, InputQueue& events );
+	void read_commands( CommandQueue& commands );
+
+	size_t frames() const { return frame_count; }
+
+private:
+	std::string filename;
+	std::vector<uint8_t> bytes;
+	BinaryReader reader { nullptr, 0 };
+	CommandQueue frame_commands;		// read with the frame's events, handed out by read_commands
+	size_t frame_count = 0;
+};
@@ -0,0 +1,103 @@
+/*
+ * spsc_ring.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+/*
+ * A fixed size queue for one producer and one consumer thread, without locks. The space is taken
+ * up front, pushing never allocates and fails when the queue is full. Each side keeps its own
+ * copy of the other's position and reads the shared one only when that copy says it must, so the
+ * two mostly stay off each other's cache lines.
+ */
+template<typename T>
+class SpscRing
+{
+	static_assert( std::is_trivially_copyable_v<T> );
+
+public:
+	// rounded up to a power of two
+	explicit SpscRing( size_t capacity )
+	{
+		size_t size = 1;
+		while( size < capacity )
+			size *= 2;
+
+		items = std::make_unique<T[]>( size );
+		mask = size - 1;
+	}
+
+	// producer
+	bool push( const T& item )
+	{
+		size_t at = head.load( std::memory_order_relaxed );
+
+		if( at - cached_tail > mask ) {
+			cached_tail = tail.load( std::memory_order_acquire );
+			if( at - cached_tail > mask )
+				return false;
+		}
+
+		items[at & mask] = item;
+		head.store( at + 1, std::memory_order_release );
+
+		return true;
+	}
+
+	// consumer, takes up to most items and returns how many it took
+	size_t pop( T * out, size_t most )
+	{
+		size_t at = tail.load( std::memory_order_relaxed );
+
+		if( cached_head == at )
+			cached_head = head.load( std::memory_order_acquire );
+
+		size_t count = std::min( most, cached_head - at );
+
+		for( size_t i = 0; i < count; ++i )
+			out[i] = items[( at + i ) & mask];
+
+		tail.store( at + count, std::memory_order_release );
+
+		return count;
+	}
+
+	// either side, as of a moment ago
+	size_t size() const
+	{
+		size_t taken = tail.load( std::memory_order_acquire );		// first, the head is never behind it
+		return head.load( std::memory_order_acquire ) - taken;
+	}
+	size_t capacity() const { return mask + 1; }
+
+private:
+	std::unique_ptr<T[]> items;
+	size_t mask;
+
+	alignas(64) std::atomic<size_t> head { 0 };		// written by the producer
+	size_t cached_tail = 0;
+	alignas(64) std::atomic<size_t> tail { 0 };		// written by the consumer
+	size_t cached_head = 0;
+};
@@ -36,6 +36,7 @@ public:
     virtual void update( double elapsed ) = 0;
     virtual void draw() = 0;
     virtual void flush() = 0;
+    virtual void rewind() = 0;      // the world was put back to a snapshot, drop what was taken from it
     virtual void shutdown() = 0;
 };
 
@@ -52,6 +53,7 @@ public:
     void update( double elapsed ) override {}
     void draw() override {}
     void flush() override { }
+    void rewind() override {}
     void shutdown() override {}
 
 protected:
@@ -0,0 +1,300 @@
+/*
+ * telemetry.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include "telemetry.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <numeric>
+
+constexpr uint32_t magic = 0x4d545452;		// "RTTM"
+constexpr uint32_t version = 1;
+constexpr uint32_t delta_encoded = 1;
+
+static std::atomic<uint64_t> next_serial { 1 };
+
+static uint64_t zigzag( int64_t value ) { return ( uint64_t( value ) << 1 ) ^ uint64_t( value >> 63 ); }
+static int64_t unzigzag( uint64_t value ) { return int64_t( value >> 1 ) ^ -int64_t( value & 1 ); }
+
+// the columns in the order of the file, floats by their bits
+template<typename Fn>
+static void for_each_column( Fn&& fn )
+{
+	fn( &TelemetryRecord::tick );
+	fn( &TelemetryRecord::entity );
+	for( auto field : { &TelemetryRecord::x, &TelemetryRecord::y, &TelemetryRecord::heading,
+						&TelemetryRecord::vx, &TelemetryRecord::vy, &TelemetryRecord::yaw_rate,
+						&TelemetryRecord::throttle, &TelemetryRecord::brake, &TelemetryRecord::steer } )
+		fn( field );
+}
+
+template<typename T> static uint64_t bits_of( T value ) { if constexpr( std::is_same_v<T, float> ) return std::bit_cast<uint32_t>( value ); else return value; }
+template<typename T> static T from_bits( uint64_t bits ) { if constexpr( std::is_same_v<T, float> ) return std::bit_cast<float>( uint32_t( bits ) ); else return T( bits ); }
+
+Telemetry::Telemetry() : serial( next_serial++ ) {}
+
+Telemetry::~Telemetry()
+{
+	close();
+}
+
+bool Telemetry::open( const std::string& filename, bool delta, size_t ring_capacity )
+{
+	close();
+
+	file.open( filename, std::ios::binary | std::ios::trunc );
+	if( !file.is_open() )
+		return false;
+
+	this->delta = delta;
+	this->ring_capacity = ring_capacity;
+
+	batch.resize( block_records );
+	batched = 0;
+
+	BinaryWriter header;
+	header.put( magic );
+	header.put( version );
+	header.put( delta ? delta_encoded : 0u );
+	file.write( reinterpret_cast<const char*>( header.data().data() ), header.size() );
+
+	written = 0;
+	bytes = header.size();
+
+	stopping = false;
+	writer = std::thread( &Telemetry::write, this );
+
+	return bool( file );
+}
+
+void Telemetry::close()
+{
+	if( !writer.joinable() )
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+		stopping = true;
+	}
+	wakeup.notify_one();
+	writer.join();
+
+	file.close();
+}
+
+bool Telemetry::push( const TelemetryRecord& record )
+{
+	Ring& ring = ring_of_this_thread();
+
+	if( ring.records.push( record ) )
+		return true;
+
+	ring.dropped.fetch_add( 1, std::memory_order_relaxed );
+	return false;
+}
+
+TelemetryStats Telemetry::get_stats() const
+{
+	TelemetryStats stats;
+
+	stats.written = written;
+	stats.bytes = bytes;
+
+	std::lock_guard<std::mutex> lock( mutex );
+
+	for( auto& ring : rings ) {
+		uint64_t dropped = ring->dropped.load( std::memory_order_relaxed );
+		stats.dropped += dropped;
+		stats.peak_fill = std::max( stats.peak_fill, dropped ? 1.0 : double( peak ) / double( ring->records.capacity() ) );
+	}
+
+	return stats;
+}
+
+// the ring this thread used last, looked up under the lock only when the thread first pushes or
+// has pushed to another instance since
+Telemetry::Ring& Telemetry::ring_of_this_thread()
+{
+	thread_local uint64_t cached_serial = 0;
+	thread_local Ring * cached = nullptr;
+
+	if( cached_serial == serial )
+		return *cached;
+
+	std::lock_guard<std::mutex> lock( mutex );
+
+	auto id = std::this_thread::get_id();
+	auto it = std::find_if( rings.begin(), rings.end(), [id]( auto& ring ) { return ring->producer == id; } );
+
+	if( it == rings.end() ) {
+		rings.push_back( std::make_unique<Ring>( ring_capacity ) );
+		rings.back()->producer = id;
+		it = rings.end() - 1;
+	}
+
+	cached = it->get();
+	cached_serial = serial;
+
+	return *cached;
+}
+
+// every couple of milliseconds, so a frame's worth of records never sits in a ring for long
+void Telemetry::write()
+{
+	std::vector<Ring*> current;
+	std::unique_lock<std::mutex> lock( mutex );
+
+	for( ;; ) {
+
+		wakeup.wait_for( lock, std::chrono::milliseconds( 2 ), [this]() { return stopping; } );
+
+		bool stop = stopping;
+		current.clear();
+		for( auto& ring : rings )
+			current.push_back( ring.get() );
+
+		lock.unlock();
+		drain( current, stop );
+		lock.lock();
+
+		if( stop )
+			return;
+	}
+}
+
+void Telemetry::drain( const std::vector<Ring*>& from, bool all )
+{
+	for( Ring * ring : from ) {
+
+		peak = std::max( peak.load(), ring->records.size() );
+
+		while( size_t count = ring->records.pop( batch.data() + batched, block_records - batched ) ) {
+			batched += count;
+			if( batched == block_records )
+				write_block();
+		}
+	}
+
+	if( all && batched )
+		write_block();
+
+	file.flush();
+}
+
+void Telemetry::write_block()
+{
+	block.clear();
+
+	order.resize( batched );
+	std::iota( order.begin(), order.end(), 0u );
+
+	// a car's ticks next to each other, so the differences between rows are small
+	if( delta )
+		std::stable_sort( order.begin(), order.end(), [this]( uint32_t a, uint32_t b )
+			{ return batch[a].entity != batch[b].entity ? batch[a].entity < batch[b].entity : batch[a].tick < batch[b].tick; } );
+
+	for_each_column( [this]( auto field )
+	{
+		uint64_t previous = 0;
+
+		for( uint32_t i : order ) {
+			if( delta ) {
+				uint64_t bits = bits_of( batch[i].*field );
+				block.put_varint( zigzag( int64_t( bits - previous ) ) );
+				previous = bits;
+			}
+			else
+				block.put( batch[i].*field );
+		}
+	} );
+
+	BinaryWriter header;
+	header.put( uint32_t( batched ) );
+	header.put( uint32_t( block.size() ) );
+
+	file.write( reinterpret_cast<const char*>( header.data().data() ), header.size() );
+	file.write( reinterpret_cast<const char*>( block.data().data() ), block.size() );
+
+	written += batched;
+	bytes += header.size() + block.size();
+	batched = 0;
+}
+
+bool read_telemetry( const std::string& filename, std::vector<TelemetryRecord>& records )
+{
+	std::ifstream file( filename, std::ios::binary );
+	if( !file.is_open() )
+		return false;
+
+	std::vector<uint8_t> bytes( ( std::istreambuf_iterator<char>( file ) ), std::istreambuf_iterator<char>() );
+
+	try {
+		BinaryReader reader( bytes );
+
+		if( reader.get<uint32_t>() != magic || reader.get<uint32_t>() != version )
+			return false;
+
+		bool delta = reader.get<uint32_t>() & delta_encoded;
+
+		// the least a record takes in a block, a byte a column when delta encoded
+		size_t record_size = 0;
+		for_each_column( [&]( auto field ) { record_size += delta ? 1 : sizeof( TelemetryRecord {}.*field ); } );
+
+		while( !reader.at_end() ) {
+
+			uint32_t count = reader.get<uint32_t>();
+			uint32_t size = reader.get<uint32_t>();
+
+			// a damaged count must not size the records before the block is read
+			uint64_t least = uint64_t( count ) * record_size;
+			if( size > bytes.size() - reader.position() || least > size || ( !delta && least != size ) )
+				return false;
+
+			size_t start = reader.position();
+			size_t first = records.size();
+			records.resize( first + count );
+			TelemetryRecord * block = records.data() + first;
+
+			for_each_column( [&]( auto field )
+			{
+				using T = std::remove_reference_t<decltype( block->*field )>;
+				uint64_t previous = 0;
+
+				for( uint32_t i = 0; i < count; ++i ) {
+					if( delta ) {
+						previous += uint64_t( unzigzag( reader.get_varint() ) );
+						block[i].*field = from_bits<T>( previous );
+					}
+					else
+						block[i].*field = reader.get<T>();
+				}
+			} );
+
+			if( reader.position() - start != size )
+				return false;
+		}
+	}
+	catch( const std::runtime_error& ) {
+		return false;
+	}
+
+	return true;
+}
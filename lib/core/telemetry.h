@@ -0,0 +1,124 @@
+/*
+ * telemetry.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "binary_stream.h"
+#include "spsc_ring.h"
+#include "world.h"
+
+// one car at the end of a tick
+struct TelemetryRecord
+{
+	uint64_t tick;
+	Entity entity;
+
+	float x, y, heading;
+	float vx, vy, yaw_rate;
+	float throttle, brake, steer;
+};
+
+struct TelemetryStats
+{
+	uint64_t written = 0;		// records in the file
+	uint64_t dropped = 0;		// pushed while their thread's ring was full
+	uint64_t bytes = 0;			// of the file so far
+	double peak_fill = 0.0;		// of the fullest ring, 1 when it has been full
+};
+
+/*
+ * Takes records from any thread and writes them to disk on a thread of its own. Each producing
+ * thread gets a ring of its own the first time it pushes, after which pushing is a copy into the
+ * ring, no locks and no allocation. A full ring drops the record and counts it, rather than holding
+ * up the simulation; the stats tell how close the rings came to that.
+ *
+ * The file is a magic word, a version and the flags, then blocks of up to block_records records.
+ * A block is its record count and byte size, then the records column by column: tick, entity, x,
+ * y, heading, vx, vy, yaw_rate, throttle, brake and steer. Delta encoded blocks are sorted by car
+ * and tick, and each value is the zigzagged difference from the row before as a varint, for floats
+ * the difference of their bits, which is small for a car that moved a little. Otherwise the
+ * columns hold the plain values in the machine's byte order.
+ */
+class Telemetry
+{
+public:
+	static constexpr size_t block_records = 16384;
+
+	Telemetry();
+	~Telemetry();
+
+	// ring_capacity in records per producing thread
+	bool open( const std::string& filename, bool delta = true, size_t ring_capacity = 65536 );
+
+	// writes out what was pushed and stops the writer
+	void close();
+
+	bool push( const TelemetryRecord& record );
+
+	TelemetryStats get_stats() const;
+
+private:
+	struct Ring
+	{
+		Ring( size_t capacity ) : records( capacity ) {}
+
+		SpscRing<TelemetryRecord> records;
+		std::thread::id producer;
+		std::atomic<uint64_t> dropped { 0 };
+	};
+
+	const uint64_t serial;			// tells the threads' cached rings of different instances apart
+	size_t ring_capacity = 65536;
+	bool delta = true;
+
+	mutable std::mutex mutex;		// over rings and stopping
+	std::condition_variable wakeup;
+	std::vector<std::unique_ptr<Ring>> rings;
+	bool stopping = false;
+	std::thread writer;
+
+	// the writer's
+	std::ofstream file;
+	std::vector<TelemetryRecord> batch;
+	size_t batched = 0;
+	std::vector<uint32_t> order;
+	BinaryWriter block;
+	std::atomic<uint64_t> written { 0 };
+	std::atomic<uint64_t> bytes { 0 };
+	std::atomic<size_t> peak { 0 };		// the most records seen waiting in a ring
+
+	Ring& ring_of_this_thread();
+	void write();
+	void drain( const std::vector<Ring*>& from, bool all );
+	void write_block();
+};
+
+// reads a telemetry file back into records, in the order of the file
+bool read_telemetry( const std::string& filename, std::vector<TelemetryRecord>& records );
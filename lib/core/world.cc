@@ -19,3 +19,47 @@
 
 #include "world.h"
 
+
+// takes a copy of every store into the snapshot, reusing the space it had. Given the previous
+// snapshot, a store that has not changed since is shared with it instead of copied
+void World::snapshot( Snapshot& into, const Snapshot * previous )
+{
+	++snapshots;
+
+	into.next_id = next_id;
+	std::erase_if( into.images, [this]( auto& image ) { return !stores.count( image.first ); } );
+
+	for( auto& [type, store] : stores ) {
+
+		auto& image = into.images[type];
+
+		if( previous ) {
+			auto it = previous->images.find( type );
+			if( it != previous->images.end() && store->matches( *it->second ) ) {
+				image = it->second;
+				continue;
+			}
+		}
+
+		// an image still held by another snapshot is left to it
+		image = store->save( image.use_count() == 1 ? image : nullptr );
+	}
+}
+
+void World::restore( const Snapshot& snapshot )
+{
+	next_id = snapshot.next_id;
+
+	for( auto& [type, store] : stores )
+		if( !snapshot.images.count( type ) )
+			store->clear();
+
+	for( auto& [type, image] : snapshot.images ) {
+
+		auto& store = stores[type];
+		if( !store )
+			store = image->make_store();
+
+		store->restore( *image );
+	}
+}
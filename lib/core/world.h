@@ -23,7 +23,12 @@
 #include <vector>
 #include <unordered_map>
 #include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <iterator>
+#include <concepts>
 #include <memory>
+#include <type_traits>
 
 using Entity = std::uint32_t;
 constexpr uint32_t InvalidEntity = (uint32_t)-1;
@@ -34,67 +39,279 @@ template<typename... Ts> class View;
 class World
 {
 private:
+	struct IImage;
+
 	struct IStore
 	{
         virtual ~IStore() = default;
         virtual void clear() = 0;
+
+		virtual std::shared_ptr<IImage> save( std::shared_ptr<IImage> reuse ) const = 0;
+		virtual bool matches( const IImage& image ) const = 0;
+		virtual void restore( const IImage& image ) = 0;
     };
+
+	// a copy of one store, the component type knows how to make the store back
+	struct IImage
+	{
+		virtual ~IImage() = default;
+		virtual std::unique_ptr<IStore> make_store() const = 0;
+	};
+
+	// entity to packed index, in pages of 4096 entities. A page is made when the first of its entities
+	// gets a component and dropped by trim() once none has one, so ids long gone cost a null pointer per page
+	class SparseIndex
+	{
+	public:
+		static constexpr uint32_t npos = (uint32_t)-1;
+
+		uint32_t find( Entity e ) const
+		{
+			size_t page = e >> page_bits;
+			return page < pages.size() && pages[page] ? pages[page]->slots[ e & page_mask ] : npos;
+		}
+
+		void set( Entity e, uint32_t index )
+		{
+			size_t page = e >> page_bits;
+
+			if( page >= pages.size() )
+				pages.resize( page + 1 );
+			if( !pages[page] )
+				pages[page] = std::make_unique<Page>();
+
+			uint32_t& slot = pages[page]->slots[ e & page_mask ];
+			if( slot == npos )
+				++pages[page]->used;
+			slot = index;
+		}
+
+		void reset( Entity e )
+		{
+			size_t page = e >> page_bits;
+
+			if( page >= pages.size() || !pages[page] || pages[page]->slots[ e & page_mask ] == npos )
+				return;
+
+			pages[page]->slots[ e & page_mask ] = npos;
+			--pages[page]->used;
+		}
+
+		void trim()
+		{
+			for( auto& page : pages )
+				if( page && !page->used )
+					page.reset();
+
+			while( !pages.empty() && !pages.back() )
+				pages.pop_back();
+		}
+
+		void clear() { pages.clear(); }
+
+	private:
+		static constexpr uint32_t page_bits = 12;
+		static constexpr uint32_t page_mask = ( 1u << page_bits ) - 1;
+
+		struct Page
+		{
+			Page() { std::fill( std::begin( slots ), std::end( slots ), npos ); }
+
+			uint32_t used = 0;
+			uint32_t slots[ 1u << page_bits ];
+		};
+
+		std::vector<std::unique_ptr<Page>> pages;
+	};
+
+	// components are kept packed in the order they were added, so the whole store copies in one go.
+	// A pointer to a component is only good until the next change to its store: adding a component
+	// of the same type may move them all, flushing removals moves the last one into the hole and
+	// restoring a snapshot copies over them. Take the pointer again after any of those
     template< typename T>
     class Store : public IStore
     {
     public:
-        using ComponentMap = std::unordered_map<Entity, T>;
 		using RemovalList = std::vector<Entity>;
 
-        T* add( Entity e, const T& component ) { components[e] = component; return &(components[e]); }
+        T* add( Entity e, const T& component )
+		{
+			if( T* existing = get(e) ) {
+				*existing = component;
+				return existing;
+			}
+
+			sparse.set( e, uint32_t( components.size() ) );
+			entities.push_back( e );
+			components.push_back( component );
+
+			return &components.back();
+		}
         void remove( Entity e ) { pending_removals.push_back(e); }
-        bool has(Entity e) const { return components.count(e); }
-		void flush( ) { for( Entity e : pending_removals ) components.erase(e); pending_removals.clear(); }
+        bool has(Entity e) const { return sparse.find(e) != npos; }
+		void flush( )
+		{
+			if( pending_removals.empty() )
+				return;
+
+			for( Entity e : pending_removals ) erase(e);
+			pending_removals.clear();
+			sparse.trim();
+		}
+
+        T* get( Entity e ) { uint32_t i = sparse.find(e); return i != npos ? &components[i] : nullptr; }
+        const T* get( Entity e ) const { uint32_t i = sparse.find(e); return i != npos ? &components[i] : nullptr; }
 
-        T* get( Entity e ) { auto it = components.find(e); return it != components.end() ? &it->second : nullptr; }
-        const T* get( Entity e ) const { auto it = components.find(e); return it != components.end() ? &it->second : nullptr; }
+		template<typename Fn> void for_each( Fn&& fn ) const { for( size_t i = 0; i < entities.size(); ++i ) fn( entities[i], components[i] ); };
+		template<typename Fn> void for_each( Fn&& fn ) { for( size_t i = 0; i < entities.size(); ++i ) fn( entities[i], components[i] ); };
 
-		template<typename Fn> void for_each( Fn&& fn ) const { for( const auto& [e, c] : components ) fn(e, c); };
-		template<typename Fn> void for_each( Fn&& fn ) { for( auto& [e, c] : components ) fn(e, c); };
+		void clear() override { sparse.clear(); entities.clear(); components.clear(); pending_removals.clear(); }
 
-		void clear() override { components.clear(); pending_removals.clear(); }
+		struct Image : IImage
+		{
+			std::vector<Entity> entities;
+			std::vector<T> components;
+			RemovalList pending_removals;
+
+			std::unique_ptr<IStore> make_store() const override { return std::make_unique<Store<T>>(); }
+		};
+
+		std::shared_ptr<IImage> save( std::shared_ptr<IImage> reuse ) const override
+		{
+			auto image = reuse ? std::static_pointer_cast<Image>( reuse ) : std::make_shared<Image>();
+
+			copy( entities, image->entities );
+			copy( components, image->components );
+			image->pending_removals = pending_removals;
+
+			return image;
+		}
+
+		bool matches( const IImage& image ) const override
+		{
+			auto& from = static_cast<const Image&>( image );
+
+			if( from.entities != entities || from.pending_removals != pending_removals )
+				return false;
+
+			if constexpr( std::is_trivially_copyable_v<T> )
+				return components.empty() || !std::memcmp( from.components.data(), components.data(), components.size() * sizeof(T) );
+			else if constexpr( std::equality_comparable<T> )
+				return from.components == components;
+			else
+				return false;
+		}
+
+		void restore( const IImage& image ) override
+		{
+			auto& from = static_cast<const Image&>( image );
+
+			for( Entity e : entities )
+				sparse.reset(e);
+
+			copy( from.entities, entities );
+			copy( from.components, components );
+			pending_removals = from.pending_removals;
+
+			for( size_t i = 0; i < entities.size(); ++i )
+				sparse.set( entities[i], uint32_t( i ) );
+
+			sparse.trim();
+		}
 
     private:
-        ComponentMap components;
+		static constexpr uint32_t npos = SparseIndex::npos;
+
+		SparseIndex sparse;		// by entity, into the packed arrays
+		std::vector<Entity> entities;
+		std::vector<T> components;
 		RemovalList pending_removals;
+
+		void erase( Entity e )
+		{
+			if( !has(e) )
+				return;
+
+			uint32_t i = sparse.find(e);
+
+			if( i + 1 < entities.size() ) {
+				components[i] = std::move( components.back() );
+				entities[i] = entities.back();
+				sparse.set( entities[i], i );
+			}
+
+			components.pop_back();
+			entities.pop_back();
+			sparse.reset(e);
+		}
+
+		// a straight memcpy where the type allows it, into the space the target already has
+		template<typename U> static void copy( const std::vector<U>& from, std::vector<U>& to )
+		{
+			if constexpr( std::is_trivially_copyable_v<U> ) {
+				if( to.size() != from.size() )
+					to.resize( from.size() );
+				if( !from.empty() )
+					std::memcpy( to.data(), from.data(), from.size() * sizeof(U) );
+			}
+			else
+				to = from;
+		}
     };
 
 public:
+	// every store as it was at one moment. Stores that did not change between two snapshots are
+	// shared by them, large components keep their data behind shared pointers so it is not copied
+	class Snapshot
+	{
+		friend World;
+
+		Entity next_id = 0;
+		std::unordered_map<std::type_index, std::shared_ptr<IImage>> images;
+	};
+
 	template<typename T, typename Fn> void for_each_entity( Fn&& fn ) const { component_store<T>().for_each( [&]( Entity e, const T& ) { fn(e); } ); };
 
+	// good until the store of T changes, see Store
     template<typename T> T* get_component( Entity e ) { return component_store<T>().get(e ); }
     template<typename T> T* get_component( Entity e ) const { return component_store<T>().get(e ); }
 
 	template<typename... Ts> View<Ts...> view();					// defined in view.h
 	template<typename... Ts> View<const Ts...> view() const;		// defined in view.h
 
+	// counts the snapshots taken, data patched in place has to be copied first when it went up
+	uint64_t get_snapshot_count() const { return snapshots; }
+
 private:
     Entity next_id = 0;
+	uint64_t snapshots = 0;
 	mutable std::unordered_map<std::type_index, std::unique_ptr<IStore>> stores;
 
+	// views of const components share the store of the components
     template<typename T>
-    Store<T>& component_store() const
+    Store<std::remove_const_t<T>>& component_store() const
     {
-		auto type = std::type_index( typeid(T) );
+		using Stored = std::remove_const_t<T>;
+
+		auto type = std::type_index( typeid(Stored) );
 
 		auto& store_ptr = stores[type];
 		if( !store_ptr )
-			store_ptr = std::make_unique<Store<T>>();
+			store_ptr = std::make_unique<Store<Stored>>();
 
-        return static_cast<Store<T>&>(*store_ptr);
+        return static_cast<Store<Stored>&>(*store_ptr);
     }
 
 	friend Registry;
 
     Entity create_entity() { return next_id++; }
+    Entity create_entities( size_t count ) { Entity first = next_id; next_id += count; return first; }
 	void remove_entity( Entity e ) {};
     template<typename T> T& add_component( Entity e, const T& component ) { return *component_store<T>().add(e, component ); }
     template<typename T> void remove_component( Entity e ) { component_store<T>().remove(e); }
     template<typename T> void flush_components() { component_store<T>().flush(); };
 	void clear() { next_id = 0; for( auto& [_,store] : stores) if( store ) store->clear(); };
+
+	void snapshot( Snapshot& into, const Snapshot * previous );
+	void restore( const Snapshot& snapshot );
 };
@@ -20,9 +20,11 @@
 #include "key_event.h"
 
 #include "../core/engine.h"
+#include "../core/binary_stream.h"
 
 #include <memory>
 #include "../commands/load_request.h"
+#include "../commands/region_load_request.h"
 
 #include <unordered_map>
 
@@ -36,10 +38,34 @@ void KeyReleaseEvent::process( Engine &engine )
 		{ 0x1B, [&](){engine.stop_running();} },				//escape
 		{ '0', [&](){engine.push_command( std::make_unique<LoadRequest>( "../data/data.json" ) );}},
 		{ '1', [&](){engine.push_command( std::make_unique<LoadRequest>( "../data/data simple.json" ) );}},
-		{ '2', [&](){engine.push_command( std::make_unique<LoadRequest>( "../data/data copy.json" ) );}}
+		{ '2', [&](){engine.push_command( std::make_unique<LoadRequest>( "../data/data copy.json" ) );}},
+		{ '3', [&](){engine.push_command( std::make_unique<LoadRequest>( "../data/data prefabs.json" ) );}},
+		{ '4', [&](){engine.push_command( std::make_unique<RegionLoadRequest>( "../data/data.json" ) );}}
 	};
 
 	auto it = despatchers.find( key);
 	if( it != despatchers.end() )
 		(it->second)();
 }
+
+KeyPressEvent::KeyPressEvent( BinaryReader& in ) :
+	key( in.get<char>() ), scancode( in.get<int32_t>() ), mods( in.get<int32_t>() )
+{}
+
+void KeyPressEvent::write( BinaryWriter& out ) const
+{
+	out.put( key );
+	out.put( int32_t( scancode ) );
+	out.put( int32_t( mods ) );
+}
+
+KeyReleaseEvent::KeyReleaseEvent( BinaryReader& in ) :
+	key( in.get<char>() ), scancode( in.get<int32_t>() ), mods( in.get<int32_t>() )
+{}
+
+void KeyReleaseEvent::write( BinaryWriter& out ) const
+{
+	out.put( key );
+	out.put( int32_t( scancode ) );
+	out.put( int32_t( mods ) );
+}
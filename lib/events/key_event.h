@@ -21,13 +21,17 @@
 
 #include "../core/event.h"
 
+class BinaryReader;
+
 class KeyPressEvent : public IEvent
 {
 public:
 	KeyPressEvent( char key, int scancode, int mods ) : key(key), scancode(scancode), mods(mods)
 	{}
+	KeyPressEvent( BinaryReader& in );
 
 	void process( Engine& engine ) override;
+	void write( BinaryWriter& out ) const override;
 
 private:
 	char key;
@@ -40,8 +44,10 @@ class KeyReleaseEvent : public IEvent
 public:
 	KeyReleaseEvent( char key, int scancode, int mods ) : key(key), scancode(scancode), mods(mods)
 	{}
+	KeyReleaseEvent( BinaryReader& in );
 
 	void process( Engine& engine ) override;
+	void write( BinaryWriter& out ) const override;
 
 private:
 	char key;
@@ -19,6 +19,8 @@
 
 #include "mouse_event.h"
 
+#include "../core/binary_stream.h"
+
 void MouseMoveEvent::process( Engine &engine )
 {
 
@@ -28,3 +30,26 @@ void MouseButtonEvent::process( Engine &engine )
 {
 
 }
+
+MouseMoveEvent::MouseMoveEvent( BinaryReader& in ) :
+	xpos( in.get<double>() ), ypos( in.get<double>() )
+{}
+
+void MouseMoveEvent::write( BinaryWriter& out ) const
+{
+	out.put( xpos );
+	out.put( ypos );
+}
+
+MouseButtonEvent::MouseButtonEvent( BinaryReader& in ) :
+	xpos( in.get<double>() ), ypos( in.get<double>() ), button( in.get<int32_t>() ), action( in.get<int32_t>() ), mods( in.get<int32_t>() )
+{}
+
+void MouseButtonEvent::write( BinaryWriter& out ) const
+{
+	out.put( xpos );
+	out.put( ypos );
+	out.put( int32_t( button ) );
+	out.put( int32_t( action ) );
+	out.put( int32_t( mods ) );
+}
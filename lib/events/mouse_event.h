@@ -21,13 +21,17 @@
 
 #include "../core/event.h"
 
+class BinaryReader;
+
 class MouseButtonEvent : public IEvent
 {
 public:
 	MouseButtonEvent( double xpos, double ypos, int button, int action, int mods ) :
 		xpos(xpos), ypos(ypos), button(button), action(action), mods(mods) {}
+	MouseButtonEvent( BinaryReader& in );
 
 	void process( Engine& engine ) override;
+	void write( BinaryWriter& out ) const override;
 
 private:
 	double xpos;
@@ -42,8 +46,10 @@ class MouseMoveEvent : public IEvent
 public:
 	MouseMoveEvent( double xpos, double ypos ) :
 		xpos(xpos), ypos(ypos) {}
+	MouseMoveEvent( BinaryReader& in );
 
 	void process( Engine& engine ) override;
+	void write( BinaryWriter& out ) const override;
 
 private:
 	double xpos;
@@ -0,0 +1,160 @@
+/*
+ * collision.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include "collision.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+static float radius( const Box& box, glm::vec2 direction )
+{
+	glm::vec2 across( -box.axis.y, box.axis.x );
+
+	return box.half_extents.x * std::abs( glm::dot( box.axis, direction ) ) + box.half_extents.y * std::abs( glm::dot( across, direction ) );
+}
+
+// the corner of the box furthest along the direction
+static glm::vec2 support( const Box& box, glm::vec2 direction )
+{
+	glm::vec2 across( -box.axis.y, box.axis.x );
+
+	float along = glm::dot( box.axis, direction ) < 0.0f ? -box.half_extents.x : box.half_extents.x;
+	float side = glm::dot( across, direction ) < 0.0f ? -box.half_extents.y : box.half_extents.y;
+
+	return box.centre + box.axis * along + across * side;
+}
+
+bool collide( const Box& a, const Box& b, Contact& contact )
+{
+	glm::vec2 axes[] = { a.axis, glm::vec2( -a.axis.y, a.axis.x ), b.axis, glm::vec2( -b.axis.y, b.axis.x ) };
+	glm::vec2 offset = b.centre - a.centre;
+
+	float depth = 0.0f;
+	glm::vec2 normal( 0.0f );
+
+	for( int i = 0; i < 4; ++i ) {
+
+		float distance = glm::dot( offset, axes[i] );
+		float overlap = radius( a, axes[i] ) + radius( b, axes[i] ) - std::abs( distance );
+
+		if( overlap <= 0.0f )
+			return false;
+
+		if( i == 0 || overlap < depth ) {
+			depth = overlap;
+			normal = distance < 0.0f ? -axes[i] : axes[i];
+		}
+	}
+
+	// between the deepest corners of each box into the other, good enough to push on
+	contact.normal = normal;
+	contact.depth = depth;
+	contact.point = ( support( a, normal ) + support( b, -normal ) ) * 0.5f;
+
+	return true;
+}
+
+void SweepAndPrune::pairs( const std::vector<Box>& boxes, std::vector<std::pair<uint32_t, uint32_t>>& candidates )
+{
+	size_t n = boxes.size();
+
+	candidates.clear();
+	low.resize( n );
+	high.resize( n );
+
+	for( size_t i = 0; i < n; ++i ) {
+
+		const Box& box = boxes[i];
+		glm::vec2 reach( radius( box, glm::vec2( 1.0f, 0.0f ) ), radius( box, glm::vec2( 0.0f, 1.0f ) ) );
+
+		low[i] = box.centre - reach;
+		high[i] = box.centre + reach;
+	}
+
+	// sweep along the axis the boxes are spread out on most. A new set of boxes, or a switch of axis,
+	// starts the order over with a full sort
+	glm::vec2 first = n ? low[0] : glm::vec2( 0.0f ), last = first;
+	for( size_t i = 0; i < n; ++i ) {
+		first = glm::min( first, low[i] );
+		last = glm::max( last, high[i] );
+	}
+
+	glm::vec2 spread = last - first;
+	int wanted = spread.y > spread.x * 2.0f ? 1 : ( spread.x > spread.y * 2.0f ? 0 : axis );
+
+	auto start = [&]( uint32_t i ) { return low[i][axis]; };
+
+	if( order.size() != n || wanted != axis ) {
+
+		axis = wanted;
+		order.resize( n );
+		std::iota( order.begin(), order.end(), 0u );
+		std::sort( order.begin(), order.end(), [&]( uint32_t l, uint32_t r ) { return start( l ) < start( r ); } );
+	}
+	else {
+
+		for( size_t i = 1; i < n; ++i ) {
+
+			uint32_t moving = order[i];
+			float key = start( moving );
+			size_t j = i;
+
+			for( ; j > 0 && start( order[ j - 1 ] ) > key; --j )
+				order[j] = order[ j - 1 ];
+			order[j] = moving;
+		}
+	}
+
+	int other = 1 - axis;
+
+	for( size_t i = 0; i < n; ++i ) {
+
+		uint32_t a = order[i];
+		float end = high[a][axis];
+
+		for( size_t j = i + 1; j < n && low[ order[j] ][axis] <= end; ++j ) {
+
+			uint32_t b = order[j];
+
+			if( low[a][other] <= high[b][other] && low[b][other] <= high[a][other] )
+				candidates.emplace_back( std::min( a, b ), std::max( a, b ) );
+		}
+	}
+}
+
+void SweepAndPrune::contacts( const std::vector<Box>& boxes, std::vector<Contact>& contacts )
+{
+	pairs( boxes, candidates );
+
+	contacts.clear();
+
+	for( auto [a, b] : candidates ) {
+
+		Contact contact;
+		if( collide( boxes[a], boxes[b], contact ) ) {
+			contact.a = a;
+			contact.b = b;
+			contacts.push_back( contact );
+		}
+	}
+
+	std::sort( contacts.begin(), contacts.end(), []( const Contact& l, const Contact& r ) { return l.a != r.a ? l.a < r.a : l.b < r.b; } );
+}
@@ -0,0 +1,68 @@
+/*
+ * collision.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// a rectangle turned to its heading, the shape of a car seen from above
+struct Box
+{
+	glm::vec2 centre;
+	glm::vec2 axis;				// unit, along half_extents.x
+	glm::vec2 half_extents;
+};
+
+struct Contact
+{
+	uint32_t a = 0, b = 0;		// a < b
+	glm::vec2 normal;			// unit, from a towards b
+	float depth = 0.0f;			// how far b has to move along the normal to clear a
+	glm::vec2 point;
+};
+
+// the separating axis test, true and the contact when the boxes overlap
+bool collide( const Box& a, const Box& b, Contact& contact );
+
+/*
+ * Sweep and prune: the boxes' bounds sorted by their start along one axis, each box paired with the
+ * following ones that start before it ends. The order is kept from one tick to the next and put
+ * right with an insertion sort, which for bodies that move a little each tick is close to linear.
+ */
+class SweepAndPrune
+{
+public:
+	// candidate pairs (a < b) of boxes whose bounds overlap, in no particular order
+	void pairs( const std::vector<Box>& boxes, std::vector<std::pair<uint32_t, uint32_t>>& candidates );
+
+	// the contacts among the candidates, sorted by pair so they come out the same every run
+	void contacts( const std::vector<Box>& boxes, std::vector<Contact>& contacts );
+
+private:
+	std::vector<uint32_t> order;
+	std::vector<glm::vec2> low, high;
+	std::vector<std::pair<uint32_t, uint32_t>> candidates;
+	int axis = 0;
+};
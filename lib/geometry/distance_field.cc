@@ -0,0 +1,144 @@
+/*
+ * distance_field.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "distance_field.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../core/parallel.h"
+
+constexpr int stride = DistanceField::tile_samples + 1;
+
+void DistanceField::build( glm::vec2 low, glm::vec2 high, float spacing, float range, const Distance& distance )
+{
+	this->spacing = spacing;
+	this->range = range;
+
+	origin = low - glm::vec2( range );
+	glm::vec2 extent = high + glm::vec2( range ) - origin;
+
+	float tile_extent = tile_samples * spacing;
+	columns = int( std::ceil( extent.x / tile_extent ) ) + 1;
+	rows = int( std::ceil( extent.y / tile_extent ) ) + 1;
+
+	tiles.assign( size_t( columns ) * rows, Tile {} );
+
+	parallel_for( tiles.size(), [&]( size_t tile ) { bake( tile, distance ); } );
+}
+
+bool DistanceField::rebake( glm::vec2 low, glm::vec2 high, const Distance& distance )
+{
+	if( !covers( low, high ) )
+		return false;
+
+	float tile_extent = tile_samples * spacing;
+
+	glm::vec2 first = ( low - glm::vec2( range ) - origin ) / tile_extent;
+	glm::vec2 last = ( high + glm::vec2( range ) - origin ) / tile_extent;
+
+	std::vector<size_t> affected;
+
+	for( int row = std::max( 0, int( first.y ) ); row <= std::min( rows - 1, int( last.y ) ); ++row )
+		for( int column = std::max( 0, int( first.x ) ); column <= std::min( columns - 1, int( last.x ) ); ++column )
+			affected.push_back( size_t( row ) * columns + column );
+
+	parallel_for( affected.size(), [&]( size_t i ) { bake( affected[i], distance ); } );
+
+	return true;
+}
+
+bool DistanceField::covers( glm::vec2 low, glm::vec2 high ) const
+{
+	if( tiles.empty() )
+		return false;
+
+	// the samples beyond range of the box have to stay further away than range
+	glm::vec2 end = origin + glm::vec2( columns, rows ) * ( tile_samples * spacing );
+
+	return low.x - range >= origin.x && low.y - range >= origin.y && high.x + range <= end.x && high.y + range <= end.y;
+}
+
+void DistanceField::bake( size_t index, const Distance& distance )
+{
+	Tile& tile = tiles[index];
+
+	float tile_extent = tile_samples * spacing;
+	glm::vec2 corner = origin + glm::vec2( index % columns, index / columns ) * tile_extent;
+
+	// a distance changes by at most the distance moved, so a centre further out than the reach of the
+	// tile plus range leaves every sample in it clamped
+	float centre = distance( corner + glm::vec2( tile_extent * 0.5f ) );
+	float reach = tile_extent * 0.70710678f;
+
+	if( std::abs( centre ) > reach + range ) {
+		tile.samples.clear();
+		tile.samples.shrink_to_fit();
+		tile.uniform = quantise( centre );
+		return;
+	}
+
+	tile.samples.resize( stride * stride );
+
+	for( int y = 0; y < stride; ++y )
+		for( int x = 0; x < stride; ++x )
+			tile.samples[ y * stride + x ] = quantise( distance( corner + glm::vec2( x, y ) * spacing ) );
+}
+
+int16_t DistanceField::quantise( float d ) const
+{
+	return int16_t( std::lround( std::clamp( d / range, -1.0f, 1.0f ) * 32767.0f ) );
+}
+
+float DistanceField::distance( glm::vec2 position ) const
+{
+	if( tiles.empty() )
+		return range;
+
+	glm::vec2 local = ( position - origin ) / spacing;
+
+	if( local.x < 0.0f || local.y < 0.0f || local.x >= float( columns * tile_samples ) || local.y >= float( rows * tile_samples ) )
+		return range;
+
+	int cx = int( local.x ), cy = int( local.y );
+	const Tile& tile = tiles[ size_t( cy / tile_samples ) * columns + cx / tile_samples ];
+
+	if( tile.samples.empty() )
+		return tile.uniform * ( range / 32767.0f );
+
+	int x = cx % tile_samples, y = cy % tile_samples;
+	float fx = local.x - cx, fy = local.y - cy;
+
+	const int16_t * s = tile.samples.data() + y * stride + x;
+
+	float bottom = s[0] + ( s[1] - s[0] ) * fx;
+	float top = s[stride] + ( s[ stride + 1 ] - s[stride] ) * fx;
+
+	return ( bottom + ( top - bottom ) * fy ) * ( range / 32767.0f );
+}
+
+size_t DistanceField::memory() const
+{
+	size_t bytes = tiles.size() * sizeof(Tile);
+
+	for( auto& tile : tiles )
+		bytes += tile.samples.size() * sizeof(int16_t);
+
+	return bytes;
+}
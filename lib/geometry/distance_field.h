@@ -0,0 +1,74 @@
+/*
+ * distance_field.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/*
+ * A signed distance field sampled on a regular grid, negative inside the shape. Distances are
+ * clamped to range and stored as 16 bit fractions of it, in tiles of tile_samples squared cells;
+ * a tile that lies wholly further than range from the edge is a single value. Lookups are bilinear
+ * and do not depend on the shape, so a car asking whether it is on the track costs the same as
+ * reading four numbers.
+ */
+class DistanceField
+{
+public:
+	static constexpr int tile_samples = 32;
+
+	using Distance = std::function<float( glm::vec2 )>;		// the exact signed distance, must be safe to call from several threads
+
+	// samples every spacing world units over the box grown by range
+	void build( glm::vec2 low, glm::vec2 high, float spacing, float range, const Distance& distance );
+
+	// samples again only the tiles that are within range of the box, false when it is not inside the field
+	bool rebake( glm::vec2 low, glm::vec2 high, const Distance& distance );
+
+	bool empty() const { return tiles.empty(); }
+	bool covers( glm::vec2 low, glm::vec2 high ) const;
+
+	float distance( glm::vec2 position ) const;		// range outside the field
+	bool inside( glm::vec2 position ) const { return distance( position ) < 0.0f; }
+
+	size_t memory() const;		// bytes taken by the tiles
+
+private:
+	struct Tile
+	{
+		std::vector<int16_t> samples;		// ( tile_samples + 1 ) squared, rows shared with the next tile
+		int16_t uniform = 0;				// when samples is empty
+	};
+
+	std::vector<Tile> tiles;
+
+	glm::vec2 origin = glm::vec2( 0.0f );
+	float spacing = 1.0f;
+	float range = 1.0f;
+	int columns = 0;		// in tiles
+	int rows = 0;
+
+	void bake( size_t tile, const Distance& distance );
+	int16_t quantise( float d ) const;
+};
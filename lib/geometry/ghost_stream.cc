@@ -0,0 +1,141 @@
+/*
+ * ghost_stream.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include "ghost_stream.h"
+
+#include <algorithm>
+#include <cmath>
+
+// 1/7200 s is a whole number of steps at 60, 120 and 144 Hz; 1 mm; 0.1 mrad
+const std::array<double, ghost::channels> ghost::channel_steps = { 1.0 / 7200.0, 1e-3, 1e-3, 1e-4, 1e-3, 1e-4, 1e-4, 1e-4, 1e-4, 1e-4 };
+
+static uint64_t zigzag( int64_t value ) { return ( uint64_t( value ) << 1 ) ^ uint64_t( value >> 63 ); }
+static int64_t unzigzag( uint64_t value ) { return int64_t( value >> 1 ) ^ -int64_t( value & 1 ); }
+
+static std::array<double, ghost::channels> values_of( double time, const TransformComponent& t )
+{
+	return { time, t.translation.x, t.translation.y, t.rotation.z, t.translation.z, t.rotation.x, t.rotation.y, t.scale.x, t.scale.y, t.scale.z };
+}
+
+static void set_transform( const std::array<double, ghost::channels>& v, TransformComponent& t )
+{
+	t.translation = glm::vec3( float( v[1] ), float( v[2] ), float( v[4] ) );
+	t.rotation = glm::vec3( float( v[5] ), float( v[6] ), float( v[3] ) );
+	t.scale = glm::vec3( float( v[7] ), float( v[8] ), float( v[9] ) );
+}
+
+void GhostEncoder::add( double time, const TransformComponent& transform )
+{
+	if( !count )
+		start = time;
+
+	auto values = values_of( time - start, transform );
+
+	ghost::Sample sample;
+	std::array<int64_t, ghost::channels> misses;
+	uint64_t mask = 0;
+
+	for( size_t c = 0; c < ghost::channels; ++c ) {
+
+		sample[c] = int64_t( std::llround( values[c] / ghost::channel_steps[c] ) );
+
+		int64_t predicted = 2 * last[c] - before[c];
+		misses[c] = sample[c] - predicted;
+
+		if( misses[c] )
+			mask |= uint64_t( 1 ) << c;
+	}
+
+	out.put_varint( mask );
+	for( size_t c = 0; c < ghost::channels; ++c )
+		if( misses[c] )
+			out.put_varint( zigzag( misses[c] ) );
+
+	// the first sample predicts the second standing still
+	before = count ? last : sample;
+	last = sample;
+	++count;
+}
+
+GhostLap GhostEncoder::finish()
+{
+	GhostLap lap;
+
+	lap.bytes = out.data();
+	lap.samples = count;
+	lap.duration = double( last[0] ) * ghost::channel_steps[0];
+
+	out.clear();
+	last = before = {};
+	count = 0;
+
+	return lap;
+}
+
+bool GhostPlayer::transform_at( double time, TransformComponent& transform )
+{
+	if( !lap || !lap->samples )
+		return false;
+
+	int64_t at = int64_t( std::floor( time / ghost::channel_steps[0] ) );
+
+	if( !decoded || at < before[0] )
+		rewind();
+
+	while( last[0] <= at && decoded < lap->samples )
+		decode();
+
+	// between before and last, or at the end of the lap
+	std::array<double, ghost::channels> values;
+	double span = double( last[0] - before[0] );
+	double f = decoded > 1 && span > 0.0 ? std::clamp( ( time / ghost::channel_steps[0] - double( before[0] ) ) / span, 0.0, 1.0 ) : 1.0;
+
+	for( size_t c = 0; c < ghost::channels; ++c )
+		values[c] = ( double( before[c] ) + ( double( last[c] ) - double( before[c] ) ) * f ) * ghost::channel_steps[c];
+
+	set_transform( values, transform );
+
+	return time <= double( last[0] ) * ghost::channel_steps[0];
+}
+
+void GhostPlayer::rewind()
+{
+	position = 0;
+	decoded = 0;
+	last = before = {};
+
+	decode();
+}
+
+void GhostPlayer::decode()
+{
+	BinaryReader reader( lap->bytes.data() + position, lap->bytes.size() - position );
+
+	uint64_t mask = reader.get_varint();
+	ghost::Sample sample;
+
+	for( size_t c = 0; c < ghost::channels; ++c )
+		sample[c] = 2 * last[c] - before[c] + ( ( mask >> c ) & 1 ? unzigzag( reader.get_varint() ) : 0 );
+
+	before = decoded ? last : sample;
+	last = sample;
+	++decoded;
+	position += reader.position();
+}
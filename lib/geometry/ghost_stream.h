@@ -0,0 +1,98 @@
+/*
+ * ghost_stream.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../components/transform_component.h"
+#include "../core/binary_stream.h"
+
+/*
+ * A car's transforms over a lap, a sample a tick. Time and each value of the transform are rounded
+ * to a fixed step (channel_steps) and predicted from the two samples before as if they changed at a
+ * constant rate. A sample is a varint mask of the channels the prediction missed, followed by a
+ * zigzagged varint of each miss. A car moving smoothly misses by a step or two in x, y and heading,
+ * so a sample takes about three bytes and a minute's lap at 120 Hz some twenty kilobytes.
+ */
+struct GhostLap
+{
+	std::vector<uint8_t> bytes;
+	size_t samples = 0;
+	double duration = 0.0;		// s from the first sample to the last
+	double offset = 0.0;		// s from the first sample to the start of the lap
+	float lap_time = 0.0f;		// s
+};
+
+namespace ghost
+{
+	constexpr size_t channels = 10;		// time, translation x y, rotation z, translation z, rotation x y, scale x y z
+	extern const std::array<double, channels> channel_steps;
+
+	using Sample = std::array<int64_t, channels>;
+}
+
+// takes samples as they come, the times rising
+class GhostEncoder
+{
+public:
+	void add( double time, const TransformComponent& transform );
+
+	size_t samples() const { return count; }
+	double start_time() const { return start; }
+
+	// hands over the lap so far and starts the next
+	GhostLap finish();
+
+private:
+	BinaryWriter out;
+	ghost::Sample last {}, before {};
+	size_t count = 0;
+	double start = 0.0;
+};
+
+// decodes a lap as far as it is played, and back from the start when time goes backwards
+class GhostPlayer
+{
+public:
+	GhostPlayer() = default;
+	explicit GhostPlayer( std::shared_ptr<const GhostLap> lap ) : lap( std::move( lap ) ) {}
+
+	const std::shared_ptr<const GhostLap>& get_lap() const { return lap; }
+
+	// the transform time s after the first sample, between the samples either side. False once the
+	// time is past the last sample, the transform is the last one then
+	bool transform_at( double time, TransformComponent& transform );
+
+	bool operator==( const GhostPlayer& ) const = default;
+
+private:
+	std::shared_ptr<const GhostLap> lap;
+	size_t position = 0;			// into the bytes
+	size_t decoded = 0;
+	ghost::Sample last {}, before {};
+
+	void rewind();
+	void decode();
+};
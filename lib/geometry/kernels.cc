@@ -0,0 +1,162 @@
+/*
+ * kernels.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "kernels.h"
+#include "kernels_lanes.h"
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#define KERNELS_X86
+#endif
+
+namespace kernels {
+
+const Table * avx2_table();		// kernels_avx2.cc, null when not built for AVX2
+
+namespace {
+
+#ifdef KERNELS_X86
+
+struct Sse2Lane
+{
+	static constexpr size_t width = 4;
+	using Int = __m128i;
+	using Mask = __m128;
+
+	__m128 v;
+
+	static Sse2Lane load( const float * p ) { return { _mm_loadu_ps( p ) }; }
+	static void store( float * p, Sse2Lane a ) { _mm_storeu_ps( p, a.v ); }
+	static Sse2Lane set( float f ) { return { _mm_set1_ps( f ) }; }
+	static Sse2Lane index( size_t i ) { return { _mm_add_ps( _mm_set1_ps( float( i ) ), _mm_setr_ps( 0.0f, 1.0f, 2.0f, 3.0f ) ) }; }
+
+	friend Sse2Lane operator+( Sse2Lane a, Sse2Lane b ) { return { _mm_add_ps( a.v, b.v ) }; }
+	friend Sse2Lane operator-( Sse2Lane a, Sse2Lane b ) { return { _mm_sub_ps( a.v, b.v ) }; }
+	friend Sse2Lane operator*( Sse2Lane a, Sse2Lane b ) { return { _mm_mul_ps( a.v, b.v ) }; }
+	friend Sse2Lane operator/( Sse2Lane a, Sse2Lane b ) { return { _mm_div_ps( a.v, b.v ) }; }
+
+	static Sse2Lane sqrt( Sse2Lane a ) { return { _mm_sqrt_ps( a.v ) }; }
+	static Int round_int( Sse2Lane a ) { return _mm_cvtps_epi32( a.v ); }
+	static Sse2Lane to_float( Int q ) { return { _mm_cvtepi32_ps( q ) }; }
+
+	static Mask bit_set( Int q, int32_t bit )
+	{
+		__m128i b = _mm_set1_epi32( bit );
+		return _mm_castsi128_ps( _mm_cmpeq_epi32( _mm_and_si128( q, b ), b ) );
+	}
+	static Mask mask_xor( Mask a, Mask b ) { return _mm_xor_ps( a, b ); }
+	static Mask greater( Sse2Lane a, Sse2Lane b ) { return _mm_cmpgt_ps( a.v, b.v ); }
+	static Sse2Lane select( Mask m, Sse2Lane a, Sse2Lane b ) { return { _mm_or_ps( _mm_and_ps( m, a.v ), _mm_andnot_ps( m, b.v ) ) }; }
+	static Sse2Lane negate_if( Mask m, Sse2Lane a ) { return { _mm_xor_ps( a.v, _mm_and_ps( m, _mm_set1_ps( -0.0f ) ) ) }; }
+};
+
+constexpr Table sse2 = make_table<Sse2Lane>();
+
+#endif
+
+constexpr Table scalar = make_table<ScalarLane>();
+
+const Table * table_for( Isa isa )
+{
+	switch( isa ) {
+#ifdef KERNELS_X86
+	case Isa::AVX2:
+		if( avx2_table() )
+			return avx2_table();
+		[[fallthrough]];
+	case Isa::SSE2:
+		return &sse2;
+#endif
+	default:
+		return &scalar;
+	}
+}
+
+std::atomic<Isa>& current()
+{
+	static std::atomic<Isa> isa { best_isa() };
+	return isa;
+}
+
+const Table& table()
+{
+	return *table_for( current().load( std::memory_order_relaxed ) );
+}
+
+}
+
+Isa best_isa()
+{
+#ifdef KERNELS_X86
+	if( avx2_table() && __builtin_cpu_supports( "avx2" ) )
+		return Isa::AVX2;
+
+	return Isa::SSE2;
+#else
+	return Isa::Scalar;
+#endif
+}
+
+Isa active_isa()
+{
+	return current().load( std::memory_order_relaxed );
+}
+
+void use_isa( Isa isa )
+{
+	current().store( isa <= best_isa() ? isa : best_isa(), std::memory_order_relaxed );
+}
+
+const char * isa_name( Isa isa )
+{
+	switch( isa ) {
+	case Isa::AVX2: return "avx2";
+	case Isa::SSE2: return "sse2";
+	default: return "scalar";
+	}
+}
+
+void sincos( const float * angles, float * sines, float * cosines, size_t count )
+{
+	table().sincos( angles, sines, cosines, count );
+}
+
+void sincos_steps( float first, float step, float * sines, float * cosines, size_t count )
+{
+	table().sincos_steps( first, step, sines, cosines, count );
+}
+
+void lake_noise( const float * t, float frequency, float amplitude, float * noise, size_t count )
+{
+	table().lake_noise( t, frequency, amplitude, noise, count );
+}
+
+void segment_normals( const float * x, const float * y, float * nx, float * ny, size_t count )
+{
+	table().segment_normals( x, y, nx, ny, count );
+}
+
+void miters( const float * nx, const float * ny, float * mx, float * my, float * length, size_t count )
+{
+	table().miters( nx, ny, mx, my, length, count );
+}
+
+}
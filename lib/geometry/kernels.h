@@ -0,0 +1,57 @@
+/*
+ * kernels.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+/*
+ * Batched maths for the geometry generators. Every kernel exists as a scalar, an SSE2 and an AVX2
+ * version; the widest one the processor supports is picked on first use. The versions do the same
+ * operations in the same order (and are built without FMA contraction), so they give bit identical
+ * results and a cached mesh does not depend on the machine that made it.
+ *
+ * Buffers are structure of arrays, the caller sizes them.
+ */
+namespace kernels {
+
+enum class Isa { Scalar, SSE2, AVX2 };
+
+Isa active_isa();
+Isa best_isa();						// the widest the processor supports
+void use_isa( Isa isa );			// for benchmarks, clamped to best_isa()
+const char * isa_name( Isa isa );
+
+// polynomial sin and cos, accurate to a few ulp for |angle| up to about 1e4
+void sincos( const float * angles, float * sines, float * cosines, size_t count );
+
+// angles first, first + step, ... as sines and cosines
+void sincos_steps( float first, float step, float * sines, float * cosines, size_t count );
+
+// the jagged radius of a lake: ( sin(t f 1.3) + sin(t f 0.7 + 2) + sin(t f 2.1 + 1.3) ) * 0.33 * amplitude
+void lake_noise( const float * t, float frequency, float amplitude, float * noise, size_t count );
+
+// unit normals (pointing left) of the count - 1 segments between count points, 0 for a zero length segment
+void segment_normals( const float * x, const float * y, float * nx, float * ny, size_t count );
+
+// the miter where segments i and i + 1 meet, for count normals: the offset that keeps half the width on both
+// sides and its length, 1 / cos of half the turn. A reversal gets a length of 0.
+void miters( const float * nx, const float * ny, float * mx, float * my, float * length, size_t count );
+
+}
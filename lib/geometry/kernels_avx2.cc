@@ -0,0 +1,82 @@
+/*
+ * kernels_avx2.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+/*
+ * Built with -mavx2 (see lib/CMakeLists.txt). Only reached after kernels.cc has checked that the
+ * processor has AVX2, so nothing here may be shared with the other translation units.
+ */
+
+#include "kernels_lanes.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace kernels {
+
+#ifdef __AVX2__
+
+namespace {
+
+struct Avx2Lane
+{
+	static constexpr size_t width = 8;
+	using Int = __m256i;
+	using Mask = __m256;
+
+	__m256 v;
+
+	static Avx2Lane load( const float * p ) { return { _mm256_loadu_ps( p ) }; }
+	static void store( float * p, Avx2Lane a ) { _mm256_storeu_ps( p, a.v ); }
+	static Avx2Lane set( float f ) { return { _mm256_set1_ps( f ) }; }
+	static Avx2Lane index( size_t i ) { return { _mm256_add_ps( _mm256_set1_ps( float( i ) ), _mm256_setr_ps( 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f ) ) }; }
+
+	friend Avx2Lane operator+( Avx2Lane a, Avx2Lane b ) { return { _mm256_add_ps( a.v, b.v ) }; }
+	friend Avx2Lane operator-( Avx2Lane a, Avx2Lane b ) { return { _mm256_sub_ps( a.v, b.v ) }; }
+	friend Avx2Lane operator*( Avx2Lane a, Avx2Lane b ) { return { _mm256_mul_ps( a.v, b.v ) }; }
+	friend Avx2Lane operator/( Avx2Lane a, Avx2Lane b ) { return { _mm256_div_ps( a.v, b.v ) }; }
+
+	static Avx2Lane sqrt( Avx2Lane a ) { return { _mm256_sqrt_ps( a.v ) }; }
+	static Int round_int( Avx2Lane a ) { return _mm256_cvtps_epi32( a.v ); }
+	static Avx2Lane to_float( Int q ) { return { _mm256_cvtepi32_ps( q ) }; }
+
+	static Mask bit_set( Int q, int32_t bit )
+	{
+		__m256i b = _mm256_set1_epi32( bit );
+		return _mm256_castsi256_ps( _mm256_cmpeq_epi32( _mm256_and_si256( q, b ), b ) );
+	}
+	static Mask mask_xor( Mask a, Mask b ) { return _mm256_xor_ps( a, b ); }
+	static Mask greater( Avx2Lane a, Avx2Lane b ) { return _mm256_cmp_ps( a.v, b.v, _CMP_GT_OQ ); }
+	static Avx2Lane select( Mask m, Avx2Lane a, Avx2Lane b ) { return { _mm256_blendv_ps( b.v, a.v, m ) }; }
+	static Avx2Lane negate_if( Mask m, Avx2Lane a ) { return { _mm256_xor_ps( a.v, _mm256_and_ps( m, _mm256_set1_ps( -0.0f ) ) ) }; }
+};
+
+constexpr Table avx2 = make_table<Avx2Lane>();
+
+}
+
+const Table * avx2_table() { return &avx2; }
+
+#else
+
+const Table * avx2_table() { return nullptr; }
+
+#endif
+
+}
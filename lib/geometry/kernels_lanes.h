@@ -0,0 +1,224 @@
+/*
+ * kernels_lanes.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+/*
+ * The kernels written once against a lane type and instantiated for float here, __m128 in kernels.cc
+ * and __m256 in kernels_avx2.cc. A lane type provides load/store/set/index, + - * /, sqrt, round_int,
+ * to_float, bit_set, mask_xor, greater, select and negate_if.
+ *
+ * Only for the kernel translation units. Everything but Table has internal linkage, so the copies
+ * built with -mavx2 can never be picked by the linker for the other translation units.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace kernels {
+
+struct Table
+{
+	void (*sincos)( const float *, float *, float *, size_t );
+	void (*sincos_steps)( float, float, float *, float *, size_t );
+	void (*lake_noise)( const float *, float, float, float *, size_t );
+	void (*segment_normals)( const float *, const float *, float *, float *, size_t );
+	void (*miters)( const float *, const float *, float *, float *, float *, size_t );
+};
+
+namespace {
+
+struct ScalarLane
+{
+	static constexpr size_t width = 1;
+	using Int = int32_t;
+	using Mask = bool;
+
+	float v;
+
+	static ScalarLane load( const float * p ) { return { *p }; }
+	static void store( float * p, ScalarLane a ) { *p = a.v; }
+	static ScalarLane set( float f ) { return { f }; }
+	static ScalarLane index( size_t i ) { return { float( i ) }; }
+
+	friend ScalarLane operator+( ScalarLane a, ScalarLane b ) { return { a.v + b.v }; }
+	friend ScalarLane operator-( ScalarLane a, ScalarLane b ) { return { a.v - b.v }; }
+	friend ScalarLane operator*( ScalarLane a, ScalarLane b ) { return { a.v * b.v }; }
+	friend ScalarLane operator/( ScalarLane a, ScalarLane b ) { return { a.v / b.v }; }
+
+	static ScalarLane sqrt( ScalarLane a ) { return { std::sqrt( a.v ) }; }
+	static Int round_int( ScalarLane a ) { return Int( std::nearbyint( a.v ) ); }		// to nearest even, like cvtps2dq
+	static ScalarLane to_float( Int q ) { return { float( q ) }; }
+
+	static Mask bit_set( Int q, Int bit ) { return ( q & bit ) != 0; }
+	static Mask mask_xor( Mask a, Mask b ) { return a != b; }
+	static Mask greater( ScalarLane a, ScalarLane b ) { return a.v > b.v; }
+	static ScalarLane select( Mask m, ScalarLane a, ScalarLane b ) { return m ? a : b; }
+	static ScalarLane negate_if( Mask m, ScalarLane a ) { return m ? ScalarLane { -a.v } : a; }
+};
+
+// Cody-Waite reduction by pi/2 in three parts, then minimax polynomials on [-pi/4, pi/4]
+template<typename L>
+inline void sincos( L x, L& s, L& c )
+{
+	auto q = L::round_int( x * L::set( 0.636619772367581343f ) );
+	L y = L::to_float( q );
+
+	L r = ( ( x - y * L::set( 1.5703125f ) ) - y * L::set( 4.837512969970703125e-4f ) ) - y * L::set( 7.54978995489188216e-8f );
+	L z = r * r;
+
+	L ps = ( ( L::set( -1.9515295891e-4f ) * z + L::set( 8.3321608736e-3f ) ) * z + L::set( -1.6666654611e-1f ) ) * z * r + r;
+	L pc = ( ( L::set( 2.443315711809948e-5f ) * z + L::set( -1.388731625493765e-3f ) ) * z + L::set( 4.166664568298827e-2f ) ) * z * z
+			- L::set( 0.5f ) * z + L::set( 1.0f );
+
+	// quadrant q: sin, cos = s, c | c, -s | -s, -c | -c, s
+	auto swap = L::bit_set( q, 1 );
+	auto sin_negative = L::bit_set( q, 2 );
+	auto cos_negative = L::mask_xor( swap, sin_negative );
+
+	s = L::negate_if( sin_negative, L::select( swap, pc, ps ) );
+	c = L::negate_if( cos_negative, L::select( swap, ps, pc ) );
+}
+
+template<typename L>
+inline L sin( L x )
+{
+	L s, c;
+	sincos( x, s, c );
+	return s;
+}
+
+// each kernel does outputs [begin, end), a multiple of the lane width apart
+
+template<typename L>
+void sincos( const float * angles, float * sines, float * cosines, size_t begin, size_t end )
+{
+	for( size_t i = begin; i < end; i += L::width ) {
+		L s, c;
+		sincos( L::load( angles + i ), s, c );
+		L::store( sines + i, s );
+		L::store( cosines + i, c );
+	}
+}
+
+template<typename L>
+void sincos_steps( float first, float step, float * sines, float * cosines, size_t begin, size_t end )
+{
+	for( size_t i = begin; i < end; i += L::width ) {
+		L s, c;
+		sincos( L::set( first ) + L::index( i ) * L::set( step ), s, c );
+		L::store( sines + i, s );
+		L::store( cosines + i, c );
+	}
+}
+
+template<typename L>
+void lake_noise( const float * t, float frequency, float amplitude, float * noise, size_t begin, size_t end )
+{
+	for( size_t i = begin; i < end; i += L::width ) {
+
+		L tf = L::load( t + i ) * L::set( frequency );
+
+		L v1 = sin( tf * L::set( 1.3f ) );
+		L v2 = sin( tf * L::set( 0.7f ) + L::set( 2.0f ) );
+		L v3 = sin( tf * L::set( 2.1f ) + L::set( 1.3f ) );
+
+		L::store( noise + i, ( v1 + v2 + v3 ) * L::set( 0.33f ) * L::set( amplitude ) );
+	}
+}
+
+template<typename L>
+void segment_normals( const float * x, const float * y, float * nx, float * ny, size_t begin, size_t end )
+{
+	for( size_t i = begin; i < end; i += L::width ) {
+
+		L dx = L::load( x + i + 1 ) - L::load( x + i );
+		L dy = L::load( y + i + 1 ) - L::load( y + i );
+
+		L length = L::sqrt( dx * dx + dy * dy );
+		L inverse = L::select( L::greater( length, L::set( 1e-6f ) ), L::set( 1.0f ) / length, L::set( 0.0f ) );
+
+		L::store( nx + i, L::set( 0.0f ) - dy * inverse );
+		L::store( ny + i, dx * inverse );
+	}
+}
+
+template<typename L>
+void miters( const float * nx, const float * ny, float * mx, float * my, float * length, size_t begin, size_t end )
+{
+	for( size_t i = begin; i < end; i += L::width ) {
+
+		L x = L::load( nx + i ) + L::load( nx + i + 1 );
+		L y = L::load( ny + i ) + L::load( ny + i + 1 );
+
+		L norm = L::sqrt( x * x + y * y );
+		auto valid = L::greater( norm, L::set( 1e-6f ) );
+
+		L ratio = L::select( valid, L::set( 2.0f ) / norm, L::set( 0.0f ) );
+		L scale = L::select( valid, ratio / norm, L::set( 0.0f ) );
+
+		L::store( mx + i, x * scale );
+		L::store( my + i, y * scale );
+		L::store( length + i, ratio );
+	}
+}
+
+// the lanes of L for whole blocks, the rest with the scalar lane
+template<typename L>
+constexpr Table make_table()
+{
+	return {
+		[]( const float * angles, float * sines, float * cosines, size_t count )
+		{
+			size_t main = count / L::width * L::width;
+			sincos<L>( angles, sines, cosines, 0, main );
+			sincos<ScalarLane>( angles, sines, cosines, main, count );
+		},
+		[]( float first, float step, float * sines, float * cosines, size_t count )
+		{
+			size_t main = count / L::width * L::width;
+			sincos_steps<L>( first, step, sines, cosines, 0, main );
+			sincos_steps<ScalarLane>( first, step, sines, cosines, main, count );
+		},
+		[]( const float * t, float frequency, float amplitude, float * noise, size_t count )
+		{
+			size_t main = count / L::width * L::width;
+			lake_noise<L>( t, frequency, amplitude, noise, 0, main );
+			lake_noise<ScalarLane>( t, frequency, amplitude, noise, main, count );
+		},
+		[]( const float * x, const float * y, float * nx, float * ny, size_t count )
+		{
+			size_t outputs = count > 0 ? count - 1 : 0;
+			size_t main = outputs / L::width * L::width;
+			segment_normals<L>( x, y, nx, ny, 0, main );
+			segment_normals<ScalarLane>( x, y, nx, ny, main, outputs );
+		},
+		[]( const float * nx, const float * ny, float * mx, float * my, float * length, size_t count )
+		{
+			size_t outputs = count > 0 ? count - 1 : 0;
+			size_t main = outputs / L::width * L::width;
+			miters<L>( nx, ny, mx, my, length, 0, main );
+			miters<ScalarLane>( nx, ny, mx, my, length, main, outputs );
+		}
+	};
+}
+
+}
+}
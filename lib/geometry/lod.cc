@@ -0,0 +1,61 @@
+/*
+ * lod.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "lod.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/gtc/constants.hpp>
+
+namespace lod {
+
+int level_count( int segments )
+{
+	int count = 1;
+
+	while( ( segments >> count ) >= min_segments )
+		++count;
+
+	return count;
+}
+
+int level_segments( int segments, int level )
+{
+	return segments >> level;
+}
+
+int select_level( int segments, int current, float radius_pixels )
+{
+	// a chord over angle a is off the circle by r (1 - cos(a/2)), about r a^2 / 8
+	float needed = glm::pi<float>() * std::sqrt( std::max( radius_pixels, 0.0f ) / ( 2.0f * pixel_tolerance ) );
+
+	int levels = level_count( segments );
+	int level = std::clamp( current, 0, levels - 1 );
+
+	while( level > 0 && level_segments( segments, level ) < needed )
+		--level;
+
+	while( level + 1 < levels && level_segments( segments, level + 1 ) >= 1.5f * needed )
+		++level;
+
+	return level;
+}
+
+}
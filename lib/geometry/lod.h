@@ -0,0 +1,39 @@
+/*
+ * lod.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+/*
+ * Levels of detail for round procedural shapes. Level 0 has the segments the shape was given, every
+ * next level half of them, down to min_segments. The level is chosen from the radius the shape has
+ * on screen so the outline stays within pixel_tolerance of the true curve.
+ */
+namespace lod {
+
+constexpr int min_segments = 8;
+constexpr float pixel_tolerance = 0.25f;
+
+int level_count( int segments );
+int level_segments( int segments, int level );
+
+// the level for a shape with the given radius in pixels. A coarser level is only taken once it has
+// half as many segments again as needed, so a shape at the edge of a level does not flip between two.
+int select_level( int segments, int current, float radius_pixels );
+
+}
@@ -0,0 +1,116 @@
+/*
+ * racing_line.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include "racing_line.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "track_index.h"
+
+void RacingLine::build( const TrackIndex& index )
+{
+	points.clear();
+	speeds.clear();
+
+	float length = index.length();
+	size_t n = size_t( length / spacing );
+
+	if( !index.is_closed() || n < 3 )
+		return;
+
+	step = length / n;
+
+	// each sample moved to where it bends the line least given two neighbours either side, held
+	// within the track. Sweeps only carry a change a few samples along, so the line is first found
+	// on a coarse sampling and refined from there, halving the spacing each time
+	const int levels = 6, sweeps = 100;
+	float limit = std::max( index.width() * 0.5f - margin, 0.0f );
+
+	std::vector<glm::vec2> centre, normal;
+	std::vector<float> offset, coarse;
+
+	for( int level = levels - 1; level >= 0; --level ) {
+
+		// a short track is only worked at the full sampling
+		size_t count = n >> level;
+		if( count < 8 && level > 0 )
+			continue;
+
+		centre.resize( count );
+		normal.resize( count );
+		points.resize( count );
+		offset.assign( count, 0.0f );
+
+		for( size_t i = 0; i < count; ++i )
+			centre[i] = index.point_at( length * i / count );
+
+		for( size_t i = 0; i < count; ++i ) {
+			glm::vec2 along = centre[ ( i + 1 ) % count ] - centre[ ( i + count - 1 ) % count ];
+			normal[i] = glm::normalize( glm::vec2( -along.y, along.x ) );
+		}
+
+		for( size_t i = 0; !coarse.empty() && i < count; ++i ) {
+			float f = float( i ) * coarse.size() / count;
+			size_t j = size_t( f );
+			offset[i] = glm::mix( coarse[ j % coarse.size() ], coarse[ ( j + 1 ) % coarse.size() ], f - j );
+		}
+
+		for( size_t i = 0; i < count; ++i )
+			points[i] = centre[i] + normal[i] * offset[i];
+
+		for( int sweep = 0; sweep < sweeps; ++sweep )
+			for( size_t i = 0; i < count; ++i ) {
+				glm::vec2 near = points[ ( i + count - 1 ) % count ] + points[ ( i + 1 ) % count ];
+				glm::vec2 far = points[ ( i + count - 2 ) % count ] + points[ ( i + 2 ) % count ];
+				glm::vec2 middle = ( near * 4.0f - far ) / 6.0f;
+
+				offset[i] = std::clamp( glm::dot( middle - centre[i], normal[i] ), -limit, limit );
+				points[i] = centre[i] + normal[i] * offset[i];
+			}
+
+		coarse = offset;
+	}
+
+	// v^2 = a / curvature in the corners, then back from each corner by v^2 = u^2 + 2 a d. Twice
+	// round, so braking for the first corner starts on the last straight
+	const float straight = 1e4f;
+
+	speeds.resize( n );
+	for( size_t i = 0; i < n; ++i ) {
+		glm::vec2 a = points[ ( i + n - 1 ) % n ], b = points[i], c = points[ ( i + 1 ) % n ];
+
+		float sides = glm::length( b - a ) * glm::length( c - b ) * glm::length( c - a );
+		glm::vec2 u = b - a, v = c - b;
+		float curvature = sides > 0.0f ? 2.0f * std::abs( u.x * v.y - u.y * v.x ) / sides : 0.0f;
+
+		speeds[i] = curvature > 1.0f / straight ? 1.0f / curvature : straight;
+	}
+
+	for( size_t k = 2 * n; k-- > 0; ) {
+		size_t i = k % n, next = ( i + 1 ) % n;
+		speeds[i] = std::min( speeds[i], speeds[next] + 2.0f * glm::distance( points[i], points[next] ) );
+	}
+}
+
+size_t RacingLine::at( float arc_length ) const
+{
+	return size_t( std::max( arc_length, 0.0f ) / step + 0.5f ) % points.size();
+}
@@ -0,0 +1,58 @@
+/*
+ * racing_line.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class TrackIndex;
+
+/*
+ * The line a driver takes round a closed track: the centreline sampled at even steps, each sample
+ * pushed across the track to straighten the line through the corners as far as the width allows.
+ * Every sample carries the speed a car can carry there, corner limits brought forward by braking,
+ * for a car that turns and brakes at one m/s^2. A car with grip a reaches sqrt( a * speed_squared ).
+ */
+class RacingLine
+{
+public:
+	static constexpr float spacing = 2.0f;		// m between samples, about
+	static constexpr float margin = 1.5f;		// m kept from the edge of the track
+
+	void build( const TrackIndex& index );
+
+	bool empty() const { return points.empty(); }
+	size_t size() const { return points.size(); }
+
+	// the sample next to a point of the centreline that far along it
+	size_t at( float arc_length ) const;
+	size_t ahead( size_t sample, float distance ) const { return ( sample + size_t( distance / step ) ) % points.size(); }
+
+	glm::vec2 point( size_t sample ) const { return points[sample]; }
+	float speed_squared( size_t sample ) const { return speeds[sample]; }
+
+private:
+	std::vector<glm::vec2> points;
+	std::vector<float> speeds;
+	float step = spacing;
+};
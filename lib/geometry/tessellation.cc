@@ -0,0 +1,319 @@
+/*
+ * tessellation.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "tessellation.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/gtc/constants.hpp>
+
+#include "../components/mesh_component.h"
+
+#include "kernels.h"
+
+namespace {
+
+constexpr int max_depth = 12;				// a span is never cut in more than 4096 pieces
+
+struct Span
+{
+	glm::vec2 p[4];
+	float t[4];
+
+	Span( glm::vec2 p0, glm::vec2 p1, glm::vec2 p2, glm::vec2 p3 ) : p { p0, p1, p2, p3 }
+	{
+		// centripetal: knots are spaced by the square root of the distance, which keeps cusps and loops out of the spans
+		t[0] = 0.0f;
+		for( int i = 1; i < 4; ++i )
+			t[i] = t[i-1] + std::max( std::sqrt( glm::distance( p[i-1], p[i] ) ), 1e-4f );
+	}
+
+	glm::vec2 at( float u ) const		// u runs from 0 at p1 to 1 at p2
+	{
+		float s = t[1] + ( t[2] - t[1] ) * u;
+
+		glm::vec2 a1 = p[0] * ( ( t[1] - s ) / ( t[1] - t[0] ) ) + p[1] * ( ( s - t[0] ) / ( t[1] - t[0] ) );
+		glm::vec2 a2 = p[1] * ( ( t[2] - s ) / ( t[2] - t[1] ) ) + p[2] * ( ( s - t[1] ) / ( t[2] - t[1] ) );
+		glm::vec2 a3 = p[2] * ( ( t[3] - s ) / ( t[3] - t[2] ) ) + p[3] * ( ( s - t[2] ) / ( t[3] - t[2] ) );
+
+		glm::vec2 b1 = a1 * ( ( t[2] - s ) / ( t[2] - t[0] ) ) + a2 * ( ( s - t[0] ) / ( t[2] - t[0] ) );
+		glm::vec2 b2 = a2 * ( ( t[3] - s ) / ( t[3] - t[1] ) ) + a3 * ( ( s - t[1] ) / ( t[3] - t[1] ) );
+
+		return b1 * ( ( t[2] - s ) / ( t[2] - t[1] ) ) + b2 * ( ( s - t[1] ) / ( t[2] - t[1] ) );
+	}
+};
+
+float distance_to_segment( glm::vec2 p, glm::vec2 a, glm::vec2 b )
+{
+	glm::vec2 ab = b - a;
+	float length2 = glm::dot( ab, ab );
+	float u = length2 > 0.0f ? glm::clamp( glm::dot( p - a, ab ) / length2, 0.0f, 1.0f ) : 0.0f;
+
+	return glm::distance( p, a + ab * u );
+}
+
+// appends the samples of (u0, u1], the quarter points are tested as well so an S bend is not taken for a straight
+void subdivide( const Span& span, float u0, glm::vec2 p0, float u1, glm::vec2 p1, float tolerance, int depth, std::vector<glm::vec2>& out )
+{
+	float um = 0.5f * ( u0 + u1 );
+	glm::vec2 pm = span.at( um );
+
+	bool flat = depth >= max_depth ||
+		( distance_to_segment( pm, p0, p1 ) <= tolerance &&
+		  distance_to_segment( span.at( 0.5f * ( u0 + um ) ), p0, p1 ) <= tolerance &&
+		  distance_to_segment( span.at( 0.5f * ( um + u1 ) ), p0, p1 ) <= tolerance );
+
+	if( flat ) {
+		out.push_back( p1 );
+		return;
+	}
+
+	subdivide( span, u0, p0, um, pm, tolerance, depth + 1, out );
+	subdivide( span, um, pm, u1, p1, tolerance, depth + 1, out );
+}
+
+// greedy: extend the chord from the last kept sample as long as every sample it skips stays within tolerance.
+// Each skipped sample narrows the cone of directions the chord may take, which keeps this linear.
+std::vector<glm::vec2> merge_straights( const std::vector<glm::vec2>& samples, float tolerance )
+{
+	if( samples.size() < 3 )
+		return samples;
+
+	std::vector<glm::vec2> kept;
+	kept.push_back( samples[0] );
+
+	size_t anchor = 0;
+
+	while( anchor + 1 < samples.size() ) {
+
+		glm::vec2 origin = samples[anchor];
+		glm::vec2 base = samples[anchor + 1] - origin;
+
+		float low = -glm::pi<float>(), high = glm::pi<float>();
+		size_t end = anchor + 1;
+
+		for( size_t i = anchor + 1; i < samples.size(); ++i ) {
+
+			glm::vec2 v = samples[i] - origin;
+			float angle = std::atan2( base.x * v.y - base.y * v.x, glm::dot( base, v ) );
+
+			if( angle < low || angle > high )
+				break;
+
+			end = i;
+
+			float length = glm::length( v );
+			if( length > tolerance ) {
+				float spread = std::asin( tolerance / length );
+				low = std::max( low, angle - spread );
+				high = std::min( high, angle + spread );
+			}
+		}
+
+		kept.push_back( samples[end] );
+		anchor = end;
+	}
+
+	return kept;
+}
+
+}
+
+std::vector<glm::vec2> tessellate_spans( const std::vector<glm::vec2>& points, bool closed, size_t first, size_t last, float tolerance )
+{
+	long n = long( points.size() );
+
+	auto point = [&]( long i ) -> glm::vec2
+	{
+		if( closed )
+			return points[ ( i % n + n ) % n ];
+
+		if( i < 0 )			// open ends are extended by mirroring their neighbour
+			return 2.0f * points[0] - points[1];
+		if( i >= n )
+			return 2.0f * points[n-1] - points[n-2];
+
+		return points[i];
+	};
+
+	tolerance = std::max( tolerance, 1e-5f );
+
+	std::vector<glm::vec2> samples;
+	samples.push_back( point( long(first) ) );
+
+	for( long i = long(first); i < long(last); ++i ) {
+		Span span( point( i - 1 ), point( i ), point( i + 1 ), point( i + 2 ) );
+		subdivide( span, 0.0f, point( i ), 1.0f, point( i + 1 ), tolerance, 0, samples );
+	}
+
+	return merge_straights( samples, tolerance );
+}
+
+std::vector<glm::vec2> tessellate_spline( const std::vector<glm::vec2>& input, bool closed, float tolerance )
+{
+	std::vector<glm::vec2> points;
+	points.reserve( input.size() );
+
+	for( auto& p : input )		// repeated points would make a zero length span
+		if( points.empty() || glm::distance( points.back(), p ) > 1e-6f )
+			points.push_back( p );
+
+	if( closed && points.size() > 1 && glm::distance( points.front(), points.back() ) <= 1e-6f )
+		points.pop_back();
+
+	if( points.size() < 3 )
+		return points;
+
+	auto samples = tessellate_spans( points, closed, 0, closed ? points.size() : points.size() - 1, tolerance );
+
+	if( closed )
+		samples.pop_back();		// back where it started
+
+	return samples;
+}
+
+RibbonJoin add_ribbon_join( glm::vec2 previous, glm::vec2 p, glm::vec2 next, float half_width, glm::vec3 colour, float miter_limit, MeshData& mesh )
+{
+	auto add_vertex = [&]( glm::vec2 v ) -> uint32_t
+	{
+		mesh.vertices.push_back( glm::vec3( v, 0.0f ) );
+		mesh.colours.push_back( colour );
+		return uint32_t( mesh.vertices.size() - 1 );
+	};
+
+	auto direction = []( glm::vec2 from, glm::vec2 to )
+	{
+		float length = glm::distance( from, to );
+		return length > 1e-6f ? ( to - from ) / length : glm::vec2( 0.0f );
+	};
+
+	glm::vec2 d0 = direction( previous, p );
+	glm::vec2 d1 = direction( p, next );
+
+	if( d0 == glm::vec2( 0.0f ) )		// the ends of an open line, or a repeated point
+		d0 = d1;
+	if( d1 == glm::vec2( 0.0f ) )
+		d1 = d0;
+
+	glm::vec2 n0( -d0.y, d0.x );
+	glm::vec2 n1( -d1.y, d1.x );
+
+	glm::vec2 miter = n0 + n1;
+	float miter_length = glm::length( miter );
+	float ratio = miter_length > 1e-6f ? 2.0f / miter_length : 0.0f;		// 1 / cos of half the turn
+
+	if( miter_length > 1e-6f && ratio <= miter_limit ) {
+		miter *= ratio / miter_length;			// reaches half_width from both edges
+		uint32_t pair = add_vertex( p + miter * half_width );
+		add_vertex( p - miter * half_width );
+		return { pair, pair };
+	}
+
+	uint32_t in = add_vertex( p + n0 * half_width );
+	add_vertex( p - n0 * half_width );
+	uint32_t out = add_vertex( p + n1 * half_width );
+	add_vertex( p - n1 * half_width );
+	uint32_t centre = add_vertex( p );
+
+	// the bevel fills the wedge on the outside of the turn, the inside is covered by the overlapping quads
+	bool left_turn = ( n0.x * n1.y - n0.y * n1.x ) > 0.0f;
+	uint32_t side = left_turn ? 1 : 0;
+
+	mesh.indices.insert( mesh.indices.end(), { centre, in + side, out + side } );
+
+	return { in, out };
+}
+
+void add_ribbon_quad( RibbonJoin from, RibbonJoin to, MeshData& mesh )
+{
+	// each pair of vertices is a left and right vertex of the track, thus two pairs create a quad, which is two triangles
+	uint32_t a = from.out;
+	uint32_t b = to.in;
+
+	mesh.indices.insert( mesh.indices.end(), { a, a + 1, b + 1 } );
+	mesh.indices.insert( mesh.indices.end(), { a, b, b + 1 } );
+}
+
+void extrude_ribbon( const std::vector<glm::vec2>& line, bool closed, float width, glm::vec3 colour, float miter_limit, MeshData& mesh )
+{
+	size_t n = line.size();
+
+	if( n < 2 )
+		return;
+
+	// the points as columns, closed lines repeat the first point so the last segment gets a normal too
+	size_t columns = closed ? n + 1 : n;
+	std::vector<float> x( columns ), y( columns );
+
+	for( size_t i = 0; i < columns; ++i ) {
+		x[i] = line[ i % n ].x;
+		y[i] = line[ i % n ].y;
+	}
+
+	// normal i + 1 is segment i, so point i sits between normals i and i + 1. The ends of an open line
+	// copy their only neighbour, the start of a closed line wraps around.
+	std::vector<float> nx( n + 1 ), ny( n + 1 );
+	kernels::segment_normals( x.data(), y.data(), nx.data() + 1, ny.data() + 1, columns );
+
+	nx[0] = closed ? nx[n] : nx[1];
+	ny[0] = closed ? ny[n] : ny[1];
+	if( !closed ) {
+		nx[n] = nx[n-1];
+		ny[n] = ny[n-1];
+	}
+
+	std::vector<float> mx( n ), my( n ), ratio( n );
+	kernels::miters( nx.data(), ny.data(), mx.data(), my.data(), ratio.data(), n + 1 );
+
+	size_t segments = closed ? n : n - 1;
+
+	mesh.vertices.reserve( mesh.vertices.size() + 2 * n );
+	mesh.colours.reserve( mesh.colours.size() + 2 * n );
+	mesh.indices.reserve( mesh.indices.size() + 6 * segments );
+
+	float half_width = width * 0.5f;
+	std::vector<RibbonJoin> joins( n );
+
+	for( size_t i = 0; i < n; ++i ) {
+
+		bool degenerate = ( nx[i] == 0.0f && ny[i] == 0.0f ) || ( nx[i+1] == 0.0f && ny[i+1] == 0.0f );
+
+		if( degenerate || ratio[i] == 0.0f || ratio[i] > miter_limit ) {		// repeated points and bevels
+
+			glm::vec2 previous = i > 0 ? line[i-1] : ( closed ? line[n-1] : line[i] );
+			glm::vec2 next = i + 1 < n ? line[i+1] : ( closed ? line[0] : line[i] );
+
+			joins[i] = add_ribbon_join( previous, line[i], next, half_width, colour, miter_limit, mesh );
+			continue;
+		}
+
+		glm::vec2 offset( mx[i] * half_width, my[i] * half_width );
+
+		uint32_t pair = uint32_t( mesh.vertices.size() );
+		mesh.vertices.push_back( glm::vec3( line[i] + offset, 0.0f ) );
+		mesh.vertices.push_back( glm::vec3( line[i] - offset, 0.0f ) );
+		mesh.colours.insert( mesh.colours.end(), 2, colour );
+
+		joins[i] = { pair, pair };
+	}
+
+	for( size_t i = 0; i < segments; ++i )
+		add_ribbon_quad( joins[i], joins[ ( i + 1 ) % n ], mesh );
+}
@@ -0,0 +1,59 @@
+/*
+ * tessellation.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+struct MeshData;
+
+/*
+ * Samples the centripetal Catmull-Rom spline through the points. Every span is subdivided until it
+ * is within tolerance of its chords, after which runs of samples that lie within tolerance of a
+ * straight line are merged again, so the number of samples follows the curvature of the line and
+ * not the number of points it was given with. A closed line does not repeat its first sample.
+ */
+std::vector<glm::vec2> tessellate_spline( const std::vector<glm::vec2>& points, bool closed, float tolerance );
+
+/*
+ * The samples of spans [first, last) of the same spline, span i running from points[i] to points[i+1].
+ * Ends with the end point of the last span; straights are only merged within the spans asked for.
+ */
+std::vector<glm::vec2> tessellate_spans( const std::vector<glm::vec2>& points, bool closed, size_t first, size_t last, float tolerance );
+
+/*
+ * Appends a ribbon of the given width along the line to the mesh as indexed triangles. Corners get
+ * a miter join, unless the miter would be longer than miter_limit times the half width, then they
+ * are bevelled.
+ */
+void extrude_ribbon( const std::vector<glm::vec2>& line, bool closed, float width, glm::vec3 colour, float miter_limit, MeshData& mesh );
+
+// The vertex pairs where the ribbon's quads meet at p: the pair ending the incoming quad and the one starting the
+// outgoing quad, which are the same pair for a miter join. A previous or next point equal to p ends the ribbon.
+struct RibbonJoin
+{
+	uint32_t in;
+	uint32_t out;
+};
+
+RibbonJoin add_ribbon_join( glm::vec2 previous, glm::vec2 p, glm::vec2 next, float half_width, glm::vec3 colour, float miter_limit, MeshData& mesh );
+void add_ribbon_quad( RibbonJoin from, RibbonJoin to, MeshData& mesh );
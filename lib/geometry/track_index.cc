@@ -0,0 +1,282 @@
+/*
+ * track_index.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "track_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "../core/parallel.h"
+
+void TrackIndex::build( const std::vector<glm::vec2>& line, bool closed, float width )
+{
+	starts.clear();
+	directions.clear();
+	lengths.clear();
+	arc.clear();
+	cell_first.clear();
+	cell_segments.clear();
+
+	half_width = width * 0.5f;
+	this->closed = closed;
+
+	size_t n = line.size();
+	size_t segments = n < 2 ? 0 : ( closed ? n : n - 1 );
+
+	if( segments == 0 )
+		return;
+
+	glm::vec2 low = line[0], high = line[0];
+	float total = 0.0f;
+
+	for( size_t i = 0; i < segments; ++i ) {
+
+		glm::vec2 a = line[i], b = line[ ( i + 1 ) % n ];
+
+		starts.push_back( a );
+		directions.push_back( b - a );
+		lengths.push_back( glm::distance( a, b ) );
+		arc.push_back( total );
+
+		total += lengths.back();
+		low = glm::min( low, glm::min( a, b ) );
+		high = glm::max( high, glm::max( a, b ) );
+	}
+
+	// a few segments per cell along the track, with the empty cells around it limited to a multiple of
+	// the segments
+	glm::vec2 extent = high - low;
+	float average = total / segments;
+	float bounded = std::sqrt( ( extent.x + average ) * ( extent.y + average ) / ( 4.0f * float( segments ) ) );
+
+	cell_size = std::max( { 4.0f * average, bounded, 1e-3f } );
+	origin = low;
+	columns = int( extent.x / cell_size ) + 1;
+	rows = int( extent.y / cell_size ) + 1;
+
+	// every cell a segment crosses, found column by column from the part of the segment in that column.
+	// Cells it only grazes are taken too, so rounding can not lose one.
+	const float slack = 1e-4f;
+
+	auto for_each_cell = [&]( size_t segment, auto&& fn )
+	{
+		glm::vec2 a = ( starts[segment] - origin ) / cell_size;
+		glm::vec2 b = a + directions[segment] / cell_size;
+
+		if( a.x > b.x )
+			std::swap( a, b );
+
+		int first_column = std::clamp( int( std::floor( a.x - slack ) ), 0, columns - 1 );
+		int last_column = std::clamp( int( std::floor( b.x + slack ) ), 0, columns - 1 );
+
+		for( int column = first_column; column <= last_column; ++column ) {
+
+			float x0 = std::clamp( float( column ), a.x, b.x ), x1 = std::clamp( float( column + 1 ), a.x, b.x );
+			float y0 = a.y, y1 = b.y;
+
+			if( b.x > a.x ) {
+				y0 = a.y + ( b.y - a.y ) * ( x0 - a.x ) / ( b.x - a.x );
+				y1 = a.y + ( b.y - a.y ) * ( x1 - a.x ) / ( b.x - a.x );
+			}
+
+			int first_row = std::clamp( int( std::floor( std::min( y0, y1 ) - slack ) ), 0, rows - 1 );
+			int last_row = std::clamp( int( std::floor( std::max( y0, y1 ) + slack ) ), 0, rows - 1 );
+
+			for( int row = first_row; row <= last_row; ++row )
+				fn( size_t( row ) * columns + column );
+		}
+	};
+
+	cell_first.assign( size_t( columns ) * rows + 1, 0 );
+
+	for( size_t i = 0; i < segments; ++i )
+		for_each_cell( i, [&]( size_t cell ) { ++cell_first[ cell + 1 ]; } );
+
+	for( size_t i = 1; i < cell_first.size(); ++i )
+		cell_first[i] += cell_first[ i - 1 ];
+
+	cell_segments.resize( cell_first.back() );
+	std::vector<uint32_t> fill( cell_first.begin(), cell_first.end() - 1 );
+
+	for( size_t i = 0; i < segments; ++i )
+		for_each_cell( i, [&]( size_t cell ) { cell_segments[ fill[cell]++ ] = uint32_t( i ); } );
+}
+
+void TrackIndex::consider( size_t segment, glm::vec2 position, TrackQuery& best, float& best_squared ) const
+{
+	glm::vec2 d = directions[segment];
+	float length_squared = glm::dot( d, d );
+	float t = length_squared > 0.0f ? std::clamp( glm::dot( position - starts[segment], d ) / length_squared, 0.0f, 1.0f ) : 0.0f;
+
+	glm::vec2 closest = starts[segment] + d * t;
+	glm::vec2 offset = position - closest;
+	float squared = glm::dot( offset, offset );
+
+	// the lowest segment wins a tie, so the grid and the scan agree where segments meet
+	if( squared < best_squared || ( squared == best_squared && segment < best.segment ) ) {
+		best_squared = squared;
+		best.closest = closest;
+		best.segment = segment;
+		best.arc_length = arc[segment] + lengths[segment] * t;
+	}
+}
+
+TrackQuery TrackIndex::finish( TrackQuery best, float best_squared ) const
+{
+	best.distance = std::sqrt( best_squared );
+	best.on_surface = best.distance <= half_width;
+	return best;
+}
+
+TrackQuery TrackIndex::query( glm::vec2 position ) const
+{
+	TrackQuery best;
+	float best_squared = std::numeric_limits<float>::max();
+
+	if( empty() )
+		return best;
+
+	glm::vec2 local = ( position - origin ) / cell_size;
+	int column = std::clamp( int( std::floor( local.x ) ), 0, columns - 1 );
+	int row = std::clamp( int( std::floor( local.y ) ), 0, rows - 1 );
+
+	// how far the point is inside its own cell, 0 when it is outside the grid
+	glm::vec2 inside = local - glm::vec2( column, row );
+	float margin = std::max( 0.0f, std::min( { inside.x, inside.y, 1.0f - inside.x, 1.0f - inside.y } ) ) * cell_size;
+
+	int rings = std::max( columns, rows );
+
+	for( int ring = 0; ring <= rings; ++ring ) {
+
+		// nothing in this ring or beyond can be nearer than this
+		if( ring > 0 ) {
+			float bound = margin + ( ring - 1 ) * cell_size;
+			if( bound * bound > best_squared )
+				break;
+		}
+
+		for( int r = row - ring; r <= row + ring; ++r ) {
+
+			if( r < 0 || r >= rows )
+				continue;
+
+			bool edge_row = ( r == row - ring || r == row + ring );
+			int step = edge_row ? 1 : 2 * ring;
+
+			for( int c = column - ring; c <= column + ring; c += std::max( step, 1 ) ) {
+
+				if( c < 0 || c >= columns )
+					continue;
+
+				size_t cell = size_t( r ) * columns + c;
+				for( uint32_t i = cell_first[cell]; i < cell_first[ cell + 1 ]; ++i )
+					consider( cell_segments[i], position, best, best_squared );
+			}
+		}
+	}
+
+	return finish( best, best_squared );
+}
+
+glm::vec2 TrackIndex::point_at( float arc_length ) const
+{
+	if( empty() )
+		return glm::vec2( 0.0f );
+
+	size_t segment = std::upper_bound( arc.begin(), arc.end(), arc_length ) - arc.begin();
+	segment = segment == 0 ? 0 : segment - 1;
+
+	float t = lengths[segment] > 0.0f ? std::clamp( ( arc_length - arc[segment] ) / lengths[segment], 0.0f, 1.0f ) : 0.0f;
+
+	return starts[segment] + directions[segment] * t;
+}
+
+TrackQuery TrackIndex::query_from( glm::vec2 position, size_t segment ) const
+{
+	TrackQuery best;
+	float best_squared = std::numeric_limits<float>::max();
+
+	if( empty() )
+		return best;
+
+	size_t n = starts.size();
+	segment = std::min( segment, n - 1 );
+	consider( segment, position, best, best_squared );
+
+	for( bool forward : { true, false } ) {
+
+		size_t at = segment;
+
+		for( size_t steps = 1; steps < n; ++steps ) {
+
+			if( !closed && ( forward ? at + 1 == n : at == 0 ) )
+				break;
+
+			size_t next = forward ? ( at + 1 ) % n : ( at + n - 1 ) % n;
+			float before = best_squared;
+
+			consider( next, position, best, best_squared );
+			if( !( best_squared < before ) )
+				break;
+
+			at = next;
+		}
+	}
+
+	// a walk that ends further off than a cell may have stopped on the wrong stretch of track
+	float reach = half_width + cell_size;
+	if( best_squared > reach * reach )
+		return query( position );
+
+	return finish( best, best_squared );
+}
+
+void TrackIndex::query( const glm::vec2 * positions, TrackQuery * results, size_t count, WorkerPool * pool ) const
+{
+	constexpr size_t block = 256;			// enough work per block to be worth handing to a thread
+	constexpr size_t spawn_worth = 8192;	// queries it takes to pay for starting threads
+
+	auto run = [&]( size_t b )
+	{
+		for( size_t i = b * block; i < std::min( count, ( b + 1 ) * block ); ++i )
+			results[i] = query( positions[i] );
+	};
+
+	size_t blocks = ( count + block - 1 ) / block;
+
+	if( pool )
+		pool->run( blocks, run );
+	else if( count >= spawn_worth )
+		parallel_for( blocks, run );
+	else
+		for( size_t b = 0; b < blocks; ++b )
+			run( b );
+}
+
+TrackQuery TrackIndex::query_linear( glm::vec2 position ) const
+{
+	TrackQuery best;
+	float best_squared = std::numeric_limits<float>::max();
+
+	for( size_t i = 0; i < starts.size(); ++i )
+		consider( i, position, best, best_squared );
+
+	return finish( best, best_squared );
+}
@@ -0,0 +1,91 @@
+/*
+ * track_index.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+struct TrackQuery
+{
+	glm::vec2 closest;			// nearest point on the centreline
+	size_t segment = 0;			// of the tessellated centreline, segment i runs from sample i to i + 1
+	float distance = 0.0f;		// to the centreline
+	float arc_length = 0.0f;	// along the centreline up to the closest point
+	bool on_surface = false;	// within half the track width
+};
+
+/*
+ * A uniform grid over the segments of a tessellated centreline for the questions cars ask every
+ * tick. Each cell lists the segments passing through it; a query searches rings of cells around
+ * the point until no unsearched cell can be closer than the best segment found, so it costs about
+ * the same whatever the length of the track.
+ */
+class WorkerPool;
+
+class TrackIndex
+{
+public:
+	void build( const std::vector<glm::vec2>& line, bool closed, float width );
+
+	bool empty() const { return starts.empty(); }
+	bool is_closed() const { return closed; }
+	size_t segment_count() const { return starts.size(); }
+	float length() const { return arc.empty() ? 0.0f : arc.back() + lengths.back(); }
+	float width() const { return half_width * 2.0f; }
+
+	// the point of the centreline that far along it, clamped to its ends
+	glm::vec2 point_at( float arc_length ) const;
+
+	TrackQuery query( glm::vec2 position ) const;
+
+	// for a car that was on the given segment a moment ago: walks along the centreline from there
+	// while the segments come nearer, and only searches the grid when that ends far from the track
+	TrackQuery query_from( glm::vec2 position, size_t segment ) const;
+
+	// many cars at once, spread over the pool's threads when there are enough of them. Without a
+	// pool only batches large enough to pay for starting threads are spread
+	void query( const glm::vec2 * positions, TrackQuery * results, size_t count, WorkerPool * pool = nullptr ) const;
+
+	// the plain scan over every segment the grid replaces, for checking and benchmarks
+	TrackQuery query_linear( glm::vec2 position ) const;
+
+private:
+	std::vector<glm::vec2> starts;		// per segment
+	std::vector<glm::vec2> directions;
+	std::vector<float> lengths;
+	std::vector<float> arc;				// arc length at the start of each segment
+
+	float half_width = 0.0f;
+	bool closed = false;
+
+	glm::vec2 origin = glm::vec2( 0.0f );
+	float cell_size = 1.0f;
+	int columns = 0;
+	int rows = 0;
+
+	std::vector<uint32_t> cell_first;		// columns * rows + 1 offsets into cell_segments
+	std::vector<uint32_t> cell_segments;
+
+	void consider( size_t segment, glm::vec2 position, TrackQuery& best, float& best_squared ) const;
+	TrackQuery finish( TrackQuery best, float best_squared ) const;
+};
@@ -0,0 +1,248 @@
+/*
+ * track_mesh.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "track_mesh.h"
+
+#include <algorithm>
+#include <set>
+
+#include "../components/mesh_component.h"
+#include "../components/track_component.h"
+
+void TrackMesh::build( const TrackComponent &track, float tolerance, float miter_limit, MeshData &mesh )
+{
+	points = track.centreline.size();
+	closed = track.closed && points > 2;
+	width = track.width;
+	colour = track.colour;
+	this->tolerance = tolerance;
+	this->miter_limit = miter_limit;
+
+	segments.clear();
+	mesh.vertices.clear();
+	mesh.colours.clear();
+	mesh.indices.clear();
+	mesh.patches.clear();
+	++mesh.version;
+
+	if( points < 2 )
+		return;
+
+	segments.resize( ( span_count() + spans_per_segment - 1 ) / spans_per_segment );
+
+	for( size_t s = 0; s < segments.size(); ++s )
+		sample( track.centreline, s );
+
+	// a slot gets half as much again as it needs now, so that edits rarely outgrow it
+	uint32_t vertex_first = 0, index_first = 0;
+
+	for( size_t s = 0; s < segments.size(); ++s ) {
+
+		MeshData scratch;
+		extrude( s, scratch );
+
+		auto& segment = segments[s];
+
+		segment.vertex_first = vertex_first;
+		segment.vertex_capacity = uint32_t( scratch.vertices.size() * 3 / 2 + 8 );
+		segment.index_first = index_first;
+		segment.index_capacity = uint32_t( ( scratch.indices.size() / 3 * 3 / 2 + 4 ) * 3 );
+
+		vertex_first += segment.vertex_capacity;
+		index_first += segment.index_capacity;
+	}
+
+	mesh.vertices.resize( vertex_first );
+	mesh.colours.resize( vertex_first, colour );
+	mesh.indices.resize( index_first );
+
+	for( size_t s = 0; s < segments.size(); ++s )
+		write( s, mesh );
+
+	mesh.patches.push_back( { 0, mesh.vertices.size(), 0, mesh.indices.size() } );
+}
+
+bool TrackMesh::update( const TrackComponent &track, size_t first, size_t last, MeshData &mesh )
+{
+	if( segments.empty() )
+		return false;
+
+	// a span's spline runs through the control points either side of it as well
+	size_t spans = span_count();
+	std::set<size_t> resampled;
+
+	if( closed ) {
+		if( last - first + 4 >= spans )
+			for( size_t s = 0; s < segments.size(); ++s )
+				resampled.insert( s );
+		else
+			for( size_t span = first + spans - 2; span <= last + spans + 1; ++span )
+				resampled.insert( ( span % spans ) / spans_per_segment );
+	}
+	else {
+		size_t from = first >= 2 ? first - 2 : 0;
+		size_t to = std::min( last + 1, spans - 1 );
+
+		for( size_t span = from; span <= to; ++span )
+			resampled.insert( span / spans_per_segment );
+	}
+
+	for( size_t s : resampled )
+		sample( track.centreline, s );
+
+	// the first join of the segment after a resampled one looks back at its last sample
+	std::set<size_t> rewritten = resampled;
+	for( size_t s : resampled )
+		if( closed || s + 1 < segments.size() )
+			rewritten.insert( ( s + 1 ) % segments.size() );
+
+	mesh.patches.clear();
+	++mesh.version;
+
+	std::set<size_t> relinked;
+
+	for( size_t s : rewritten )
+		if( !write( s, mesh ) ) {
+
+			// outgrew its slot, it moves to a bigger one at the end of the mesh
+			relocate( s, mesh );
+			write( s, mesh );
+
+			if( closed || s > 0 )		// the quad into it ends on its first vertex
+				relinked.insert( ( s + segments.size() - 1 ) % segments.size() );
+		}
+
+	for( size_t s : relinked )
+		write( s, mesh );
+
+	rewritten.insert( relinked.begin(), relinked.end() );
+
+	for( size_t s : rewritten ) {
+		auto& segment = segments[s];
+		mesh.patches.push_back( { segment.vertex_first, segment.vertex_capacity, segment.index_first, segment.index_capacity } );
+	}
+
+	return true;
+}
+
+void TrackMesh::relocate( size_t s, MeshData &mesh )
+{
+	auto& segment = segments[s];
+
+	// the old slot is left as degenerate triangles
+	std::fill( mesh.indices.begin() + segment.index_first, mesh.indices.begin() + segment.index_first + segment.index_capacity, segment.vertex_first );
+
+	MeshData scratch;
+	extrude( s, scratch );
+
+	segment.vertex_first = uint32_t( mesh.vertices.size() );
+	segment.vertex_capacity = uint32_t( scratch.vertices.size() * 2 + 8 );
+	segment.index_first = uint32_t( mesh.indices.size() );
+	segment.index_capacity = uint32_t( ( scratch.indices.size() / 3 * 2 + 4 ) * 3 );
+
+	mesh.vertices.resize( mesh.vertices.size() + segment.vertex_capacity );
+	mesh.colours.resize( mesh.vertices.size(), colour );
+	mesh.indices.resize( mesh.indices.size() + segment.index_capacity );
+}
+
+bool TrackMesh::matches( const TrackComponent &track, float tolerance ) const
+{
+	return !segments.empty() && track.centreline.size() == points && ( track.closed && points > 2 ) == closed &&
+		   track.width == width && track.colour == colour && tolerance == this->tolerance;
+}
+
+void TrackMesh::sample( const std::vector<glm::vec2> &centreline, size_t s )
+{
+	size_t first = s * spans_per_segment;
+	size_t last = std::min( first + spans_per_segment, span_count() );
+
+	auto& samples = segments[s].samples;
+	samples = tessellate_spans( centreline, closed, first, last, tolerance );
+
+	if( closed || s + 1 < segments.size() )		// the end point is the first sample of the next segment
+		samples.pop_back();
+}
+
+RibbonJoin TrackMesh::extrude( size_t s, MeshData &scratch ) const
+{
+	auto& samples = segments[s].samples;
+	size_t count = segments.size();
+
+	bool has_previous = closed || s > 0;
+	bool has_next = closed || s + 1 < count;
+
+	auto& previous_samples = segments[ ( s + count - 1 ) % count ].samples;
+	auto& next_samples = segments[ ( s + 1 ) % count ].samples;
+
+	RibbonJoin previous_join {};
+
+	for( size_t i = 0; i < samples.size(); ++i ) {
+
+		glm::vec2 p = samples[i];
+		glm::vec2 previous = i > 0 ? samples[i-1] : ( has_previous ? previous_samples.back() : p );
+		glm::vec2 next = i + 1 < samples.size() ? samples[i+1] : ( has_next ? next_samples.front() : p );
+
+		RibbonJoin join = add_ribbon_join( previous, p, next, width * 0.5f, colour, miter_limit, scratch );
+
+		if( i > 0 )
+			add_ribbon_quad( previous_join, join, scratch );
+
+		previous_join = join;
+	}
+
+	return previous_join;
+}
+
+bool TrackMesh::write( size_t s, MeshData &mesh ) const
+{
+	auto& segment = segments[s];
+	size_t count = segments.size();
+
+	MeshData scratch;
+	RibbonJoin last = extrude( s, scratch );
+
+	// the quad to the next segment ends on the pair its first join starts with, which is where its slot starts
+	bool has_next = closed || s + 1 < count;
+	size_t quad = has_next ? 6 : 0;
+
+	if( scratch.vertices.size() > segment.vertex_capacity || scratch.indices.size() + quad > segment.index_capacity )
+		return false;
+
+	uint32_t base = segment.vertex_first;
+
+	std::copy( scratch.vertices.begin(), scratch.vertices.end(), mesh.vertices.begin() + base );
+	std::fill( mesh.vertices.begin() + base + scratch.vertices.size(), mesh.vertices.begin() + base + segment.vertex_capacity, scratch.vertices.front() );
+
+	auto index = mesh.indices.begin() + segment.index_first;
+
+	index = std::transform( scratch.indices.begin(), scratch.indices.end(), index, [base]( uint32_t i ) { return i + base; } );
+
+	if( has_next ) {
+		uint32_t next_first = segments[ ( s + 1 ) % count ].vertex_first;
+
+		MeshData connect;
+		add_ribbon_quad( { last.in + base, last.out + base }, { next_first, next_first }, connect );
+
+		index = std::copy( connect.indices.begin(), connect.indices.end(), index );
+	}
+
+	std::fill( index, mesh.indices.begin() + segment.index_first + segment.index_capacity, base );		// degenerate triangles
+
+	return true;
+}
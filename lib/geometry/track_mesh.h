@@ -0,0 +1,79 @@
+/*
+ * track_mesh.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "tessellation.h"
+
+struct MeshData;
+struct TrackComponent;
+
+/*
+ * The ribbon of a track laid out for editing. The control point spans are grouped into segments of
+ * spans_per_segment, every segment is tessellated on its own and owns a fixed slot of vertices and
+ * indices in the mesh, with room to spare. Moving control points re-tessellates the segments whose
+ * spline spans they influence and rewrites those slots (and the joins of the segments after them),
+ * so an edit costs the same however long the track is. The unused part of a slot is padded with
+ * degenerate triangles.
+ */
+class TrackMesh
+{
+public:
+	static constexpr size_t spans_per_segment = 64;
+
+	void build( const TrackComponent& track, float tolerance, float miter_limit, MeshData& mesh );
+
+	// patches the mesh for the control points first to last having moved, false when it was never built.
+	// A segment that outgrows its slot moves to a bigger one at the end, which changes the size of the mesh.
+	bool update( const TrackComponent& track, size_t first, size_t last, MeshData& mesh );
+
+	// whether the mesh was built from a track like this one, up to moved control points
+	bool matches( const TrackComponent& track, float tolerance ) const;
+
+private:
+	struct Segment
+	{
+		std::vector<glm::vec2> samples;		// from its first control point up to the next segment's
+		uint32_t vertex_first = 0;
+		uint32_t vertex_capacity = 0;
+		uint32_t index_first = 0;
+		uint32_t index_capacity = 0;
+	};
+
+	std::vector<Segment> segments;
+
+	size_t points = 0;
+	bool closed = false;
+	float width = 0.0f;
+	glm::vec3 colour = glm::vec3( 0.0f );
+	float tolerance = 0.0f;
+	float miter_limit = 0.0f;
+
+	size_t span_count() const { return closed ? points : points - 1; }
+
+	void sample( const std::vector<glm::vec2>& centreline, size_t segment );
+	RibbonJoin extrude( size_t segment, MeshData& scratch ) const;		// returns the join of its last sample
+	bool write( size_t segment, MeshData& mesh ) const;		// false, and nothing written, when it does not fit
+	void relocate( size_t segment, MeshData& mesh );
+};
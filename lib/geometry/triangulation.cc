@@ -0,0 +1,234 @@
+/*
+ * triangulation.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "triangulation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+float cross( glm::vec2 o, glm::vec2 a, glm::vec2 b )
+{
+	return ( a.x - o.x ) * ( b.y - o.y ) - ( a.y - o.y ) * ( b.x - o.x );
+}
+
+float signed_area( const std::vector<glm::vec2>& points )
+{
+	float area = 0.0f;
+
+	for( size_t i = 0, j = points.size() - 1; i < points.size(); j = i++ )
+		area += ( points[j].x - points[i].x ) * ( points[j].y + points[i].y );
+
+	return area * 0.5f;
+}
+
+bool inside_triangle( glm::vec2 a, glm::vec2 b, glm::vec2 c, glm::vec2 p )		// counter clockwise a, b, c, edges included
+{
+	return cross( a, b, p ) >= 0.0f && cross( b, c, p ) >= 0.0f && cross( c, a, p ) >= 0.0f;
+}
+
+bool inside_polygon( const std::vector<glm::vec2>& polygon, glm::vec2 p )
+{
+	bool inside = false;
+
+	for( size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++ ) {
+
+		glm::vec2 a = polygon[i], b = polygon[j];
+
+		if( ( a.y > p.y ) != ( b.y > p.y ) && p.x < a.x + ( p.y - a.y ) * ( b.x - a.x ) / ( b.y - a.y ) )
+			inside = !inside;
+	}
+
+	return inside;
+}
+
+// joins the clockwise hole to the counter clockwise ring by a pair of coincident edges from its rightmost point
+void bridge( const std::vector<glm::vec2>& points, std::vector<uint32_t>& ring, const std::vector<uint32_t>& hole )
+{
+	size_t m = 0;
+	for( size_t i = 1; i < hole.size(); ++i )
+		if( points[ hole[i] ].x > points[ hole[m] ].x )
+			m = i;
+
+	glm::vec2 start = points[ hole[m] ];
+
+	// the nearest edge to the right, from the inside an outline crossing going up
+	float nearest = std::numeric_limits<float>::max();
+	size_t edge = ring.size();
+
+	for( size_t i = 0; i < ring.size(); ++i ) {
+
+		glm::vec2 a = points[ ring[i] ], b = points[ ring[ ( i + 1 ) % ring.size() ] ];
+
+		if( a.y > start.y || b.y < start.y || a.y == b.y )
+			continue;
+
+		float x = a.x + ( start.y - a.y ) * ( b.x - a.x ) / ( b.y - a.y );
+
+		if( x >= start.x && x < nearest ) {
+			nearest = x;
+			edge = i;
+		}
+	}
+
+	if( edge == ring.size() )
+		return;
+
+	size_t target = points[ ring[edge] ].x > points[ ring[ ( edge + 1 ) % ring.size() ] ].x ? edge : ( edge + 1 ) % ring.size();
+
+	// a vertex inside the triangle between the hole, the hit and the edge's end would block the view,
+	// the one closest in angle to the ray is visible
+	glm::vec2 hit( nearest, start.y );
+	glm::vec2 end = points[ ring[target] ];
+	float best = std::numeric_limits<float>::max();
+
+	for( size_t i = 0; i < ring.size() && hit != end; ++i ) {
+
+		glm::vec2 p = points[ ring[i] ];
+
+		if( i == target || p == end || p.x <= start.x || p.x > end.x )
+			continue;
+
+		bool inside = end.y < start.y ? inside_triangle( start, end, hit, p ) : inside_triangle( start, hit, end, p );
+
+		if( inside ) {
+			float slope = std::abs( p.y - start.y ) / ( p.x - start.x + 1e-30f );
+			if( slope < best ) {
+				best = slope;
+				target = i;
+			}
+		}
+	}
+
+	std::vector<uint32_t> splice;
+	splice.reserve( hole.size() + 2 );
+
+	for( size_t i = 0; i <= hole.size(); ++i )
+		splice.push_back( hole[ ( m + i ) % hole.size() ] );
+	splice.push_back( ring[target] );
+
+	ring.insert( ring.begin() + target + 1, splice.begin(), splice.end() );
+}
+
+bool is_ear( const std::vector<glm::vec2>& points, const std::vector<uint32_t>& ring, size_t prev, size_t i, size_t next )
+{
+	glm::vec2 a = points[ ring[prev] ], b = points[ ring[i] ], c = points[ ring[next] ];
+
+	if( cross( a, b, c ) <= 0.0f )		// reflex or flat
+		return false;
+
+	for( size_t j = 0; j < ring.size(); ++j ) {
+
+		glm::vec2 p = points[ ring[j] ];
+
+		if( j == prev || j == i || j == next || p == a || p == b || p == c )
+			continue;
+
+		if( inside_triangle( a, b, c, p ) )
+			return false;
+	}
+
+	return true;
+}
+
+}
+
+std::vector<uint32_t> triangulate_polygon( const std::vector<glm::vec2>& outline, const std::vector<std::vector<glm::vec2>>& holes )
+{
+	std::vector<uint32_t> triangles;
+
+	if( outline.size() < 3 )
+		return triangles;
+
+	std::vector<glm::vec2> points( outline );
+	std::vector<uint32_t> ring( outline.size() );
+
+	for( size_t i = 0; i < ring.size(); ++i )
+		ring[i] = uint32_t( i );
+	if( signed_area( outline ) < 0.0f )
+		std::reverse( ring.begin(), ring.end() );
+
+	std::vector<std::vector<uint32_t>> hole_rings;
+
+	for( auto& hole : holes ) {
+
+		uint32_t offset = uint32_t( points.size() );
+		points.insert( points.end(), hole.begin(), hole.end() );
+
+		if( hole.size() < 3 || !std::all_of( hole.begin(), hole.end(), [&]( glm::vec2 p ) { return inside_polygon( outline, p ); } ) )
+			continue;
+
+		std::vector<uint32_t> hole_ring( hole.size() );
+		for( size_t i = 0; i < hole.size(); ++i )
+			hole_ring[i] = offset + uint32_t( i );
+		if( signed_area( hole ) > 0.0f )
+			std::reverse( hole_ring.begin(), hole_ring.end() );
+
+		hole_rings.push_back( std::move( hole_ring ) );
+	}
+
+	// rightmost hole first, so every bridge runs to the outline or a hole already bridged into it
+	auto right = [&]( const std::vector<uint32_t>& hole )
+	{
+		float x = -std::numeric_limits<float>::max();
+		for( auto index : hole )
+			x = std::max( x, points[index].x );
+		return x;
+	};
+
+	std::sort( hole_rings.begin(), hole_rings.end(), [&]( auto& a, auto& b ) { return right( a ) > right( b ); } );
+
+	for( auto& hole : hole_rings )
+		bridge( points, ring, hole );
+
+	triangles.reserve( ( ring.size() - 2 ) * 3 );
+
+	size_t i = 0;
+	size_t tried = 0;
+
+	while( ring.size() > 3 ) {
+
+		size_t n = ring.size();
+		size_t prev = ( i + n - 1 ) % n;
+		size_t next = ( i + 1 ) % n;
+
+		// once a whole round finds no ear, rounding has left the ring slightly self intersecting, cut anyway
+		if( is_ear( points, ring, prev, i, next ) || tried > n ) {
+
+			if( cross( points[ ring[prev] ], points[ ring[i] ], points[ ring[next] ] ) > 0.0f )
+				triangles.insert( triangles.end(), { ring[prev], ring[i], ring[next] } );
+
+			ring.erase( ring.begin() + i );
+			if( i == ring.size() )
+				i = 0;
+			tried = 0;
+			continue;
+		}
+
+		i = next;
+		++tried;
+	}
+
+	if( cross( points[ ring[0] ], points[ ring[1] ], points[ ring[2] ] ) > 0.0f )
+		triangles.insert( triangles.end(), { ring[0], ring[1], ring[2] } );
+
+	return triangles;
+}
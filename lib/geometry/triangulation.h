@@ -0,0 +1,33 @@
+/*
+ * triangulation.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/*
+ * Ear clipping triangulation of a simple polygon with holes, in either winding. Each hole is
+ * bridged into the outline from its rightmost point, after which the combined outline is clipped.
+ * A hole that is not inside the outline is left out. Returns counter clockwise triangles as indices
+ * into the outline followed by the holes, in the order given.
+ */
+std::vector<uint32_t> triangulate_polygon( const std::vector<glm::vec2>& outline, const std::vector<std::vector<glm::vec2>>& holes = {} );
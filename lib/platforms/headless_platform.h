@@ -0,0 +1,37 @@
+/*
+ * headless_platform.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include "../core/platform.h"
+
+// no window and no input, for engines that are stepped by a program rather than run
+class HeadlessPlatform : public IPlatform
+{
+	bool create_window( InputQueue& ) override { return true; }
+	void destroy_window() override {}
+
+	void begin_render() override {}
+	void present_frame() override {}
+
+	double get_time() override { return 0.0; }
+	void poll_events() override {}
+	bool should_close() override { return true; }
+};
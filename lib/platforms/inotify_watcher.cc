@@ -0,0 +1,86 @@
+/*
+ * inotify_watcher.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "inotify_watcher.h"
+
+#include <filesystem>
+
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <limits.h>
+
+InotifyWatcher::InotifyWatcher()
+{
+	fd = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+}
+
+InotifyWatcher::~InotifyWatcher()
+{
+	if( fd >= 0 )
+		close( fd );
+}
+
+void InotifyWatcher::watch( const std::string &filename )
+{
+	if( fd < 0 )
+		return;
+
+	if( wd >= 0 )
+		inotify_rm_watch( fd, wd );
+
+	wd = -1;
+	name.clear();
+
+	if( filename.empty() )
+		return;
+
+	std::filesystem::path path( filename );
+	std::filesystem::path directory = path.has_parent_path() ? path.parent_path() : std::filesystem::path( "." );
+
+	wd = inotify_add_watch( fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO );
+	name = path.filename().string();
+}
+
+bool InotifyWatcher::changed()
+{
+	if( fd < 0 || wd < 0 )
+		return false;
+
+	alignas(inotify_event) char buffer[ 16 * (sizeof(inotify_event) + NAME_MAX + 1) ];
+	bool hit = false;
+
+	for( ;; ) {
+
+		ssize_t length = read( fd, buffer, sizeof(buffer) );
+		if( length <= 0 )
+			break;
+
+		for( char * ptr = buffer; ptr < buffer + length; ) {
+
+			auto event = reinterpret_cast<inotify_event*>( ptr );
+
+			if( event->wd == wd && event->len && name == event->name )
+				hit = true;
+
+			ptr += sizeof(inotify_event) + event->len;
+		}
+	}
+
+	return hit;
+}
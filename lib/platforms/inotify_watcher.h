@@ -0,0 +1,44 @@
+/*
+ * inotify_watcher.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <string>
+
+/*
+ * Watches a single file through inotify. The directory is watched rather than the file itself so
+ * that editors which save by writing a new file and renaming it over the old one are noticed too.
+ */
+class InotifyWatcher
+{
+public:
+	InotifyWatcher();
+	~InotifyWatcher();
+
+	InotifyWatcher( const InotifyWatcher& ) = delete;
+	InotifyWatcher& operator=( const InotifyWatcher& ) = delete;
+
+	void watch( const std::string& filename );
+	bool changed();		// non blocking, true when the file was written since the last call
+
+private:
+	int fd = -1;
+	int wd = -1;
+	std::string name;
+};
@@ -0,0 +1,130 @@
+/*
+ * udp_socket.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "udp_socket.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+UdpSocket::UdpSocket()
+{
+	fd = socket( AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0 );
+
+	// a snapshot of a few thousand entities goes out as a burst of datagrams
+	set_buffer_size( 4 << 20 );
+}
+
+UdpSocket::~UdpSocket()
+{
+	if( fd >= 0 )
+		close( fd );
+}
+
+bool UdpSocket::resolve( const std::string& host, uint16_t port, UdpEndpoint& endpoint )
+{
+	in_addr address;
+
+	if( inet_pton( AF_INET, host == "localhost" ? "127.0.0.1" : host.c_str(), &address ) != 1 )
+		return false;
+
+	endpoint.address = address.s_addr;
+	endpoint.port = htons( port );
+
+	return true;
+}
+
+bool UdpSocket::bind( const std::string& host, uint16_t port )
+{
+	UdpEndpoint endpoint;
+
+	if( fd < 0 || !resolve( host, port, endpoint ) )
+		return false;
+
+	sockaddr_in address {};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = endpoint.address;
+	address.sin_port = endpoint.port;
+
+	return ::bind( fd, reinterpret_cast<sockaddr*>( &address ), sizeof(address) ) == 0;
+}
+
+void UdpSocket::set_buffer_size( size_t size )
+{
+	int bytes = int( size );
+
+	if( fd >= 0 ) {
+		setsockopt( fd, SOL_SOCKET, SO_SNDBUF, &bytes, sizeof(bytes) );
+		setsockopt( fd, SOL_SOCKET, SO_RCVBUF, &bytes, sizeof(bytes) );
+	}
+}
+
+size_t UdpSocket::get_receive_buffer() const
+{
+	int bytes = 0;
+	socklen_t length = sizeof(bytes);
+
+	if( fd < 0 || getsockopt( fd, SOL_SOCKET, SO_RCVBUF, &bytes, &length ) != 0 )
+		return 0;
+
+	return size_t( bytes );
+}
+
+uint16_t UdpSocket::get_port() const
+{
+	sockaddr_in address {};
+	socklen_t length = sizeof(address);
+
+	if( fd < 0 || getsockname( fd, reinterpret_cast<sockaddr*>( &address ), &length ) != 0 )
+		return 0;
+
+	return ntohs( address.sin_port );
+}
+
+bool UdpSocket::send( const UdpEndpoint& to, const void * data, size_t size )
+{
+	if( fd < 0 )
+		return false;
+
+	sockaddr_in address {};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = to.address;
+	address.sin_port = to.port;
+
+	return sendto( fd, data, size, 0, reinterpret_cast<sockaddr*>( &address ), sizeof(address) ) == ssize_t( size );
+}
+
+size_t UdpSocket::receive( UdpEndpoint& from, void * data, size_t capacity )
+{
+	if( fd < 0 )
+		return 0;
+
+	sockaddr_in address {};
+	socklen_t length = sizeof(address);
+
+	ssize_t size = recvfrom( fd, data, capacity, 0, reinterpret_cast<sockaddr*>( &address ), &length );
+	if( size <= 0 )
+		return 0;
+
+	from.address = address.sin_addr.s_addr;
+	from.port = address.sin_port;
+
+	return size_t( size );
+}
@@ -0,0 +1,66 @@
+/*
+ * udp_socket.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// an IPv4 address and port, both in the network's byte order
+struct UdpEndpoint
+{
+	uint32_t address = 0;
+	uint16_t port = 0;
+
+	bool operator==( const UdpEndpoint& ) const = default;
+};
+
+/*
+ * A non blocking UDP socket. Sending never waits for the receiver, a datagram that does not fit in
+ * the socket's buffer is lost like one lost on the way.
+ */
+class UdpSocket
+{
+public:
+	UdpSocket();
+	~UdpSocket();
+
+	UdpSocket( const UdpSocket& ) = delete;
+	UdpSocket& operator=( const UdpSocket& ) = delete;
+
+	// port 0 lets the system pick one, get_port() tells which
+	bool bind( const std::string& host = "127.0.0.1", uint16_t port = 0 );
+	uint16_t get_port() const;
+
+	// what is asked for is capped by the system, rmem_max and wmem_max on Linux. The size is what
+	// the system reports, its bookkeeping of each datagram included
+	void set_buffer_size( size_t size );
+	size_t get_receive_buffer() const;
+
+	static bool resolve( const std::string& host, uint16_t port, UdpEndpoint& endpoint );
+
+	bool send( const UdpEndpoint& to, const void * data, size_t size );
+
+	// the size of the datagram, 0 when none is waiting. A longer datagram than fits is cut short
+	size_t receive( UdpEndpoint& from, void * data, size_t capacity );
+
+private:
+	int fd = -1;
+};
@@ -26,6 +26,7 @@
 #include "../core/world.h"
 #include "../core/view.h"
 #include "../components/lake_component.h"
+#include "../components/mesh_component.h"
 
 static const char* lake_vs = R"(
 #version 330 core
@@ -53,17 +54,15 @@ void main() {
 }
 )";
 
-constexpr int max_objects = 10000;
-
 void LakeRenderer::init()
 {
     glGenVertexArrays( 1, &vao );
     glGenBuffers( 1, &vbo );
+    glGenBuffers( 1, &ibo );
 
     glBindVertexArray( vao );
     glBindBuffer( GL_ARRAY_BUFFER, vbo );
-
-    glBufferData( GL_ARRAY_BUFFER, max_objects * sizeof(vertex), nullptr, GL_DYNAMIC_DRAW );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, ibo );
 
     glEnableVertexAttribArray( 0 );
     glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, sizeof(vertex), (void*)offsetof( vertex, position) );
@@ -76,61 +75,43 @@ void LakeRenderer::init()
     shader.init(lake_vs, lake_fs);
 }
 
-#include <iostream>
-
 void LakeRenderer::upload( const World& world )
 {
-    cpu_buffer.clear();
+    std::vector<std::shared_ptr<const MeshData>> surfaces;
 
 	for( auto [entity, lake] : world.view<LakeComponent>() )
-    {
-        glm::vec3 lake_colour( 0.0f, 0.3f, 1.0f);
-        glm::vec3 island_colour( 0.2f, 0.8f, 0.2f);
-
-#ifdef DRAW_OUTLINE
-        for( const glm::vec2& p : lake.lake_outline )
-            cpu_buffer.push_back( { glm::vec3(p.x,p.y,0.0f), lake_colour } );
-
-        for( const glm::vec2& p : lake.island_outline )
-            cpu_buffer.push_back( { glm::vec3(p.x,p.y,0.0f), island_colour } );
+        if( lake.surface )
+            surfaces.push_back( lake.surface );
 
-        lake_vertices = lake.lake_outline.size();
-        island_vertices = lake.island_outline.size();
-#else
-        if (lake.lake_outline.size() >= 3) {
+    if( surfaces == uploaded )
+        return;
 
-            glm::vec3 p0(lake.lake_outline[0].x, lake.lake_outline[0].y, 0.0f);
+    std::vector<vertex> vertices;
+    std::vector<uint32_t> indices;
 
-            for (size_t i = 1; i + 1 < lake.lake_outline.size(); i++) {
+    for( auto& surface : surfaces ) {
 
-                glm::vec3 p1( lake.lake_outline[i    ].x, lake.lake_outline[i    ].y, 0.0f );
-                glm::vec3 p2( lake.lake_outline[i + 1].x, lake.lake_outline[i + 1].y, 0.0f );
+        uint32_t base = uint32_t( vertices.size() );
 
-                cpu_buffer.push_back( {p0, lake_colour} );
-                cpu_buffer.push_back( {p1, lake_colour} );
-                cpu_buffer.push_back( {p2, lake_colour} );
-            }
-        }
+        for( size_t i = 0; i < surface->vertices.size(); ++i )
+            vertices.push_back( { surface->vertices[i], surface->colours[i] } );
 
-        if( lake.island_outline.size() >= 3 ) {
+        for( uint32_t index : surface->indices )
+            indices.push_back( base + index );
+    }
 
-            glm::vec3 p0(lake.island_outline[0].x, lake.island_outline[0].y, 0.0f);
+    glBindVertexArray( vao );
 
-            for (size_t i = 1; i + 1 < lake.island_outline.size(); i++) {
+    glBindBuffer( GL_ARRAY_BUFFER, vbo );
+    glBufferData( GL_ARRAY_BUFFER, vertices.size() * sizeof(vertex), vertices.data(), GL_STATIC_DRAW );
 
-                glm::vec3 p1( lake.island_outline[i    ].x, lake.island_outline[i    ].y, 0.0f );
-                glm::vec3 p2( lake.island_outline[i + 1].x, lake.island_outline[i + 1].y, 0.0f );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, ibo );
+    glBufferData( GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW );
 
-                cpu_buffer.push_back( {p0, island_colour} );
-                cpu_buffer.push_back( {p1, island_colour} );
-                cpu_buffer.push_back( {p2, island_colour} );
-            }
-        }
-#endif
-    };
+    glBindVertexArray( 0 );
 
-    glBindBuffer( GL_ARRAY_BUFFER, vbo );
-    glBufferSubData( GL_ARRAY_BUFFER, 0, cpu_buffer.size() * sizeof(vertex), (void*)cpu_buffer.data() );
+    index_count = indices.size();
+    uploaded = std::move( surfaces );
 }
 
 void LakeRenderer::draw()
@@ -140,10 +121,13 @@ void LakeRenderer::draw()
     glBindVertexArray(vao);
 
 #ifdef DRAW_OUTLINE
-    glDrawArrays( GL_LINE_LOOP, 0, lake_vertices );
-    glDrawArrays( GL_LINE_LOOP, lake_vertices, island_vertices );
-#else
-    glDrawArrays( GL_TRIANGLES, 0, cpu_buffer.size() );
+    glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
+#endif
+
+    glDrawElements( GL_TRIANGLES, index_count, GL_UNSIGNED_INT, nullptr );
+
+#ifdef DRAW_OUTLINE
+    glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
 #endif
 
     glBindVertexArray(0);
@@ -157,6 +141,7 @@ void LakeRenderer::set_mvp( glm::mat4 &mvp )
 
 void LakeRenderer::destroy()
 {
+    if( ibo ) glDeleteBuffers( 1, &ibo );
     if( vbo ) glDeleteBuffers( 1, &vbo );
     if( vao ) glDeleteVertexArrays( 1, &vao );
 }
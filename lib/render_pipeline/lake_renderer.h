@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include <glm/glm.hpp>
@@ -26,6 +27,8 @@
 #include "base_renderer.h"
 #include "shader.h"
 
+struct MeshData;
+
 class LakeRenderer : public BaseRenderer
 {
 public:
@@ -40,14 +43,14 @@ private:
     Shader shader;
     unsigned vao = 0;
     unsigned vbo = 0;
+    unsigned ibo = 0;
 
     struct vertex {
         glm::vec3 position;
         glm::vec3 colour;
     };
 
-    size_t lake_vertices;
-    size_t island_vertices;
-
-    std::vector<vertex> cpu_buffer;
+    // lakes do not change once generated, the buffers are only rebuilt when the set of surfaces does
+    std::vector<std::shared_ptr<const MeshData>> uploaded;
+    size_t index_count = 0;
 };
@@ -21,11 +21,18 @@
 
 #include <glad/gl.h>
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <map>
+
 #include <glm/glm.hpp>
 
 #include "../core/world.h"
 #include "../core/view.h"
 #include "../components/mesh_component.h"
+#include "../components/transform_component.h"
 
 
 std::unordered_map<MeshComponent::Topology, GLenum> topology_map = {
@@ -43,12 +50,17 @@ static const char* mesh_vs = R"(
 
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aCol;
+layout(location = 2) in vec3 aTranslation;
+layout(location = 3) in vec3 aScale;
+layout(location = 4) in vec2 aRotation;
 uniform mat4 uMVP;
 
 out vec3 col;
 
 void main() {
-    gl_Position = uMVP * vec4(aPos, 1.0);
+    vec3 p = aPos * aScale;
+    p.xy = vec2( p.x * aRotation.x - p.y * aRotation.y, p.x * aRotation.y + p.y * aRotation.x );
+    gl_Position = uMVP * vec4(p + aTranslation, 1.0);
     col = aCol;
 }
 )";
@@ -69,7 +81,26 @@ void MeshRenderer::init()
     glGenVertexArrays( 1, &vao );
     glGenBuffers( 1, &vbo );
     glGenBuffers( 1, &ibo );
+    glGenBuffers( 1, &instance_vbo );
+
+    bind_buffers();
 
+    glBindVertexArray( vao );
+
+    // the instance attributes are pointed at each draw's instances in draw()
+    for( GLuint attribute : { 2, 3, 4 } ) {
+        glEnableVertexAttribArray( attribute );
+        glVertexAttribDivisor( attribute, 1 );
+    }
+
+    glBindVertexArray( 0 );
+
+    shader.init( mesh_vs, mesh_fs );
+}
+
+// the vertex array keeps the buffers it was given, a grown buffer has to be given again
+void MeshRenderer::bind_buffers()
+{
     glBindVertexArray( vao );
     glBindBuffer( GL_ARRAY_BUFFER, vbo );
     glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, ibo );
@@ -81,53 +112,276 @@ void MeshRenderer::init()
     glVertexAttribPointer( 1, 3, GL_FLOAT, GL_FALSE, sizeof(vertex), (void*)offsetof( vertex, colour) );
 
     glBindVertexArray( 0 );
-
-    shader.init( mesh_vs, mesh_fs );
 }
 
 void MeshRenderer::upload( const World& world )
 {
-    std::vector<vertex> vertex_buffer;
-    std::vector<unsigned int> index_buffer;
-    size_t vertex_buffer_idx = 0;
+    uploaded_bytes = 0;
+    ++frame;
 
-    draw_commands.clear();
+    track( world );
+    refresh();
+
+    if( commands_changed )
+        rebuild_commands();
+
+    upload_instances( world );
+}
+
+// which mesh each entity draws, meshes no entity draws any more are let go
+void MeshRenderer::track( const World& world )
+{
+    size_t seen = 0;
 
 	for( auto [entity, mesh] : world.view<MeshComponent>() )
     {
-        DrawCommand draw_command;
+        if( !mesh.data )
+            continue;
 
-        draw_command.mode = topology_map[mesh.topology];
+        ++seen;
 
-        assert(mesh.vertices.size() == mesh.colours.size());
+        unsigned int mode = topology_map[mesh.topology];
+        Drawn& entry = drawn[entity];
 
-        for( int i = 0; i < mesh.vertices.size(); ++i )
-            vertex_buffer.push_back( { mesh.vertices[i], mesh.colours[i] });
+        if( entry.mesh != mesh.data.get() || entry.mode != mode ) {
 
-        if( !mesh.indices.empty() ) {
+            acquire( mesh.data );
+            if( entry.mesh )
+                release( entry.mesh );
 
-            draw_command.indexed = true;
-            draw_command.start = index_buffer.size();
-            draw_command.count = mesh.indices.size();
+            entry.mesh = mesh.data.get();
+            entry.mode = mode;
+            commands_changed = true;
+        }
+
+        entry.frame = frame;
+    }
+
+    if( seen == drawn.size() )
+        return;
+
+    for( auto it = drawn.begin(); it != drawn.end(); ) {
+        if( it->second.frame == frame ) {
+            ++it;
+            continue;
+        }
+
+        release( it->second.mesh );
+        it = drawn.erase( it );
+    }
+
+    commands_changed = true;
+}
+
+void MeshRenderer::acquire( const std::shared_ptr<const MeshData>& data )
+{
+    auto [it, added] = resident.try_emplace( data.get() );
+    Resident& mesh = it->second;
+
+    if( added ) {
+        mesh.data = data;
+        mesh.version = data->version;
+        place( mesh );
+    }
+
+    ++mesh.users;
+}
+
+void MeshRenderer::release( const MeshData * data )
+{
+    auto it = resident.find( data );
+    if( it == resident.end() || --it->second.users )
+        return;
+
+    Resident& mesh = it->second;
+
+    vertex_ranges.release( mesh.vertex_first, mesh.vertex_count );
+    index_ranges.release( mesh.index_first, mesh.index_count );
+
+    resident.erase( it );
+}
+
+// meshes edited in place send what was edited, one that changed size moves to ranges that fit
+void MeshRenderer::refresh()
+{
+    for( auto& [_, mesh] : resident ) {
+
+        const MeshData& data = *mesh.data;
+
+        if( data.version == mesh.version )
+            continue;
+
+        if( data.vertices.size() != mesh.vertex_count || data.indices.size() != mesh.index_count ) {
+
+            vertex_ranges.release( mesh.vertex_first, mesh.vertex_count );
+            index_ranges.release( mesh.index_first, mesh.index_count );
+
+            place( mesh );
+            commands_changed = true;
+        }
+        else if( data.version == mesh.version + 1 )
+            for( auto& patch : data.patches )
+                upload_range( mesh, patch.vertex_first, patch.vertex_count, patch.index_first, patch.index_count );
+        else
+            upload_range( mesh, 0, data.vertices.size(), 0, data.indices.size() );
+
+        mesh.version = data.version;
+    }
+}
+
+void MeshRenderer::place( Resident& mesh )
+{
+    const MeshData& data = *mesh.data;
+
+    assert( data.vertices.size() == data.colours.size() );
+
+    mesh.vertex_count = data.vertices.size();
+    mesh.index_count = data.indices.size();
+    mesh.vertex_first = allocate( vertex_ranges, vbo, sizeof(vertex), mesh.vertex_count );
+    mesh.index_first = allocate( index_ranges, ibo, sizeof(unsigned int), mesh.index_count );
+
+    upload_range( mesh, 0, mesh.vertex_count, 0, mesh.index_count );
+}
+
+// a full buffer is replaced by one twice the size, which gets the old contents on the GPU
+size_t MeshRenderer::allocate( RangeAllocator& ranges, unsigned& buffer, size_t element_size, size_t count )
+{
+    size_t first = ranges.allocate( count );
+    if( first != RangeAllocator::npos )
+        return first;
+
+    size_t capacity = ranges.get_capacity();
+    size_t grown = std::max( { capacity * 2, capacity + count, size_t( 4096 ) } );
+
+    unsigned replacement;
+    glGenBuffers( 1, &replacement );
+    glBindBuffer( GL_COPY_WRITE_BUFFER, replacement );
+    glBufferData( GL_COPY_WRITE_BUFFER, grown * element_size, nullptr, GL_DYNAMIC_DRAW );
+
+    if( capacity ) {
+        glBindBuffer( GL_COPY_READ_BUFFER, buffer );
+        glCopyBufferSubData( GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, capacity * element_size );
+    }
+
+    glDeleteBuffers( 1, &buffer );
+    buffer = replacement;
+
+    ranges.grow( grown );
+    bind_buffers();
+
+    return ranges.allocate( count );
+}
 
-            std::transform( mesh.indices.begin(), mesh.indices.end(), std::back_inserter(index_buffer), [vertex_buffer_idx]( unsigned int index){ return index + vertex_buffer_idx; } );
+void MeshRenderer::rebuild_commands()
+{
+    std::map<std::pair<const MeshData*, unsigned int>, std::vector<Entity>> batches;
+
+    for( auto& [entity, entry] : drawn )
+        batches[ { entry.mesh, entry.mode } ].push_back( entity );
+
+    draw_commands.clear();
+    instance_entities.clear();
+
+    for( auto& [key, entities] : batches )
+    {
+        const Resident& mesh = resident.at( key.first );
+        DrawCommand draw_command;
+
+        draw_command.mode = key.second;
+        draw_command.base_vertex = mesh.vertex_first;
+
+        if( mesh.index_count ) {
+            draw_command.indexed = true;
+            draw_command.start = mesh.index_first;
+            draw_command.count = mesh.index_count;
         } else {
-            draw_command.start = vertex_buffer_idx;
-            draw_command.count = mesh.vertices.size();
+            draw_command.start = mesh.vertex_first;
+            draw_command.count = mesh.vertex_count;
         }
 
-        draw_commands.emplace_back( draw_command );
+        draw_command.first_instance = instance_entities.size();
+        draw_command.instance_count = entities.size();
 
-        vertex_buffer_idx += mesh.vertices.size();
-    };
+        instance_entities.insert( instance_entities.end(), entities.begin(), entities.end() );
+        draw_commands.push_back( draw_command );
+    }
 
-    glBindBuffer( GL_ARRAY_BUFFER, vbo );
-    glBufferData( GL_ARRAY_BUFFER, vertex_buffer.size() * sizeof(vertex), (void*)vertex_buffer.data(), GL_DYNAMIC_DRAW );
+    commands_changed = false;
+}
 
-    if( !index_buffer.empty() ) {
-        glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, ibo );
-        glBufferData( GL_ELEMENT_ARRAY_BUFFER, index_buffer.size() * sizeof(unsigned int), (void*)index_buffer.data(), GL_DYNAMIC_DRAW );
+void MeshRenderer::upload_instances( const World& world )
+{
+    instances.resize( instance_entities.size() );
+
+    for( size_t i = 0; i < instance_entities.size(); ++i ) {
+
+        Entity entity = instance_entities[i];
+        auto * mesh = world.get_component<MeshComponent>( entity );
+
+        instance placement { glm::vec3( 0.0f ), mesh->scale, glm::vec2( 1.0f, 0.0f ) };
+
+        if( auto * transform = world.get_component<TransformComponent>( entity ) ) {
+            placement.translation = transform->translation;
+            placement.scale *= transform->scale;
+            placement.rotation = glm::vec2( std::cos( transform->rotation.z ), std::sin( transform->rotation.z ) );
+        }
+
+        instances[i] = placement;
+    }
+
+    glBindBuffer( GL_ARRAY_BUFFER, instance_vbo );
+
+    if( instances.size() != sent_instances.size() ) {
+        glBufferData( GL_ARRAY_BUFFER, instances.size() * sizeof(instance), (void*)instances.data(), GL_DYNAMIC_DRAW );
+        uploaded_bytes += instances.size() * sizeof(instance);
+        sent_instances = instances;
+        return;
+    }
+
+    // only the span from the first to the last entity that moved is sent
+    size_t first = 0;
+    while( first < instances.size() && !std::memcmp( &instances[first], &sent_instances[first], sizeof(instance) ) )
+        ++first;
+
+    if( first == instances.size() )
+        return;
+
+    size_t last = instances.size() - 1;
+    while( !std::memcmp( &instances[last], &sent_instances[last], sizeof(instance) ) )
+        --last;
+
+    size_t count = last - first + 1;
+
+    glBufferSubData( GL_ARRAY_BUFFER, first * sizeof(instance), count * sizeof(instance), (void*)( instances.data() + first ) );
+    uploaded_bytes += count * sizeof(instance);
+
+    std::copy( instances.begin() + first, instances.begin() + last + 1, sent_instances.begin() + first );
+}
+
+void MeshRenderer::upload_range( const Resident& mesh, size_t vertex_first, size_t vertex_count, size_t index_first, size_t index_count )
+{
+    const MeshData& data = *mesh.data;
+
+    if( vertex_count ) {
+
+        std::vector<vertex> vertex_buffer;
+        vertex_buffer.reserve( vertex_count );
+        for( size_t i = vertex_first; i < vertex_first + vertex_count; ++i )
+            vertex_buffer.push_back( { data.vertices[i], data.colours[i] } );
+
+        glBindBuffer( GL_ARRAY_BUFFER, vbo );
+        glBufferSubData( GL_ARRAY_BUFFER, ( mesh.vertex_first + vertex_first ) * sizeof(vertex), vertex_buffer.size() * sizeof(vertex), (void*)vertex_buffer.data() );
+        uploaded_bytes += vertex_buffer.size() * sizeof(vertex);
     }
+
+    if( !index_count || data.indices.empty() )
+        return;
+
+    // indices go as they are, the draw adds the mesh's first vertex. The element array binding
+    // belongs to the vertex array, so the index buffer is written through the copy target
+    glBindBuffer( GL_COPY_WRITE_BUFFER, ibo );
+    glBufferSubData( GL_COPY_WRITE_BUFFER, ( mesh.index_first + index_first ) * sizeof(unsigned int), index_count * sizeof(unsigned int), (void*)( data.indices.data() + index_first ) );
+    uploaded_bytes += index_count * sizeof(unsigned int);
 }
 
 void MeshRenderer::draw()
@@ -135,12 +389,20 @@ void MeshRenderer::draw()
     shader.activate();
 
     glBindVertexArray(vao);
+    glBindBuffer( GL_ARRAY_BUFFER, instance_vbo );
 
     for( auto draw_command : draw_commands ) {
+
+        // without base instances in GL 3.3 the instance attributes start at the draw's first instance
+        size_t offset = draw_command.first_instance * sizeof(instance);
+        glVertexAttribPointer( 2, 3, GL_FLOAT, GL_FALSE, sizeof(instance), (void*)( offset + offsetof( instance, translation ) ) );
+        glVertexAttribPointer( 3, 3, GL_FLOAT, GL_FALSE, sizeof(instance), (void*)( offset + offsetof( instance, scale ) ) );
+        glVertexAttribPointer( 4, 2, GL_FLOAT, GL_FALSE, sizeof(instance), (void*)( offset + offsetof( instance, rotation ) ) );
+
         if( draw_command.indexed )
-            glDrawElements( draw_command.mode, draw_command.count, GL_UNSIGNED_INT, (void *)(draw_command.start * sizeof(unsigned int)) );
+            glDrawElementsInstancedBaseVertex( draw_command.mode, draw_command.count, GL_UNSIGNED_INT, (void *)(draw_command.start * sizeof(unsigned int)), draw_command.instance_count, draw_command.base_vertex );
         else
-            glDrawArrays( draw_command.mode, draw_command.start, draw_command.count );
+            glDrawArraysInstanced( draw_command.mode, draw_command.start, draw_command.count, draw_command.instance_count );
     }
 
     glBindVertexArray(0);
@@ -154,7 +416,16 @@ void MeshRenderer::set_mvp( glm::mat4 &mvp )
 
 void MeshRenderer::destroy()
 {
+    if( instance_vbo ) glDeleteBuffers( 1, &instance_vbo );
     if( ibo ) glDeleteBuffers( 1, &ibo );
     if( vbo ) glDeleteBuffers( 1, &vbo );
     if( vao ) glDeleteVertexArrays( 1, &vao );
+
+    resident.clear();
+    drawn.clear();
+    vertex_ranges = RangeAllocator();
+    index_ranges = RangeAllocator();
+    draw_commands.clear();
+    sent_instances.clear();
+    commands_changed = true;
 }
@@ -19,13 +19,19 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <unordered_map>
 
 #include <glm/glm.hpp>
 
 #include "base_renderer.h"
+#include "range_allocator.h"
 #include "shader.h"
+#include "../core/world.h"
+
+struct MeshData;
 
 class MeshRenderer : public BaseRenderer
 {
@@ -37,23 +43,82 @@ public:
 
     void set_mvp( glm::mat4& mvp ) override;
 
+    // sent to the GPU by the last upload, nothing when no mesh changed and no entity moved
+    size_t get_uploaded_bytes() const { return uploaded_bytes; }
+
 private:
     Shader shader;
     unsigned vao = 0;
     unsigned vbo = 0;
     unsigned ibo = 0;
+    unsigned instance_vbo = 0;
 
     struct vertex {
         glm::vec3 position;
         glm::vec3 colour;
     };
 
+    // where an entity puts the shared mesh: rotated about z by the angle given as cos and sin, then scaled and moved
+    struct instance {
+        glm::vec3 translation;
+        glm::vec3 scale;
+        glm::vec2 rotation;
+    };
+
     struct DrawCommand {
         unsigned int mode;
         int start;
         unsigned int count;
         bool indexed = false;
+        int base_vertex = 0;
+        size_t first_instance = 0;
+        size_t instance_count = 0;
     };
 
     std::vector<DrawCommand> draw_commands;
+
+    // a mesh's ranges of the shared buffers. It is uploaded when the first entity draws it, again
+    // only when it changes, and its ranges are freed when the last entity stops drawing it
+    struct Resident {
+        std::shared_ptr<const MeshData> data;
+        uint64_t version;
+        size_t vertex_first;
+        size_t vertex_count;
+        size_t index_first;
+        size_t index_count;
+        size_t users = 0;
+    };
+
+    // what an entity drew the last frame it was seen
+    struct Drawn {
+        const MeshData * mesh = nullptr;
+        unsigned int mode = 0;
+        uint64_t frame = 0;
+    };
+
+    std::unordered_map<const MeshData*, Resident> resident;
+    std::unordered_map<Entity, Drawn> drawn;
+    RangeAllocator vertex_ranges;
+    RangeAllocator index_ranges;
+    uint64_t frame = 0;
+    bool commands_changed = true;
+
+    // every entity drawing the same mesh the same way is one instanced draw, the instances are in
+    // the order of the draws. sent_instances is what the GPU has
+    std::vector<Entity> instance_entities;
+    std::vector<instance> instances;
+    std::vector<instance> sent_instances;
+
+    size_t uploaded_bytes = 0;
+
+    void track( const World& world );
+    void acquire( const std::shared_ptr<const MeshData>& data );
+    void release( const MeshData * mesh );
+    void refresh();
+    void place( Resident& mesh );
+    size_t allocate( RangeAllocator& ranges, unsigned& buffer, size_t element_size, size_t count );
+    void bind_buffers();
+    void upload_range( const Resident& mesh, size_t vertex_first, size_t vertex_count, size_t index_first, size_t index_count );
+    void rebuild_commands();
+    void upload_instances( const World& world );
 };
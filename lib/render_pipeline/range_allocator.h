@@ -0,0 +1,93 @@
+/*
+ * range_allocator.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <map>
+
+// hands out ranges of a buffer, first fit. Freed ranges merge with free neighbours again
+class RangeAllocator
+{
+public:
+	static constexpr size_t npos = (size_t)-1;
+
+	// npos when no free range is large enough, an empty range is at 0
+	size_t allocate( size_t count )
+	{
+		if( !count )
+			return 0;
+
+		for( auto it = free_ranges.begin(); it != free_ranges.end(); ++it ) {
+
+			if( it->second < count )
+				continue;
+
+			size_t first = it->first;
+			size_t left = it->second - count;
+
+			free_ranges.erase( it );
+			if( left )
+				free_ranges.emplace( first + count, left );
+
+			return first;
+		}
+
+		return npos;
+	}
+
+	void release( size_t first, size_t count )
+	{
+		if( !count )
+			return;
+
+		auto next = free_ranges.lower_bound( first );
+
+		if( next != free_ranges.end() && first + count == next->first ) {
+			count += next->second;
+			next = free_ranges.erase( next );
+		}
+
+		if( next != free_ranges.begin() ) {
+			auto previous = std::prev( next );
+			if( previous->first + previous->second == first ) {
+				previous->second += count;
+				return;
+			}
+		}
+
+		free_ranges.emplace_hint( next, first, count );
+	}
+
+	// what lies past the old capacity is free
+	void grow( size_t to )
+	{
+		if( to > capacity ) {
+			release( capacity, to - capacity );
+			capacity = to;
+		}
+	}
+
+	size_t get_capacity() const { return capacity; }
+
+private:
+	std::map<size_t, size_t> free_ranges;		// first to count
+	size_t capacity = 0;
+};
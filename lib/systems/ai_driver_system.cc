@@ -0,0 +1,167 @@
+/*
+ * ai_driver_system.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include "ai_driver_system.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../core/engine.h"
+#include "../core/view.h"
+#include "../geometry/track_index.h"
+
+#include "vehicle_system.h"
+
+#include "../components/ai_driver_component.h"
+#include "../components/track_component.h"
+#include "../components/transform_component.h"
+#include "../components/vehicle_component.h"
+
+constexpr float gravity = 9.81f;
+
+void DriverBatch::resize( size_t count )
+{
+	position.resize( count );
+	segment.resize( count );
+
+	for( auto * column : { &heading, &speed, &grip, &drive, &wheelbase, &max_steer, &look_ahead, &min_look_ahead, &throttle, &brake, &steer } )
+		column->resize( count );
+}
+
+void AIDriverSystem::update( double elapsed )
+{
+	auto& world = engine->get_world();
+
+	std::shared_ptr<const TrackIndex> circuit;
+
+	for( auto [entity, track] : world.view<TrackComponent>() )
+		if( track.closed && track.index && !track.index->empty() ) {
+			circuit = track.index;
+			break;
+		}
+
+	if( circuit != index ) {
+
+		index = circuit;
+		line = RacingLine();
+		segments.clear();
+
+		if( index )
+			line.build( *index );
+	}
+
+	std::erase_if( segments, [&world]( auto& car ) { return !world.get_component<AIDriverComponent>( car.first ); } );
+
+	if( !index || line.empty() )
+		return;
+
+	entities.clear();
+	for( auto [entity, driver, vehicle, transform] : world.view<AIDriverComponent, VehicleComponent, TransformComponent>() )
+		entities.push_back( entity );
+
+	batch.resize( entities.size() );
+
+	for( size_t i = 0; i < entities.size(); ++i ) {
+
+		auto * driver = world.get_component<AIDriverComponent>( entities[i] );
+		auto * vehicle = world.get_component<VehicleComponent>( entities[i] );
+		auto * transform = world.get_component<TransformComponent>( entities[i] );
+
+		float heading = transform->rotation.z;
+
+		batch.position[i] = glm::vec2( transform->translation.x, transform->translation.y );
+		batch.heading[i] = heading;
+		batch.speed[i] = glm::dot( vehicle->velocity, glm::vec2( std::cos( heading ), std::sin( heading ) ) );
+		batch.grip[i] = vehicle->grip * gravity * driver->pace * ( vehicle->on_track ? 1.0f : VehicleSystem::off_track_grip );
+		batch.drive[i] = vehicle->engine_force / vehicle->mass;
+		batch.wheelbase[i] = vehicle->wheelbase;
+		batch.max_steer[i] = vehicle->max_steer;
+		batch.look_ahead[i] = driver->look_ahead;
+		batch.min_look_ahead[i] = driver->min_look_ahead;
+
+		auto it = segments.find( entities[i] );
+		batch.segment[i] = it != segments.end() ? it->second : uint32_t( index->query( batch.position[i] ).segment );
+	}
+
+	if( !pool )
+		pool = std::make_unique<WorkerPool>( threads );
+
+	decide( *index, line, batch, *pool );
+
+	for( size_t i = 0; i < entities.size(); ++i ) {
+
+		auto * vehicle = world.get_component<VehicleComponent>( entities[i] );
+
+		vehicle->throttle = batch.throttle[i];
+		vehicle->brake = batch.brake[i];
+		vehicle->steer = batch.steer[i];
+
+		segments[ entities[i] ] = batch.segment[i];
+	}
+}
+
+void AIDriverSystem::decide( const TrackIndex& index, const RacingLine& line, DriverBatch& batch, size_t first, size_t last )
+{
+	const float response = 0.5f;		// throttle or brake per m/s off the speed wanted
+	const float reaction = 0.2f;		// s, the speed wanted is the one a little ahead
+
+	for( size_t i = first; i < last; ++i ) {
+
+		TrackQuery q = index.query_from( batch.position[i], batch.segment[i] );
+		batch.segment[i] = uint32_t( q.segment );
+
+		size_t here = line.at( q.arc_length );
+		float speed = std::max( batch.speed[i], 0.0f );
+
+		// steer along the arc through the point ahead, pure pursuit
+		glm::vec2 target = line.point( line.ahead( here, std::max( batch.min_look_ahead[i], speed * batch.look_ahead[i] ) ) );
+		glm::vec2 forward( std::cos( batch.heading[i] ), std::sin( batch.heading[i] ) );
+		glm::vec2 offset = target - batch.position[i];
+
+		float across = forward.x * offset.y - forward.y * offset.x;
+		float distance = std::max( glm::length( offset ), 1e-3f );
+		float curvature = 2.0f * across / ( distance * distance );
+
+		// a point behind is turned towards as hard as one beside the car
+		if( glm::dot( forward, offset ) < 0.0f )
+			curvature = std::copysign( 2.0f / distance, across );
+
+		batch.steer[i] = std::clamp( std::atan( curvature * batch.wheelbase[i] ) / batch.max_steer[i], -1.0f, 1.0f );
+
+		// no faster than the line allows, nor than the car can turn onto the point ahead
+		float allowed = std::min( line.speed_squared( line.ahead( here, speed * reaction ) ), 1.0f / std::max( std::abs( curvature ), 1e-4f ) );
+		float wanted = std::sqrt( batch.grip[i] * allowed );
+		float error = wanted - batch.speed[i];
+
+		// never more throttle than the tyres can put down, or they have nothing left to turn with
+		batch.throttle[i] = std::clamp( std::min( error * response, batch.grip[i] / batch.drive[i] ), 0.0f, 1.0f );
+		batch.brake[i] = std::clamp( -error * response, 0.0f, 1.0f );
+	}
+}
+
+void AIDriverSystem::decide( const TrackIndex& index, const RacingLine& line, DriverBatch& batch, WorkerPool& pool )
+{
+	size_t count = batch.size();
+
+	pool.run( ( count + block - 1 ) / block, [&]( size_t b )
+	{
+		decide( index, line, batch, b * block, std::min( count, ( b + 1 ) * block ) );
+	} );
+}
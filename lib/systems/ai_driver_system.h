@@ -0,0 +1,92 @@
+/*
+ * ai_driver_system.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "../core/parallel.h"
+#include "../core/system.h"
+#include "../core/world.h"
+#include "../geometry/racing_line.h"
+
+class TrackIndex;
+
+// the cars the AI drives this tick, one entry per car in each array
+struct DriverBatch
+{
+	std::vector<glm::vec2> position;
+	std::vector<float> heading, speed;		// speed along the heading
+	std::vector<float> grip;				// m/s^2 the tyres give, times the driver's pace
+	std::vector<float> drive;				// m/s^2 at full throttle
+	std::vector<float> wheelbase, max_steer, look_ahead, min_look_ahead;
+	std::vector<uint32_t> segment;			// of the centreline, carried from tick to tick
+
+	std::vector<float> throttle, brake, steer;
+
+	size_t size() const { return position.size(); }
+	void resize( size_t count );
+};
+
+/*
+ * Drives the cars with an AIDriverComponent round the first closed track. The racing line is made
+ * once for each version of the track; after that a car costs the same each tick wherever it is:
+ * find itself on the line from where it was, steer for a point ahead on it and hold the speed the
+ * line allows there. Cars are decided in blocks spread over a pool of threads that lives as long as
+ * the system.
+ */
+class AIDriverSystem : public BaseSystem<AIDriverSystem>
+{
+public:
+	static constexpr size_t block = 256;
+
+	AIDriverSystem( Engine* eng ) : BaseSystem<AIDriverSystem>( eng ) {};
+
+	void update( double elapsed ) override;
+	void rewind() override { segments.clear(); }
+
+	const RacingLine& get_racing_line() const { return line; }
+
+	// for the pool, 0 for all of the hardware's. One when the worlds themselves are run in parallel
+	void set_threads( unsigned count ) { threads = count; pool.reset(); }
+
+	// decides cars [first, last) of the batch
+	static void decide( const TrackIndex& index, const RacingLine& line, DriverBatch& batch, size_t first, size_t last );
+
+	// all of the batch, block by block over the pool
+	static void decide( const TrackIndex& index, const RacingLine& line, DriverBatch& batch, WorkerPool& pool );
+
+private:
+	std::unique_ptr<WorkerPool> pool;
+	unsigned threads = 0;
+
+	std::shared_ptr<const TrackIndex> index;
+	RacingLine line;
+
+	DriverBatch batch;
+	std::vector<Entity> entities;
+	std::unordered_map<Entity, uint32_t> segments;		// per car, between ticks
+};
@@ -0,0 +1,47 @@
+/*
+ * collision_system.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include "collision_system.h"
+
+#include <cmath>
+
+#include "../core/engine.h"
+#include "../core/view.h"
+
+#include "../components/collider_component.h"
+#include "../components/transform_component.h"
+
+void CollisionSystem::update( double elapsed )
+{
+	auto& world = engine->get_world();
+
+	boxes.clear();
+	entities.clear();
+
+	for( auto [entity, collider, transform] : world.view<ColliderComponent, TransformComponent>() ) {
+
+		float heading = transform.rotation.z;
+
+		boxes.push_back( { glm::vec2( transform.translation.x, transform.translation.y ), glm::vec2( std::cos( heading ), std::sin( heading ) ), collider.half_extents } );
+		entities.push_back( entity );
+	}
+
+	sweep.contacts( boxes, contacts );
+}
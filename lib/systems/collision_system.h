@@ -0,0 +1,51 @@
+/*
+ * collision_system.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include "../core/system.h"
+#include "../core/world.h"
+#include "../geometry/collision.h"
+
+/*
+ * Finds the touching pairs among the entities with a ColliderComponent each frame and keeps them
+ * as a list of contacts. It does not push anything apart itself: VehicleSystem, which runs after it,
+ * takes the contacts on its cars before it moves them, anything else with a collider stands still.
+ */
+class CollisionSystem : public BaseSystem<CollisionSystem>
+{
+public:
+    CollisionSystem( Engine* eng ) : BaseSystem<CollisionSystem>( eng ) {};
+
+    void update( double elapsed ) override;
+    void rewind() override { update( 0.0 ); }      // the contacts the restored cars were left with
+
+    // as of the last update, a and b index get_entity
+    const std::vector<Contact>& get_contacts() const { return contacts; }
+    Entity get_entity( uint32_t index ) const { return entities[index]; }
+
+private:
+    SweepAndPrune sweep;
+    std::vector<Box> boxes;
+    std::vector<Entity> entities;
+    std::vector<Contact> contacts;
+};
@@ -25,6 +25,13 @@
 #include "../core/world.h"
 #include "../core/engine.h"
 #include "../core/view.h"
+#include "../core/hash.h"
+
+#include "resource_system.h"
+#include "render_system.h"
+
+#include "../geometry/kernels.h"
+#include "../geometry/lod.h"
 
 #include "../components/geometry_component.h"
 #include "../components/mesh_component.h"
@@ -33,11 +40,30 @@ void GeometrySystem::update( double elapsed )
 {
 	auto& world = engine->get_world();
 
-	for( auto [entity, geometry] : world.view<GeometryComponent>() )
+	auto * render = engine->get_system<RenderSystem>();
+	float units = render ? render->world_units_per_pixel() : 0.0f;
+
+	for( auto [entity, geometry] : world.view<GeometryComponent>() ) {
+
+		bool changed = geometry.dirty;
+
 		if( geometry.dirty ) {
 			regenerate_mesh(  world, entity, geometry );
 			geometry.dirty = false;
 		}
+
+		if( geometry.lods.empty() )
+			continue;
+
+		// all levels are made up front, changing the level is only changing the mesh drawn
+		int level = units > 0.0f ? lod::select_level( geometry.segments, geometry.lod, glm::max( geometry.axis_a, geometry.axis_b ) / units ) : 0;
+
+		if( changed || level != geometry.lod ) {
+			geometry.lod = level;
+			if( auto * mesh = world.get_component<MeshComponent>( entity ) )
+				mesh->data = geometry.lods[level];
+		}
+	}
 }
 
 void GeometrySystem::regenerate_mesh( World &world, Entity ent, GeometryComponent &geometry )
@@ -50,45 +76,66 @@ void GeometrySystem::regenerate_mesh( World &world, Entity ent, GeometryComponen
 	}
 
     mesh->topology = geometry.filled ? MeshComponent::Topology::TRIANGLE_FAN : MeshComponent::Topology::LINE_LOOP;
-	mesh->vertices.clear();
-	mesh->colours.clear();
-	mesh->indices.clear();
 
-	float a = glm::max(geometry.axis_a, geometry.axis_b);
-	float b = glm::min(geometry.axis_a, geometry.axis_b);
+	// ellipses share a unit circle, the axes only size this entity's copy of it
+	mesh->scale = glm::vec3( glm::max( geometry.axis_a, geometry.axis_b ), glm::min( geometry.axis_a, geometry.axis_b ), 1.0f );
 
-	std::vector<glm::vec3> points;
-	for( int i = 0; i < geometry.segments; i++ ) {
+	auto * resources = engine->get_system<ResourceSystem>();
+
+	geometry.lods.clear();
 
-		float t = (float)i / geometry.segments * glm::two_pi<float>();
-		points.push_back( glm::vec3( a * cos(t), b * sin(t), 0.0f ) );
+	for( int level = 0; level < lod::level_count( geometry.segments ); ++level ) {
+
+		int segments = lod::level_segments( geometry.segments, level );
+
+		Hasher key;
+		key.add( std::string( "circle" ) ).add( mesh_version ).add( segments ).add( geometry.filled ).add( geometry.colour );
+
+		geometry.lods.push_back( resources->acquire<MeshData>( key.value(), [&geometry, segments]() { return generate_mesh( geometry, segments ); } ) );
 	}
+}
+
+MeshData GeometrySystem::generate_mesh( const GeometryComponent &geometry, int segments )
+{
+	MeshData mesh;
+
+	size_t count = segments > 0 ? size_t( segments ) : 0;
+
+	std::vector<float> sines( count ), cosines( count );
+	kernels::sincos_steps( 0.0f, glm::two_pi<float>() / segments, sines.data(), cosines.data(), count );
+
+	std::vector<glm::vec3> points;
+	points.reserve( count );
+	for( size_t i = 0; i < count; i++ )
+		points.push_back( glm::vec3( cosines[i], sines[i], 0.0f ) );
 
 	if( geometry.filled ) {
 
 		glm::vec3 center(0.0f, 0.0f, 0.0f);
-        mesh->vertices.push_back(center);
-        mesh->colours.push_back(geometry.colour);
+        mesh.vertices.push_back(center);
+        mesh.colours.push_back(geometry.colour);
 
-		for (int i = 0; i < geometry.segments; i++)
+		for (int i = 0; i < segments; i++)
 		{
-            int next = (i + 1) % geometry.segments;
+            int next = (i + 1) % segments;
 
-            mesh->vertices.push_back(points[i]);
-            mesh->colours.push_back(geometry.colour);
+            mesh.vertices.push_back(points[i]);
+            mesh.colours.push_back(geometry.colour);
 
-            mesh->vertices.push_back(points[next]);
-            mesh->colours.push_back(geometry.colour);
+            mesh.vertices.push_back(points[next]);
+            mesh.colours.push_back(geometry.colour);
         }
 	} else {
 
         for( auto &p : points ) {
 
-            mesh->vertices.push_back(p);
-            mesh->colours.push_back(geometry.colour);
+            mesh.vertices.push_back(p);
+            mesh.colours.push_back(geometry.colour);
         }
 
-        mesh->vertices.push_back(points[0]);
-        mesh->colours.push_back(geometry.colour);
+        mesh.vertices.push_back(points[0]);
+        mesh.colours.push_back(geometry.colour);
     }
+
+	return mesh;
 }
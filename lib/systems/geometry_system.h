@@ -24,6 +24,7 @@
 #include "../core/world.h"
 
 struct GeometryComponent;
+struct MeshData;
 
 class GeometrySystem : public BaseSystem<GeometrySystem>
 {
@@ -33,5 +34,8 @@ public:
     void update(double elapsed ) override;
 
 private:
-    void regenerate_mesh( World& world, Entity ent, GeometryComponent& track );
+    void regenerate_mesh( World& world, Entity ent, GeometryComponent& geometry );
+
+    static MeshData generate_mesh( const GeometryComponent& geometry, int segments );
+    static constexpr uint32_t mesh_version = 3;     // in the cache key, up by one whenever generate_mesh changes what it makes
 };
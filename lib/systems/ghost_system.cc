@@ -0,0 +1,167 @@
+/*
+ * ghost_system.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include "ghost_system.h"
+
+#include <cmath>
+
+#include "../core/engine.h"
+#include "../core/view.h"
+
+#include "timing_system.h"
+#include "vehicle_system.h"
+
+#include "../components/ghost_component.h"
+#include "../components/transform_component.h"
+
+void GhostSystem::update( double elapsed )
+{
+	auto& world = engine->get_world();
+
+	// the cars' own clock when they have one, which TimingSystem times the laps on
+	clock += elapsed;
+	auto * vehicles = engine->get_system<VehicleSystem>();
+	double time = vehicles ? vehicles->get_time() : clock;
+	double step = last_time < 0.0 ? 0.0 : time - last_time;
+	last_time = time;
+
+	std::erase_if( recordings, [&world]( auto& recording ) { return !world.get_component<TransformComponent>( recording.first ); } );
+
+	auto * timing = engine->get_system<TimingSystem>();
+
+	for( auto& [car, recording] : recordings ) {
+
+		if( recording.sampled && time <= recording.time )
+			continue;
+
+		auto& transform = *world.get_component<TransformComponent>( car );
+		double lap_start = timing ? timing->get_lap_start( car ) : -1.0;
+
+		// the line was crossed between the last sample and this one
+		if( lap_start != recording.lap_start ) {
+
+			if( recording.lap_start >= 0.0 && lap_start > recording.lap_start ) {
+				recording.encoder.add( time, transform );
+				finish( car, recording, lap_start );
+			}
+			else
+				recording.encoder.finish();
+
+			if( lap_start >= 0.0 && recording.sampled )
+				recording.encoder.add( recording.time, recording.transform );
+
+			recording.lap_start = lap_start;
+		}
+
+		// only the last sample is kept until the car is timed
+		if( recording.lap_start >= 0.0 )
+			recording.encoder.add( time, transform );
+
+		recording.sampled = true;
+		recording.time = time;
+		recording.transform = transform;
+	}
+
+	for( auto [entity, ghost, transform] : world.view<GhostComponent, TransformComponent>() ) {
+
+		auto& lap = ghost.player.get_lap();
+		if( !lap )
+			continue;
+
+		ghost.time += step;
+		if( ghost.loop && lap->lap_time > 0.0f && ghost.time >= lap->lap_time )
+			ghost.time = std::fmod( ghost.time, double( lap->lap_time ) );
+
+		ghost.player.transform_at( ghost.time + lap->offset, transform );
+	}
+}
+
+// laps under way are dropped, the cars are recorded again from their next lap. The ghosts' times
+// came back with them, they move on from the cars' clock as VehicleSystem put it back (it rewinds first)
+void GhostSystem::rewind()
+{
+	for( auto& [car, recording] : recordings ) {
+		recording.encoder.finish();
+		recording.lap_start = -1.0;
+		recording.sampled = false;
+	}
+
+	auto * vehicles = engine->get_system<VehicleSystem>();
+	last_time = vehicles ? vehicles->get_time() : clock;
+}
+
+void GhostSystem::record( Entity car )
+{
+	recordings.try_emplace( car );
+}
+
+void GhostSystem::stop( Entity car )
+{
+	recordings.erase( car );
+}
+
+std::shared_ptr<const GhostLap> GhostSystem::get_best( Entity car ) const
+{
+	auto it = best.find( car );
+	return it == best.end() ? nullptr : it->second;
+}
+
+std::shared_ptr<const GhostLap> GhostSystem::get_best() const
+{
+	std::shared_ptr<const GhostLap> fastest;
+
+	for( auto& [car, lap] : best )
+		if( !fastest || lap->lap_time < fastest->lap_time )
+			fastest = lap;
+
+	return fastest;
+}
+
+Entity GhostSystem::spawn( std::shared_ptr<const GhostLap> lap, bool loop )
+{
+	auto& registry = engine->get_registry();
+	auto& world = engine->get_world();
+
+	Entity ghost = registry.create_entity();
+	registry.create_component( ghost, "TransformComponent" );
+	registry.create_component( ghost, "GhostComponent" );
+
+	auto * component = world.get_component<GhostComponent>( ghost );
+	double offset = lap ? lap->offset : 0.0;
+
+	component->player = GhostPlayer( std::move( lap ) );
+	component->loop = loop;
+	component->player.transform_at( offset, *world.get_component<TransformComponent>( ghost ) );
+
+	return ghost;
+}
+
+void GhostSystem::finish( Entity car, Recording& recording, double lap_end )
+{
+	double first = recording.encoder.start_time();
+
+	auto lap = std::make_shared<GhostLap>( recording.encoder.finish() );
+	lap->offset = recording.lap_start - first;
+	lap->lap_time = float( lap_end - recording.lap_start );
+
+	auto& kept = best[car];
+	if( !kept || lap->lap_time < kept->lap_time )
+		kept = std::move( lap );
+}
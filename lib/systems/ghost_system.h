@@ -0,0 +1,74 @@
+/*
+ * ghost_system.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+
+#include "../core/system.h"
+#include "../core/world.h"
+#include "../geometry/ghost_stream.h"
+
+/*
+ * Records the laps of the cars it is told to, and plays laps back on ghost entities.
+ *
+ * A recorded car's transform is taken every frame. When TimingSystem sees the car start a new
+ * lap, the lap before is finished, with the samples either side of both crossings so it can be
+ * played from the line. The car's fastest lap is kept.
+ *
+ * A ghost is an entity with a TransformComponent and a GhostComponent. Its time moves on with the
+ * cars' clock, and its transform is the lap's at that time.
+ */
+class GhostSystem : public BaseSystem<GhostSystem>
+{
+public:
+	GhostSystem( Engine* eng ) : BaseSystem<GhostSystem>( eng ) {};
+
+	void update( double elapsed ) override;
+	void rewind() override;
+
+	void record( Entity car );
+	void stop( Entity car );
+
+	// the car's fastest lap so far, or the fastest of all cars
+	std::shared_ptr<const GhostLap> get_best( Entity car ) const;
+	std::shared_ptr<const GhostLap> get_best() const;
+
+	Entity spawn( std::shared_ptr<const GhostLap> lap, bool loop = true );
+
+private:
+	struct Recording
+	{
+		GhostEncoder encoder;
+		double lap_start = -1.0;			// on the cars' clock, while a timed lap is recorded
+		bool sampled = false;
+		double time = 0.0;					// of the last sample
+		TransformComponent transform;
+	};
+
+	std::unordered_map<Entity, Recording> recordings;
+	std::unordered_map<Entity, std::shared_ptr<const GhostLap>> best;
+
+	double clock = 0.0;
+	double last_time = -1.0;
+
+	void finish( Entity car, Recording& recording, double lap_end );
+};
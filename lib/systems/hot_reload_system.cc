@@ -0,0 +1,38 @@
+/*
+ * hot_reload_system.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "hot_reload_system.h"
+
+#include <memory>
+
+#include "../core/engine.h"
+#include "../commands/reload_request.h"
+
+void HotReloadSystem::input()
+{
+	auto& scene = engine->get_scene();
+
+	if( scene.filename != watched ) {
+		watched = scene.filename;
+		watcher.watch( watched );
+	}
+
+	if( watcher.changed() )
+		engine->push_command( std::make_unique<ReloadRequest>( watched ) );
+}
@@ -0,0 +1,177 @@
+/*
+ * lake_system.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "lake_system.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "../core/world.h"
+#include "../core/engine.h"
+#include "../core/view.h"
+#include "../core/hash.h"
+#include "../core/parallel.h"
+
+#include "../components/lake_component.h"
+#include "../components/mesh_component.h"
+
+#include "../geometry/distance_field.h"
+#include "../geometry/lod.h"
+#include "../geometry/track_index.h"
+#include "../geometry/triangulation.h"
+
+#include "resource_system.h"
+#include "render_system.h"
+
+void LakeSystem::update( double elapsed )
+{
+	auto& world = engine->get_world();
+	auto * resources = engine->get_system<ResourceSystem>();
+
+	std::vector<LakeComponent*> dirty;
+
+	for( auto [entity, lake] : world.view<LakeComponent>() )
+		if( lake.dirty )
+			dirty.push_back( &lake );
+
+	// every lake is independent and the resource cache is thread safe
+	parallel_for( dirty.size(), [&]( size_t i )
+	{
+		LakeComponent& lake = *dirty[i];
+
+		Hasher parameters;
+		parameters.add( std::string( "lake" ) ).add( outline_version ).add( lake.lake_axis_length ).add( lake.lake_freq ).add( lake.lake_amp )
+			.add( lake.island_radius ).add( lake.island_freq ).add( lake.island_amp );
+
+		lake.surfaces.clear();
+
+		for( int level = 0; level < lod::level_count( lake.segments ); ++level ) {
+
+			int segments = lod::level_segments( lake.segments, level );
+
+			Hasher key = parameters;
+			key.add( segments );
+
+			auto outline = resources->acquire<LakeOutline>( key.value(), [&lake, segments]() { return lake.generate_lake( segments ); } );
+
+			key.add( std::string( "surface" ) ).add( surface_version );
+			lake.surfaces.push_back( resources->acquire<MeshData>( key.value(), [&outline]() { return generate_surface( *outline ); } ) );
+
+			if( level == 0 )
+				lake.outline = outline;
+		}
+
+		lake.field = field_spacing > 0.0f ? bake_field( *lake.outline, field_spacing ) : nullptr;
+
+		lake.surface = nullptr;
+		lake.dirty = false;
+	} );
+
+	auto * render = engine->get_system<RenderSystem>();
+	float units = render ? render->world_units_per_pixel() : 0.0f;
+
+	for( auto [entity, lake] : world.view<LakeComponent>() ) {
+
+		if( lake.surfaces.empty() )
+			continue;
+
+		float radius = glm::max( lake.lake_axis_length[0], lake.lake_axis_length[1] ) * ( 1.0f + lake.lake_amp );
+
+		lake.lod = units > 0.0f ? lod::select_level( lake.segments, lake.lod, radius / units ) : 0;
+		lake.surface = lake.surfaces[ lake.lod ];
+	}
+}
+
+static bool inside( const std::vector<glm::vec2>& polygon, glm::vec2 p )
+{
+	bool inside = false;
+
+	for( size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++ )
+		if( ( polygon[i].y > p.y ) != ( polygon[j].y > p.y ) && p.x < polygon[i].x + ( p.y - polygon[i].y ) * ( polygon[j].x - polygon[i].x ) / ( polygon[j].y - polygon[i].y ) )
+			inside = !inside;
+
+	return inside;
+}
+
+std::shared_ptr<const DistanceField> LakeSystem::bake_field( const LakeOutline& outline, float spacing )
+{
+	if( outline.lake.size() < 3 )
+		return nullptr;
+
+	TrackIndex shore, island;
+	shore.build( outline.lake, true, 0.0f );
+	island.build( outline.island, true, 0.0f );
+
+	// water is inside the shore and outside the island
+	auto distance = [&]( glm::vec2 p )
+	{
+		float to_shore = shore.query( p ).distance * ( inside( outline.lake, p ) ? -1.0f : 1.0f );
+
+		if( island.empty() )
+			return to_shore;
+
+		float to_island = island.query( p ).distance * ( inside( outline.island, p ) ? -1.0f : 1.0f );
+		return std::max( to_shore, -to_island );
+	};
+
+	glm::vec2 low( std::numeric_limits<float>::max() ), high( -std::numeric_limits<float>::max() );
+	for( auto& p : outline.lake ) {
+		low = glm::min( low, p );
+		high = glm::max( high, p );
+	}
+
+	auto field = std::make_shared<DistanceField>();
+	field->build( low, high, spacing, 8.0f * spacing, distance );
+
+	return field;
+}
+
+MeshData LakeSystem::generate_surface( const LakeOutline& outline )
+{
+	MeshData mesh;
+
+	glm::vec3 lake_colour( 0.0f, 0.3f, 1.0f );
+	glm::vec3 island_colour( 0.2f, 0.8f, 0.2f );
+
+	// the island's outline twice, once as the edge of the water and once as the edge of the land
+	for( auto& p : outline.lake ) {
+		mesh.vertices.push_back( glm::vec3( p, 0.0f ) );
+		mesh.colours.push_back( lake_colour );
+	}
+	for( auto& p : outline.island ) {
+		mesh.vertices.push_back( glm::vec3( p, 0.0f ) );
+		mesh.colours.push_back( lake_colour );
+	}
+
+	mesh.indices = triangulate_polygon( outline.lake, { outline.island } );
+
+	uint32_t land = uint32_t( mesh.vertices.size() );
+
+	for( auto& p : outline.island ) {
+		mesh.vertices.push_back( glm::vec3( p, 0.0f ) );
+		mesh.colours.push_back( island_colour );
+	}
+
+	for( uint32_t index : triangulate_polygon( outline.island ) )
+		mesh.indices.push_back( land + index );
+
+	return mesh;
+}
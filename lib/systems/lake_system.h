@@ -0,0 +1,50 @@
+/*
+ * lake_system.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include "../core/system.h"
+
+#include <cstdint>
+#include <memory>
+
+struct LakeOutline;
+struct MeshData;
+class DistanceField;
+
+class LakeSystem : public BaseSystem<LakeSystem>
+{
+public:
+    LakeSystem( Engine* eng ) : BaseSystem<LakeSystem>( eng ) {};
+
+    void update( double elapsed ) override;
+
+    static MeshData generate_surface( const LakeOutline& outline );
+
+    // in the cache keys, up by one whenever LakeComponent::generate_lake or generate_surface changes what it makes
+    static constexpr uint32_t outline_version = 2;
+    static constexpr uint32_t surface_version = 1;
+    static std::shared_ptr<const DistanceField> bake_field( const LakeOutline& outline, float spacing );
+
+    // lakes get a distance field (see geometry/distance_field.h) sampled every spacing world units, 0 for none
+    void set_field_spacing( float spacing ) { field_spacing = spacing; }
+
+private:
+    float field_spacing = 0.0f;
+};
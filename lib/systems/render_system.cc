@@ -18,6 +18,7 @@
  */
 
 #include <glad/gl.h>
+#include <glm/matrix.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "render_system.h"
@@ -55,6 +56,10 @@ void RenderSystem::update( double elapsed )
 
 void RenderSystem::draw()
 {
+    GLint viewport[4];
+    glGetIntegerv( GL_VIEWPORT, viewport );
+    viewport_height = viewport[3];
+
 	glClearColor( 0.2F, 0.8F, 0.2F, 1.0F );
 	glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
 
@@ -70,6 +75,26 @@ void RenderSystem::set_camera( const glm::mat4 &view, const glm::mat4 &proj )
         r->set_mvp(mvp);
 }
 
+glm::vec2 RenderSystem::view_centre() const
+{
+    glm::vec4 centre = glm::inverse( mvp ) * glm::vec4( 0.0f, 0.0f, 0.0f, 1.0f );
+
+    return glm::vec2( centre.x, centre.y ) / centre.w;
+}
+
+float RenderSystem::world_units_per_pixel() const
+{
+    if( viewport_height <= 0 )
+        return 0.0f;
+
+    // the world length of the window's height, which is 2 in clip space
+    glm::mat4 inverse = glm::inverse( mvp );
+    glm::vec4 bottom = inverse * glm::vec4( 0.0f, -1.0f, 0.0f, 1.0f );
+    glm::vec4 top = inverse * glm::vec4( 0.0f, 1.0f, 0.0f, 1.0f );
+
+    return glm::distance( glm::vec2( top.x, top.y ), glm::vec2( bottom.x, bottom.y ) ) / viewport_height;
+}
+
 void RenderSystem::make_renderers()
 {
     // renderers will be drawn in the order of insertion
@@ -41,10 +41,13 @@ public:
     void draw() override;
 
     void set_camera( const glm::mat4& view, const glm::mat4& proj );
+    glm::vec2 view_centre() const;      // the world position in the middle of the window
+    float world_units_per_pixel() const;    // 0 until the first frame has been drawn
 
 private:
     GLFWwindow* window = nullptr;
     glm::mat4 mvp;
+    int viewport_height = 0;
     std::vector<std::unique_ptr<BaseRenderer>> renderers;
 
     void make_renderers();
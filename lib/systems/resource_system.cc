@@ -17,8 +17,111 @@
   * MA 02110-1301, USA.
   */
 
+
 #include "resource_system.h"
 
+#include <cstdlib>
+#include <cstdio>
+#include <vector>
+
 #include "../core/world.h"
 #include "../core/engine.h"
 #include "../core/registry.h"
+
+#include "../components/mesh_component.h"
+#include "../components/lake_component.h"
+
+constexpr unsigned eviction_frames = 600;		// unused resources stay around this long for the next reload
+constexpr uint32_t file_magic = 0x43525452;		// "RTRC"
+constexpr uint32_t file_version = 1;
+
+ResourceSystem::ResourceSystem( Engine *eng ) : BaseSystem<ResourceSystem>( eng )
+{
+	if( const char * xdg = std::getenv( "XDG_CACHE_HOME" ); xdg && *xdg )
+		cache_directory = std::filesystem::path( xdg ) / "racetrack";
+	else if( const char * home = std::getenv( "HOME" ); home && *home )
+		cache_directory = std::filesystem::path( home ) / ".cache" / "racetrack";
+}
+
+void ResourceSystem::update( double elapsed )
+{
+	std::lock_guard<std::mutex> lock( mutex );
+
+	for( auto it = cache.begin(); it != cache.end(); ) {
+
+		if( it->second.resource.use_count() > 1 )
+			it->second.idle_frames = 0;
+		else if( ++it->second.idle_frames > eviction_frames ) {
+			it = cache.erase( it );
+			continue;
+		}
+
+		++it;
+	}
+}
+
+std::filesystem::path ResourceSystem::cache_path( uint64_t key ) const
+{
+	char name[32];
+	std::snprintf( name, sizeof(name), "%016llx.bin", (unsigned long long)key );
+
+	return cache_directory / name;
+}
+
+template<typename T>
+static void write_vector( std::ostream& out, const std::vector<T>& values )
+{
+	uint64_t count = values.size();
+	out.write( reinterpret_cast<const char*>( &count ), sizeof(count) );
+	out.write( reinterpret_cast<const char*>( values.data() ), count * sizeof(T) );
+}
+
+template<typename T>
+static bool read_vector( std::istream& in, std::vector<T>& values )
+{
+	uint64_t count = 0;
+	if( !in.read( reinterpret_cast<char*>( &count ), sizeof(count) ) || count > ( 1ull << 32 ) )
+		return false;
+
+	values.resize( count );
+	return (bool)in.read( reinterpret_cast<char*>( values.data() ), count * sizeof(T) );
+}
+
+static void write_header( std::ostream& out, uint32_t type )
+{
+	uint32_t header[3] = { file_magic, file_version, type };
+	out.write( reinterpret_cast<const char*>( header ), sizeof(header) );
+}
+
+static bool read_header( std::istream& in, uint32_t type )
+{
+	uint32_t header[3] = {};
+	in.read( reinterpret_cast<char*>( header ), sizeof(header) );
+
+	return in && header[0] == file_magic && header[1] == file_version && header[2] == type;
+}
+
+bool read_resource( std::istream &in, MeshData &mesh )
+{
+	return read_header( in, 1 ) && read_vector( in, mesh.vertices ) && read_vector( in, mesh.indices ) && read_vector( in, mesh.colours );
+}
+
+void write_resource( std::ostream &out, const MeshData &mesh )
+{
+	write_header( out, 1 );
+	write_vector( out, mesh.vertices );
+	write_vector( out, mesh.indices );
+	write_vector( out, mesh.colours );
+}
+
+bool read_resource( std::istream &in, LakeOutline &outline )
+{
+	return read_header( in, 2 ) && read_vector( in, outline.lake ) && read_vector( in, outline.island );
+}
+
+void write_resource( std::ostream &out, const LakeOutline &outline )
+{
+	write_header( out, 2 );
+	write_vector( out, outline.lake );
+	write_vector( out, outline.island );
+}
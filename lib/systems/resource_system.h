@@ -19,12 +19,127 @@
 
 #pragma once
 
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <typeindex>
+#include <unordered_map>
+
 #include "../core/system.h"
 
+struct MeshData;
+struct LakeOutline;
+
+bool read_resource( std::istream& in, MeshData& mesh );
+void write_resource( std::ostream& out, const MeshData& mesh );
+bool read_resource( std::istream& in, LakeOutline& outline );
+void write_resource( std::ostream& out, const LakeOutline& outline );
+
+/*
+ * Content addressed cache of generated geometry. The key is a fingerprint (see core/hash.h) of
+ * everything the resource is generated from, the version of the generator included, so that a
+ * generator that changes does not get the old one's results from disk. A resource is looked up in memory first, then in the
+ * cache directory on disk, and only generated when both miss. Everybody asking for the same key
+ * gets the same immutable instance.
+ */
 class ResourceSystem : public BaseSystem<ResourceSystem>
 {
 public:
-    ResourceSystem( Engine* eng ) : BaseSystem<ResourceSystem>( eng ) {};
+    ResourceSystem( Engine* eng );
+
+    void update( double elapsed ) override;
+
+    void set_cache_directory( const std::string& directory ) { cache_directory = directory; }     // empty disables the disk cache
+    const std::filesystem::path& get_cache_directory() const { return cache_directory; }
+
+    template<typename T, typename Fn> std::shared_ptr<const T> acquire( uint64_t key, Fn&& generate );     // thread safe
 
 private:
+    struct Entry
+    {
+        std::shared_ptr<const void> resource;
+        std::type_index type;
+        unsigned idle_frames = 0;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<uint64_t, Entry> cache;
+    std::filesystem::path cache_directory;
+
+    template<typename T> bool read_file( uint64_t key, T& resource );
+    template<typename T> void write_file( uint64_t key, const T& resource );
+
+    std::filesystem::path cache_path( uint64_t key ) const;
 };
+
+template <typename T, typename Fn>
+std::shared_ptr<const T> ResourceSystem::acquire( uint64_t key, Fn&& generate )
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+
+        auto it = cache.find( key );
+        if( it != cache.end() && it->second.type == typeid(T) ) {
+            it->second.idle_frames = 0;
+            return std::static_pointer_cast<const T>( it->second.resource );
+        }
+    }
+
+    // generate outside the lock, two threads racing for the same key both do the work once
+    auto resource = std::make_shared<T>();
+
+    if( !read_file( key, *resource ) ) {
+        *resource = generate();
+        write_file( key, *resource );
+    }
+
+    std::lock_guard<std::mutex> lock( mutex );
+
+    auto [it, inserted] = cache.try_emplace( key, Entry { resource, typeid(T) } );
+    if( it->second.type != typeid(T) )
+        return resource;
+
+    return std::static_pointer_cast<const T>( it->second.resource );
+}
+
+template <typename T>
+bool ResourceSystem::read_file( uint64_t key, T& resource )
+{
+    if( cache_directory.empty() )
+        return false;
+
+    std::ifstream in( cache_path( key ), std::ios::binary );
+
+    return in.is_open() && read_resource( in, resource );
+}
+
+template <typename T>
+void ResourceSystem::write_file( uint64_t key, const T& resource )
+{
+    if( cache_directory.empty() )
+        return;
+
+    std::error_code error;
+    std::filesystem::create_directories( cache_directory, error );
+
+    // write aside and rename, so a reader never sees half a file
+    auto path = cache_path( key );
+    auto temp = path;
+    temp += "." + std::to_string( std::hash<std::thread::id>()( std::this_thread::get_id() ) );
+
+    {
+        std::ofstream out( temp, std::ios::binary );
+        if( !out.is_open() )
+            return;
+
+        write_resource( out, resource );
+    }
+
+    std::filesystem::rename( temp, path, error );
+}
@@ -0,0 +1,245 @@
+/*
+ * streaming_system.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "streaming_system.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <utility>
+
+#include "../core/engine.h"
+#include "../core/world.h"
+#include "../core/registry.h"
+#include "../commands/json_loaders.h"
+#include "../components/transform_component.h"
+
+#include "render_system.h"
+
+struct LoadedCell
+{
+	uint64_t key;
+	nlohmann::json document;					// the payloads point into it
+	size_t entity_count = 0;
+	std::vector<ComponentPayload> payloads;
+};
+
+static int cell_distance( uint64_t a, uint64_t b )
+{
+	return std::max( std::abs( cell_x( a ) - cell_x( b ) ), std::abs( cell_y( a ) - cell_y( b ) ) );
+}
+
+StreamingSystem::StreamingSystem( Engine *eng ) : BaseSystem<StreamingSystem>( eng )
+{
+}
+
+StreamingSystem::~StreamingSystem()
+{
+	stop_worker();
+}
+
+void StreamingSystem::open( CellIndex &&cells )
+{
+	close();
+
+	engine->get_registry().clear();
+	engine->get_scene() = Scene {};			// a streamed scene is not hot reloaded
+
+	index = std::move( cells );
+
+	stopping = false;
+	worker = std::thread( &StreamingSystem::work, this );
+}
+
+void StreamingSystem::close()
+{
+	stop_worker();
+
+	index = CellIndex {};
+	resident.clear();
+	pending.clear();
+	requests.clear();
+	loaded.clear();
+	error = nullptr;
+}
+
+void StreamingSystem::stop_worker()
+{
+	if( !worker.joinable() )
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+		stopping = true;
+	}
+
+	wakeup.notify_all();
+	worker.join();
+}
+
+void StreamingSystem::update( double elapsed )
+{
+	if( index.cells.empty() )
+		return;
+
+	// a scene loaded the ordinary way has replaced the registry and everything in it
+	if( !engine->get_scene().filename.empty() ) {
+		close();
+		return;
+	}
+
+	uint64_t centre = cell_of( focus_position(), index.cell_size );
+
+	std::vector<uint64_t> stale;
+
+	for( auto& [key, entities] : resident )
+		if( cell_distance( key, centre ) > radius + 1 )
+			stale.push_back( key );
+
+	for( uint64_t key : stale )
+		unload( key );
+
+	std::vector<uint64_t> wanted;
+
+	for( int y = -radius; y <= radius; ++y )
+		for( int x = -radius; x <= radius; ++x ) {
+			uint64_t key = cell_key( cell_x( centre ) + x, cell_y( centre ) + y );
+			if( index.cells.count( key ) && !resident.count( key ) && !pending.count( key ) )
+				wanted.push_back( key );
+		}
+
+	// nearest first, so the cell under the focus arrives before the ones at the edge
+	std::sort( wanted.begin(), wanted.end(), [centre]( uint64_t a, uint64_t b ) { return cell_distance( a, centre ) < cell_distance( b, centre ); } );
+
+	std::deque<std::unique_ptr<LoadedCell>> arrived;
+
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+
+		if( error )
+			std::rethrow_exception( std::exchange( error, nullptr ) );
+
+		requests.insert( requests.end(), wanted.begin(), wanted.end() );
+
+		while( !loaded.empty() && arrived.size() < cells_per_frame ) {
+			arrived.push_back( std::move( loaded.front() ) );
+			loaded.pop_front();
+		}
+	}
+
+	if( !wanted.empty() )
+		wakeup.notify_one();
+
+	pending.insert( wanted.begin(), wanted.end() );
+
+	for( auto& cell : arrived ) {
+
+		pending.erase( cell->key );
+
+		if( cell_distance( cell->key, centre ) <= radius + 1 )		// the focus may have moved on while it loaded
+			merge( *cell );
+	}
+}
+
+glm::vec2 StreamingSystem::focus_position()
+{
+	if( focus_entity != InvalidEntity ) {
+		if( auto * transform = engine->get_world().get_component<TransformComponent>( focus_entity ) )
+			focus = glm::vec2( transform->translation.x, transform->translation.y );
+	}
+	else if( follow_camera ) {
+		if( auto * render = engine->get_system<RenderSystem>() )
+			focus = render->view_centre();
+	}
+
+	return focus;
+}
+
+void StreamingSystem::merge( LoadedCell &cell )
+{
+	auto& registry = engine->get_registry();
+
+	auto entities = registry.create_entities( cell.entity_count );
+
+	store_components( registry, entities, cell.payloads );
+
+	resident[cell.key] = std::move( entities );
+}
+
+void StreamingSystem::unload( uint64_t key )
+{
+	auto it = resident.find( key );
+	if( it == resident.end() )
+		return;
+
+	for( Entity entity : it->second )		// the world drops the components at the end of the frame
+		engine->get_registry().remove_entity( entity );
+
+	resident.erase( it );
+}
+
+void StreamingSystem::work()
+{
+	std::unique_lock<std::mutex> lock( mutex );
+
+	for( ;; ) {
+
+		wakeup.wait( lock, [this]() { return stopping || !requests.empty(); } );
+
+		if( stopping )
+			return;
+
+		uint64_t key = requests.front();
+		requests.pop_front();
+
+		lock.unlock();
+
+		auto cell = std::make_unique<LoadedCell>();
+		cell->key = key;
+
+		try {
+			std::ifstream datafile( index.directory / cell_filename( key ) );
+			if( !datafile.is_open() )
+				throw std::runtime_error( "Streaming error: missing cell " + cell_filename( key ).string() );
+
+			datafile >> cell->document;
+
+			auto& entities = cell->document["entities"];
+			cell->entity_count = entities.size();
+
+			for( size_t i = 0; i < entities.size(); ++i )
+				for( auto& [name, component_data] : entities[i]["components"].items() ) {
+
+					auto it = json_loaders.find( name );
+					if( it != json_loaders.end() )
+						cell->payloads.push_back( { i, &it->second, &component_data } );
+				}
+
+			decode_components( cell->payloads, 1 );
+		}
+		catch( ... ) {
+			lock.lock();
+			error = std::current_exception();
+			continue;
+		}
+
+		lock.lock();
+		loaded.push_back( std::move( cell ) );
+	}
+}
@@ -0,0 +1,95 @@
+/*
+ * streaming_system.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "../core/system.h"
+#include "../core/world.h"
+#include "../commands/scene_partition.h"
+
+struct LoadedCell;
+
+/*
+ * Keeps the cells of a partitioned scene (see commands/scene_partition.h) within a ring around the
+ * focus resident. Cells are read and decoded on a worker thread, the main thread only creates the
+ * entities, and at most cells_per_frame of them per frame. Cells further than radius + 1 cells from
+ * the focus are unloaded, the extra cell stops a focus on a cell border from thrashing. The focus is
+ * the centre of the view unless set otherwise.
+ */
+class StreamingSystem : public BaseSystem<StreamingSystem>
+{
+public:
+    StreamingSystem( Engine* eng );
+    ~StreamingSystem();		// in the implementation file, LoadedCell is only known there
+
+    void update( double elapsed ) override;
+    void shutdown() override { close(); }
+
+    void open( CellIndex&& index );
+    void close();
+
+    void set_radius( int cells ) { radius = cells; }
+    void set_cells_per_frame( unsigned count ) { cells_per_frame = count; }
+    void set_focus( glm::vec2 position ) { focus = position; focus_entity = InvalidEntity; follow_camera = false; }
+    void set_focus_entity( Entity entity ) { focus_entity = entity; }     // follows its TransformComponent
+    void set_follow_camera() { focus_entity = InvalidEntity; follow_camera = true; }     // the default
+
+    size_t resident_cells() const { return resident.size(); }
+    size_t pending_cells() const { return pending.size(); }
+
+private:
+    CellIndex index;
+    int radius = 1;
+    unsigned cells_per_frame = 1;
+
+    glm::vec2 focus = glm::vec2( 0.0f );
+    Entity focus_entity = InvalidEntity;
+    bool follow_camera = true;
+
+    std::unordered_map<uint64_t, std::vector<Entity>> resident;
+    std::unordered_set<uint64_t> pending;
+
+    // shared with the worker
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::deque<uint64_t> requests;
+    std::deque<std::unique_ptr<LoadedCell>> loaded;
+    std::exception_ptr error;
+    bool stopping = false;
+    std::thread worker;
+
+    void work();
+    void stop_worker();
+
+    glm::vec2 focus_position();
+    void merge( LoadedCell& cell );
+    void unload( uint64_t key );
+};
@@ -0,0 +1,168 @@
+/*
+ * timing_system.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include "timing_system.h"
+
+#include <algorithm>
+
+#include "../core/engine.h"
+#include "../core/view.h"
+#include "../geometry/track_index.h"
+
+#include "vehicle_system.h"
+
+#include "../components/track_component.h"
+#include "../components/transform_component.h"
+#include "../components/vehicle_component.h"
+
+void TimingSystem::update( double elapsed )
+{
+	auto& world = engine->get_world();
+
+	// the cars' own clock when they have one, so crossings line up with the steps they move in
+	clock += elapsed;
+	auto * vehicles = engine->get_system<VehicleSystem>();
+	double time = vehicles ? vehicles->get_time() : clock;
+
+	std::shared_ptr<const TrackIndex> circuit;
+	const TrackComponent * track = nullptr;
+
+	for( auto [entity, t] : world.view<TrackComponent>() )
+		if( t.closed && t.index && !t.index->empty() ) {
+			circuit = t.index;
+			track = &t;
+			break;
+		}
+
+	if( circuit != index ) {
+
+		index = circuit;
+		cars.clear();
+		marks.clear();
+
+		if( index ) {
+			double length = index->length();
+
+			for( float fraction : track->sectors )
+				if( fraction > 0.0f && fraction < 1.0f )
+					marks.push_back( fraction * length );
+
+			std::sort( marks.begin(), marks.end() );
+			marks.erase( std::unique( marks.begin(), marks.end() ), marks.end() );
+			marks.push_back( length );
+		}
+	}
+
+	std::erase_if( cars, [&world]( auto& car ) { return !world.get_component<VehicleComponent>( car.first ); } );
+
+	if( !index )
+		return;
+
+	double length = index->length();
+
+	for( auto [entity, vehicle, transform] : world.view<VehicleComponent, TransformComponent>() ) {
+
+		glm::vec2 position( transform.translation.x, transform.translation.y );
+		auto [it, added] = cars.try_emplace( entity );
+		Car& car = it->second;
+
+		if( added ) {
+			TrackQuery q = index->query( position );
+
+			car.segment = q.segment;
+			car.arc = q.arc_length;
+			car.travelled = q.arc_length;
+			car.time = time;
+			car.next = uint32_t( marks.size() - 1 );		// out to the finish line
+			continue;
+		}
+
+		if( time <= car.time )
+			continue;
+
+		TrackQuery q = index->query_from( position, car.segment );
+
+		// the shorter way round, a car does not cover half a lap in a tick
+		double moved = double( q.arc_length ) - car.arc;
+		if( moved > length * 0.5 )
+			moved -= length;
+		else if( moved < -length * 0.5 )
+			moved += length;
+
+		double from = car.travelled, to = car.travelled + moved, before = car.time;
+
+		car.segment = q.segment;
+		car.arc = q.arc_length;
+		car.travelled = to;
+		car.time = time;
+
+		while( to >= car.base + marks[ car.next ] ) {
+
+			double line = car.base + marks[ car.next ];
+			double at = before + ( time - before ) * ( line - from ) / ( to - from );
+
+			cross( entity, car, at );
+		}
+	}
+}
+
+void TimingSystem::cross( Entity entity, Car& car, double time )
+{
+	bool finish = car.next + 1 == marks.size();
+
+	if( car.timing )
+		car.sectors.push_back( float( time - car.sector_start ) );
+	car.sector_start = time;
+
+	if( !finish ) {
+		++car.next;
+		return;
+	}
+
+	if( car.timing ) {
+		laps.push_back( { entity, car.lap + 1, float( time - car.lap_start ), uint32_t( sector_times.size() ), uint32_t( car.sectors.size() ) } );
+		sector_times.insert( sector_times.end(), car.sectors.begin(), car.sectors.end() );
+		++car.lap;
+	}
+
+	car.timing = true;
+	car.lap_start = time;
+	car.sectors.clear();
+	car.base += marks.back();
+	car.next = 0;
+}
+
+uint32_t TimingSystem::get_lap( Entity car ) const
+{
+	auto it = cars.find( car );
+	return it == cars.end() ? 0 : it->second.lap;
+}
+
+double TimingSystem::get_lap_start( Entity car ) const
+{
+	auto it = cars.find( car );
+	return it == cars.end() || !it->second.timing ? -1.0 : it->second.lap_start;
+}
+
+double TimingSystem::get_lap_time( Entity car ) const
+{
+	auto it = cars.find( car );
+	return it == cars.end() || !it->second.timing ? 0.0 : it->second.time - it->second.lap_start;
+}
@@ -0,0 +1,94 @@
+/*
+ * timing_system.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "../core/system.h"
+#include "../core/world.h"
+
+class TrackIndex;
+
+struct LapResult
+{
+	Entity car;
+	uint32_t lap;				// 1 for the first lap after the out lap
+	float time;					// seconds
+	uint32_t first_sector;		// into the sector times
+	uint32_t sectors;			// of the track as it was for this lap
+};
+
+/*
+ * Lap and sector times for the cars on the first closed track. Each car is followed along the
+ * centreline from the segment it was on the tick before, and its distance travelled kept unwound
+ * over the laps, so driving backwards over a line does not count. A crossing is timed where the
+ * line falls between the car's last two positions rather than on the tick after it.
+ *
+ * Timing starts when a car first crosses the finish line. Editing the track starts it over.
+ */
+class TimingSystem : public BaseSystem<TimingSystem>
+{
+public:
+	TimingSystem( Engine* eng ) : BaseSystem<TimingSystem>( eng ) {};
+
+	void update( double elapsed ) override;
+	void rewind() override { cars.clear(); }		// laps under way are dropped, the cars are timed again from where they are put back
+
+	const std::vector<LapResult>& get_laps() const { return laps; }
+	std::span<const float> get_sectors( const LapResult& lap ) const { return { sector_times.data() + lap.first_sector, lap.sectors }; }
+	size_t sector_count() const { return marks.size(); }		// of the track now, laps before an edit may have had more or fewer
+
+	// laps completed and the time into the current one, for the car's place in the running order
+	uint32_t get_lap( Entity car ) const;
+	double get_lap_time( Entity car ) const;
+	double get_lap_start( Entity car ) const;		// on the cars' clock, -1 before the car is timed
+
+private:
+	struct Car
+	{
+		size_t segment = 0;
+		float arc = 0.0f;				// along the centreline at the last tick
+		double travelled = 0.0;			// arc, unwound over the laps
+		double time = 0.0;				// of the last tick
+
+		double base = 0.0;				// travelled at the start of the lap
+		uint32_t next = 0;				// into marks
+		uint32_t lap = 0;
+		bool timing = false;
+		double lap_start = 0.0, sector_start = 0.0;
+		std::vector<float> sectors;		// of the lap under way
+	};
+
+	std::shared_ptr<const TrackIndex> index;
+	std::vector<double> marks;			// arc length of each sector end, the last is the finish line
+	std::unordered_map<Entity, Car> cars;
+
+	std::vector<LapResult> laps;
+	std::vector<float> sector_times;
+
+	double clock = 0.0;
+
+	void cross( Entity entity, Car& car, double time );
+};
@@ -19,22 +19,174 @@
 
 #include "track_system.h"
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+
 #include "../core/world.h"
 #include "../core/engine.h"
 #include "../core/view.h"
+#include "../core/hash.h"
+#include "../geometry/tessellation.h"
+#include "../geometry/track_index.h"
+#include "../geometry/distance_field.h"
+
+#include "resource_system.h"
+#include "render_system.h"
 
 #include "../components/track_component.h"
 #include "../components/mesh_component.h"
 
+constexpr float pixel_tolerance = 0.25f;		// how far the tessellation may stray from the spline on screen
+constexpr float default_tolerance = 0.01f;		// in world units, for when there is no view to go by
+constexpr float miter_limit = 4.0f;
+
 void TrackSystem::update( double dt )
 {
 	auto& world = engine->get_world();
 
-	for( auto [entity, track] : world.view<TrackComponent>() )
-        if( track.dirty ) {
+	float wanted = zoom_tolerance();
+	bool zoomed = ( wanted != tolerance );
+	tolerance = wanted;
+
+	for( auto it = edited.begin(); it != edited.end(); )
+		it = world.get_component<TrackComponent>( it->first ) ? std::next( it ) : edited.erase( it );
+	std::erase_if( stale_index, [&world]( Entity entity ) { return !world.get_component<TrackComponent>( entity ); } );
+	std::erase_if( fields, [&world]( auto& baked ) { return !world.get_component<TrackComponent>( baked.first ); } );
+
+	for( auto [entity, track] : world.view<TrackComponent>() ) {
+
+        if( track.dirty || zoomed ) {
 			regenerate_mesh( world, entity, track );
-			track.dirty = false;
+			edited.erase( entity );
+		}
+		else if( track.edited() )
+			patch_mesh( world, entity, track );
+
+		// while points are being dragged the index lags behind, it is made again once they stop
+		if( track.dirty || !track.index || rebuild ) {
+			regenerate_index( track );
+			bake_field( entity, track, true );
+			stale_index.erase( entity );
+		}
+		else if( track.edited() )
+			stale_index.insert( entity );
+		else if( stale_index.erase( entity ) ) {
+			regenerate_index( track );
+			bake_field( entity, track, false );
 		}
+
+		track.dirty = false;
+		track.clear_edits();
+	}
+
+	rebuild = false;
+}
+
+// the fields were last baked from centrelines the restore may have undone, an edit diffed against
+// them would only rebake part of what changed
+void TrackSystem::rewind()
+{
+	edited.clear();
+	fields.clear();
+	stale_index.clear();
+	rebuild = true;
+}
+
+void TrackSystem::regenerate_index( TrackComponent &track )
+{
+	// independent of the zoom, cars drive on the same track however it is viewed
+	auto line = tessellate_spline( track.centreline, track.closed, default_tolerance );
+
+	auto index = std::make_shared<TrackIndex>();
+	index->build( line, track.closed && line.size() > 2, track.width );
+
+	track.index = std::move( index );
+}
+
+void TrackSystem::bake_field( Entity ent, TrackComponent &track, bool full )
+{
+	if( field_spacing <= 0.0f || track.index->empty() ) {
+		track.field = nullptr;
+		fields.erase( ent );
+		return;
+	}
+
+	auto index = track.index;
+	float half_width = track.width * 0.5f;
+	auto distance = [index, half_width]( glm::vec2 p ) { return index->query( p ).distance - half_width; };
+
+	// far enough out for a car to see the edge coming
+	float range = std::max( track.width, 8.0f * field_spacing );
+
+	BakedField& baked = fields[ent];
+	const auto& before = baked.centreline;
+	const auto& after = track.centreline;
+
+	// a control point moves the spline spans up to two points either side of it, which stay within
+	// the hull of the points three either side
+	glm::vec2 low( std::numeric_limits<float>::max() ), high( -std::numeric_limits<float>::max() );
+	size_t n = after.size();
+
+	if( !full && baked.field && before.size() == n ) {
+
+		for( size_t i = 0; i < n; ++i ) {
+
+			if( before[i] == after[i] )
+				continue;
+
+			for( int offset = -3; offset <= 3; ++offset ) {
+
+				size_t j = track.closed ? ( i + n + offset ) % n : size_t( std::clamp( int( i ) + offset, 0, int( n ) - 1 ) );
+
+				low = glm::min( low, glm::min( before[j], after[j] ) );
+				high = glm::max( high, glm::max( before[j], after[j] ) );
+			}
+		}
+
+		glm::vec2 margin( half_width + field_spacing );
+
+		// copied before it is rebaked when a snapshot may hold it
+		uint64_t snapshots = engine->get_world().get_snapshot_count();
+		if( baked.snapshots != snapshots && low.x <= high.x )
+			baked.field = std::make_shared<DistanceField>( *baked.field );
+		baked.snapshots = snapshots;
+
+		if( low.x > high.x || baked.field->rebake( low - margin, high + margin, distance ) ) {
+			baked.centreline = after;
+			track.field = baked.field;
+			return;
+		}
+	}
+
+	low = glm::vec2( std::numeric_limits<float>::max() );
+	high = glm::vec2( -std::numeric_limits<float>::max() );
+	for( auto& p : after ) {
+		low = glm::min( low, p );
+		high = glm::max( high, p );
+	}
+
+	// the spline can bulge past its points, range is plenty for that
+	glm::vec2 margin( half_width + range );
+
+	baked.field = std::make_shared<DistanceField>();
+	baked.field->build( low - margin, high + margin, field_spacing, range, distance );
+	baked.centreline = after;
+
+	track.field = baked.field;
+}
+
+float TrackSystem::zoom_tolerance()
+{
+	auto * render = engine->get_system<RenderSystem>();
+	float units = render ? render->world_units_per_pixel() : 0.0f;
+
+	if( !( units > 0.0f ) )
+		return default_tolerance;
+
+	// rounded to a power of two so the tracks are only tessellated again when the zoom changes by a factor of two
+	return std::exp2( std::round( std::log2( pixel_tolerance * units ) ) );
 }
 
 void TrackSystem::regenerate_mesh( World &world, Entity ent, TrackComponent &track )
@@ -49,51 +201,55 @@ void TrackSystem::regenerate_mesh( World &world, Entity ent, TrackComponent &tra
     mesh->filled = false;
     mesh->topology = MeshComponent::Topology::TRIANGLES;
 
-    float half_width = track.width * 0.5f;
+	Hasher key;
+	key.add( std::string( "track" ) ).add( mesh_version ).add( track.centreline ).add( track.width ).add( track.closed ).add( track.colour ).add( tolerance );
 
-    for( size_t i = 0; i+1 < track.centreline.size(); ++i ) {
+	float limit = tolerance;
+	mesh->data = engine->get_system<ResourceSystem>()->acquire<MeshData>( key.value(), [&track, limit]() { return generate_mesh( track, limit ); } );
+}
+
+void TrackSystem::patch_mesh( World &world, Entity ent, TrackComponent &track )
+{
+	auto * mesh = world.get_component<MeshComponent>(ent);
 
-        glm::vec2 current = track.centreline[i];
-        glm::vec2 next = track.centreline[i+1];
+	if( !mesh ) {
+		regenerate_mesh( world, ent, track );
+		return;
+	}
 
-        glm::vec2 dir = glm::normalize( next - current );
-        glm::vec2 normal = glm::normalize( glm::vec2(-dir.y, dir.x) );
+	auto& edit = edited[ent];
 
-        glm::vec2 left  = current + normal * half_width;
-        glm::vec2 right = current - normal * half_width;
+	// the first edit swaps the shared mesh for one laid out to be patched
+	bool own = edit.mesh && mesh->data == edit.mesh && edit.layout.matches( track, tolerance );
 
-        mesh->vertices.push_back( glm::vec3(left, 0.0) );
-        mesh->colours.push_back( track.colour );
+	// a snapshot taken since may hold the mesh, which has to stay as it was
+	if( edit.mesh && edit.snapshots != world.get_snapshot_count() ) {
+		edit.mesh = std::make_shared<MeshData>( *edit.mesh );
+		if( own )
+			mesh->data = edit.mesh;
+	}
+	edit.snapshots = world.get_snapshot_count();
 
-        mesh->vertices.push_back( glm::vec3(right, 0.0) );
-        mesh->colours.push_back( track.colour );
-    }
+	if( !own || !edit.layout.update( track, track.edit_first, track.edit_last, *edit.mesh ) ) {
 
-    glm::vec2 current = track.centreline[track.centreline.size() - 1];
-    glm::vec2 next = track.centreline[track.centreline.size() - 2];
+		if( !edit.mesh )
+			edit.mesh = std::make_shared<MeshData>();
 
-    glm::vec2 dir = glm::normalize( current - next );
-    glm::vec2 normal = glm::normalize( glm::vec2(-dir.y, dir.x) );
+		edit.layout.build( track, tolerance, miter_limit, *edit.mesh );
+		mesh->data = edit.mesh;
+	}
+}
 
-    glm::vec2 left  = current + normal * half_width;
-    glm::vec2 right = current - normal * half_width;
+MeshData TrackSystem::generate_mesh( const TrackComponent &track, float tolerance )
+{
+	MeshData mesh;
 
-    mesh->vertices.push_back( glm::vec3(left, 0.0) );
-    mesh->colours.push_back( track.colour );
+	if( track.centreline.size() < 2 )
+		return mesh;
 
-    mesh->vertices.push_back( glm::vec3(right, 0.0) );
-    mesh->colours.push_back( track.colour );
+	auto line = tessellate_spline( track.centreline, track.closed, tolerance );
 
-    // each pair of vertices is a left and right vertex of the track, thus two pairs create a quad, which is two triangles
-    // the triangle vertices of each are 0, 1, 3 and 1, 2, 3
-    for( size_t i = 0; i < track.centreline.size() - 1; ++i )
-    {
-        mesh->indices.push_back( 0 + 2 * i );
-        mesh->indices.push_back( 1 + 2 * i );
-        mesh->indices.push_back( 3 + 2 * i );
+	extrude_ribbon( line, track.closed && line.size() > 2, track.width, track.colour, miter_limit, mesh );
 
-        mesh->indices.push_back( 0 + 2 * i );
-        mesh->indices.push_back( 2 + 2 * i );
-        mesh->indices.push_back( 3 + 2 * i );
-    }
+	return mesh;
 }
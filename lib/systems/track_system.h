@@ -22,8 +22,16 @@
 #include "../core/system.h"
 
 #include "../core/world.h"
+#include "../geometry/track_mesh.h"
+
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 struct TrackComponent;
+struct MeshData;
+class DistanceField;
 
 class TrackSystem : public BaseSystem<TrackSystem>
 {
@@ -31,7 +39,44 @@ public:
     TrackSystem( Engine* eng ) : BaseSystem<TrackSystem>( eng ) {};
 
     void update( double dt ) override;
+    void rewind() override;
+
+    static MeshData generate_mesh( const TrackComponent& track, float tolerance );
+    static constexpr uint32_t mesh_version = 3;     // in the cache key, up by one whenever generate_mesh changes what it makes
+
+    // tracks get a distance field (see geometry/distance_field.h) sampled every spacing world units, 0 for none
+    void set_field_spacing( float spacing ) { field_spacing = spacing; }
 
 private:
+    float tolerance = 0.0f;     // world units the tessellated centreline may be off the spline
+
+    // tracks that are being edited have a mesh of their own, patched in place
+    struct EditedTrack
+    {
+        TrackMesh layout;
+        std::shared_ptr<MeshData> mesh;
+        uint64_t snapshots = 0;     // taken of the world when the mesh was last patched
+    };
+
+    std::unordered_map<Entity, EditedTrack> edited;
+    std::unordered_set<Entity> stale_index;
+
+    // the centreline each field was last baked from, to find the part an edit changed
+    struct BakedField
+    {
+        std::shared_ptr<DistanceField> field;
+        std::vector<glm::vec2> centreline;
+        uint64_t snapshots = 0;
+    };
+
+    float field_spacing = 0.0f;
+    std::unordered_map<Entity, BakedField> fields;
+    bool rebuild = false;       // after a rewind, every index and field is made again
+
     void regenerate_mesh( World& world, Entity ent, TrackComponent& track );
+    void patch_mesh( World& world, Entity ent, TrackComponent& track );
+    void regenerate_index( TrackComponent& track );
+    void bake_field( Entity ent, TrackComponent& track, bool full );
+
+    float zoom_tolerance();
 };
\ No newline at end of file
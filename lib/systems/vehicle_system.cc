@@ -0,0 +1,315 @@
+/*
+ * vehicle_system.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "vehicle_system.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "../core/engine.h"
+#include "../core/telemetry.h"
+#include "../core/view.h"
+
+#include "collision_system.h"
+
+#include "../components/transform_component.h"
+#include "../components/vehicle_component.h"
+#include "../components/track_component.h"
+
+#include "../geometry/distance_field.h"
+#include "../geometry/kernels.h"
+#include "../geometry/track_index.h"
+
+constexpr float gravity = 9.81f;
+
+void VehicleState::resize( size_t count )
+{
+	for( auto * column : { &x, &y, &vx, &vy, &heading, &yaw_rate, &inverse_mass, &drive, &brake, &drag, &turn, &grip } )
+		column->resize( count, 0.0f );
+}
+
+void VehicleState::erase( size_t slot )
+{
+	for( auto * column : { &x, &y, &vx, &vy, &heading, &yaw_rate, &inverse_mass, &drive, &brake, &drag, &turn, &grip } ) {
+		( *column )[slot] = column->back();
+		column->pop_back();
+	}
+}
+
+void VehicleSystem::update( double elapsed )
+{
+	auto& world = engine->get_world();
+
+	sync( world );
+
+	if( auto * collisions = engine->get_system<CollisionSystem>() )
+		resolve( *collisions );
+
+	accumulator += elapsed;
+	int steps = int( accumulator / step );
+	accumulator -= steps * step;
+
+	if( steps > max_steps ) {
+		steps = max_steps;
+		accumulator = 0.0;
+	}
+
+	if( steps > 0 && state.size() > 0 ) {
+		sense_surface( world );
+		integrate( state, 0, state.size(), float( step ), steps );
+	}
+
+	ticks += steps;
+
+	for( size_t slot = 0; slot < entities.size(); ++slot ) {
+
+		auto * vehicle = world.get_component<VehicleComponent>( entities[slot] );
+		auto * transform = world.get_component<TransformComponent>( entities[slot] );
+
+		transform->translation.x = state.x[slot];
+		transform->translation.y = state.y[slot];
+		transform->rotation.z = state.heading[slot];
+
+		vehicle->velocity = glm::vec2( state.vx[slot], state.vy[slot] );
+		vehicle->yaw_rate = state.yaw_rate[slot];
+		vehicle->tick = ticks;
+	}
+
+	if( auto * telemetry = engine->get_telemetry() ) {
+		for( size_t slot = 0; slot < entities.size(); ++slot ) {
+
+			auto * vehicle = world.get_component<VehicleComponent>( entities[slot] );
+
+			telemetry->push( { ticks, entities[slot], state.x[slot], state.y[slot], state.heading[slot],
+				state.vx[slot], state.vy[slot], state.yaw_rate[slot], vehicle->throttle, vehicle->brake, vehicle->steer } );
+		}
+	}
+}
+
+// the cars are read back from their components, the part of a step left over belonged to the
+// frames that were undone. The clock goes back to the tick the restored cars were moved to, with
+// no cars there is nothing to take it from and it carries on
+void VehicleSystem::rewind()
+{
+	state.resize( 0 );
+	entities.clear();
+	slots.clear();
+	accumulator = 0.0;
+
+	bool cars = false;
+	uint64_t restored = 0;
+
+	for( auto [entity, vehicle] : engine->get_world().view<VehicleComponent>() ) {
+		restored = cars ? std::max( restored, vehicle.tick ) : vehicle.tick;
+		cars = true;
+	}
+
+	if( cars )
+		ticks = restored;
+}
+
+// takes on new cars, drops removed ones and reads the inputs. A car whose transform or velocity is
+// not what the last update wrote was put there from outside (a reload, a replicated state, a test)
+// and is taken from where it was put
+void VehicleSystem::sync( World& world )
+{
+	for( size_t slot = 0; slot < entities.size(); ) {
+
+		if( world.get_component<VehicleComponent>( entities[slot] ) && world.get_component<TransformComponent>( entities[slot] ) ) {
+			++slot;
+			continue;
+		}
+
+		slots.erase( entities[slot] );
+		state.erase( slot );
+		entities[slot] = entities.back();
+		entities.pop_back();
+
+		if( slot < entities.size() )
+			slots[ entities[slot] ] = uint32_t( slot );
+	}
+
+	for( auto [entity, vehicle, transform] : world.view<VehicleComponent, TransformComponent>() ) {
+
+		auto [it, added] = slots.try_emplace( entity, uint32_t( entities.size() ) );
+		size_t slot = it->second;
+
+		if( added ) {
+			entities.push_back( entity );
+			state.resize( entities.size() );
+		}
+
+		if( added || transform.translation.x != state.x[slot] || transform.translation.y != state.y[slot] || transform.rotation.z != state.heading[slot] ) {
+			state.x[slot] = transform.translation.x;
+			state.y[slot] = transform.translation.y;
+			state.heading[slot] = transform.rotation.z;
+		}
+
+		if( added || vehicle.velocity.x != state.vx[slot] || vehicle.velocity.y != state.vy[slot] ) {
+			state.vx[slot] = vehicle.velocity.x;
+			state.vy[slot] = vehicle.velocity.y;
+		}
+
+		float inverse_mass = 1.0f / vehicle.mass;
+
+		state.inverse_mass[slot] = inverse_mass;
+		state.drive[slot] = std::clamp( vehicle.throttle, 0.0f, 1.0f ) * vehicle.engine_force * inverse_mass;
+		state.brake[slot] = std::clamp( vehicle.brake, 0.0f, 1.0f ) * vehicle.brake_force * inverse_mass;
+		state.drag[slot] = vehicle.drag * inverse_mass;
+		state.turn[slot] = std::tan( std::clamp( vehicle.steer, -1.0f, 1.0f ) * vehicle.max_steer ) / vehicle.wheelbase;
+		state.grip[slot] = vehicle.grip * gravity;
+	}
+}
+
+// once a tick, a car does not leave the track within a step
+void VehicleSystem::sense_surface( World& world )
+{
+	struct Surface
+	{
+		const DistanceField * field;
+		const TrackIndex * index;
+		float half_width;
+	};
+
+	std::vector<Surface> surfaces;
+
+	for( auto [entity, track] : world.view<TrackComponent>() )
+		if( track.field || track.index )
+			surfaces.push_back( { track.field.get(), track.index.get(), track.width * 0.5f } );
+
+	for( size_t slot = 0; slot < entities.size(); ++slot ) {
+
+		glm::vec2 position( state.x[slot], state.y[slot] );
+		bool on_track = surfaces.empty();
+
+		for( auto& surface : surfaces ) {
+			float distance = surface.field ? surface.field->distance( position ) : surface.index->query( position ).distance - surface.half_width;
+			on_track = on_track || distance <= 0.0f;
+		}
+
+		auto * vehicle = world.get_component<VehicleComponent>( entities[slot] );
+		vehicle->on_track = on_track;
+
+		if( !on_track )
+			state.grip[slot] *= off_track_grip;
+	}
+}
+
+// pushes touching cars apart along the contact normal and takes out the speed they meet with, in
+// proportion to their mass. Anything that is not a car does not give way
+void VehicleSystem::resolve( const CollisionSystem& collisions )
+{
+	auto slot_of = [&]( uint32_t index ) -> int64_t
+	{
+		auto it = slots.find( collisions.get_entity( index ) );
+		return it == slots.end() ? -1 : int64_t( it->second );
+	};
+
+	for( auto& contact : collisions.get_contacts() ) {
+
+		int64_t a = slot_of( contact.a ), b = slot_of( contact.b );
+
+		float wa = a < 0 ? 0.0f : state.inverse_mass[a];
+		float wb = b < 0 ? 0.0f : state.inverse_mass[b];
+		float total = wa + wb;
+
+		if( total <= 0.0f )
+			continue;
+
+		glm::vec2 n = contact.normal;
+		glm::vec2 va = a < 0 ? glm::vec2( 0.0f ) : glm::vec2( state.vx[a], state.vy[a] );
+		glm::vec2 vb = b < 0 ? glm::vec2( 0.0f ) : glm::vec2( state.vx[b], state.vy[b] );
+
+		float closing = glm::dot( vb - va, n );
+		float impulse = closing < 0.0f ? -( 1.0f + restitution ) * closing / total : 0.0f;
+
+		glm::vec2 push = n * ( contact.depth / total );
+
+		if( a >= 0 ) {
+			state.x[a] -= push.x * wa;
+			state.y[a] -= push.y * wa;
+			state.vx[a] -= n.x * impulse * wa;
+			state.vy[a] -= n.y * impulse * wa;
+		}
+		if( b >= 0 ) {
+			state.x[b] += push.x * wb;
+			state.y[b] += push.y * wb;
+			state.vx[b] += n.x * impulse * wb;
+			state.vy[b] += n.y * impulse * wb;
+		}
+	}
+}
+
+void VehicleSystem::integrate( VehicleState& s, size_t first, size_t last, float dt, int steps )
+{
+	constexpr size_t block = 256;
+
+	std::array<float, block> sines, cosines;
+
+	for( size_t begin = first; begin < last; begin += block ) {
+
+		size_t count = std::min( block, last - begin );
+
+		for( int n = 0; n < steps; ++n ) {
+
+			kernels::sincos( s.heading.data() + begin, sines.data(), cosines.data(), count );
+
+			// plain arithmetic on the columns, no branches, so the compiler vectorises it
+			float * __restrict x = s.x.data() + begin;
+			float * __restrict y = s.y.data() + begin;
+			float * __restrict vx = s.vx.data() + begin;
+			float * __restrict vy = s.vy.data() + begin;
+			float * __restrict heading = s.heading.data() + begin;
+			float * __restrict yaw_rate = s.yaw_rate.data() + begin;
+			const float * __restrict drive = s.drive.data() + begin;
+			const float * __restrict brake = s.brake.data() + begin;
+			const float * __restrict drag = s.drag.data() + begin;
+			const float * __restrict turn = s.turn.data() + begin;
+			const float * __restrict grip = s.grip.data() + begin;
+
+			for( size_t i = 0; i < count; ++i ) {
+
+				float c = cosines[i], sn = sines[i];
+
+				float forward = vx[i] * c + vy[i] * sn;
+				float sideways = vy[i] * c - vx[i] * sn;
+				float speed = std::abs( forward );
+
+				// the brakes fade out towards standstill instead of reversing the car
+				float along = drive[i] - brake[i] * ( forward / ( speed + 0.5f ) ) - drag[i] * forward * speed;
+				along = std::clamp( along, -grip[i], grip[i] );
+
+				// the tyres stop the sliding within the step, with whatever grip the engine and brakes leave
+				float left = std::sqrt( std::max( grip[i] * grip[i] - along * along, 0.0f ) );
+				float across = std::clamp( -sideways / dt, -left, left );
+
+				float limit = grip[i] / ( speed + 0.1f );
+				yaw_rate[i] = std::clamp( forward * turn[i], -limit, limit );
+
+				vx[i] += ( along * c - across * sn ) * dt;
+				vy[i] += ( along * sn + across * c ) * dt;
+
+				heading[i] += yaw_rate[i] * dt;
+				x[i] += vx[i] * dt;
+				y[i] += vy[i] * dt;
+			}
+		}
+	}
+}
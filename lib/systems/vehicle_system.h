@@ -0,0 +1,89 @@
+/*
+ * vehicle_system.h Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "../core/system.h"
+#include "../core/world.h"
+
+class CollisionSystem;
+
+/*
+ * The cars, one entry per car in each array. The arrays are the state of the simulation; the
+ * components only carry the driver's inputs in and the result out each frame, and a car put
+ * somewhere else from outside.
+ */
+struct VehicleState
+{
+    std::vector<float> x, y, vx, vy, heading, yaw_rate;
+    std::vector<float> inverse_mass;
+
+    // per tick: accelerations from the inputs, turn is the yaw rate per m/s of speed
+    std::vector<float> drive, brake, drag, turn;
+    std::vector<float> grip;        // times gravity and what the car is on, the most acceleration the tyres give
+
+    size_t size() const { return x.size(); }
+    void resize( size_t count );
+    void erase( size_t slot );      // moves the last car into the slot
+};
+
+/*
+ * A planar single track car model. The engine, brakes and drag push along the heading, the tyres
+ * cancel sideways sliding and yaw the car after the front wheels, both only as far as the grip
+ * allows, so a car that asks too much drifts.
+ *
+ * Cars advance in fixed steps whatever the frame rate, and the integration is built without fused
+ * multiply-add and uses the kernels' sin and cos, so the same inputs give the same race everywhere.
+ */
+class VehicleSystem : public BaseSystem<VehicleSystem>
+{
+public:
+    static constexpr double step = 1.0 / 120.0;
+    static constexpr int max_steps = 8;                 // per frame, a slower frame falls behind instead of stalling
+    static constexpr float off_track_grip = 0.5f;      // grip on whatever is not the track surface
+    static constexpr float restitution = 0.2f;         // of the speed two cars meet with
+
+    VehicleSystem( Engine* eng ) : BaseSystem<VehicleSystem>( eng ) {};
+
+    void update( double elapsed ) override;
+    void rewind() override;
+
+    const VehicleState& get_state() const { return state; }
+    double get_time() const { return ticks * step; }        // simulated, in whole steps
+
+    // advances cars [first, last) by steps of dt, block by block so each block stays in cache
+    static void integrate( VehicleState& state, size_t first, size_t last, float dt, int steps );
+
+private:
+    VehicleState state;
+    std::vector<Entity> entities;                       // per slot
+    std::unordered_map<Entity, uint32_t> slots;
+
+    double accumulator = 0.0;
+    uint64_t ticks = 0;
+
+    void sync( World& world );
+    void sense_surface( World& world );
+    void resolve( const CollisionSystem& collisions );
+};
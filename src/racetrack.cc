@@ -17,14 +17,71 @@
  * MA 02110-1301, USA.
  */
 
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <string>
+
 #include "core/engine.h"
 #include "platforms/glfw_platform.h"
 
+// the whole of text as a port, 1 to 65535
+static bool parse_port( const char * text, uint16_t& port )
+{
+	unsigned value = 0;
+	const char * end = text + std::strlen( text );
+
+	auto [ptr, ec] = std::from_chars( text, end, value );
+	if( ec != std::errc() || ptr != end || value < 1 || value > 65535 )
+		return false;
+
+	port = uint16_t( value );
+	return true;
+}
+
+/*
+ *   racetrack [--record session] [--replay session] [--telemetry file] [--serve port] [--spectate port]
+ *
+ * --spectate shows what an engine started with --serve on the same machine is doing
+ */
 int main( int argc, char** argv )
 {
 	GLFWPlatform platform;
     Engine engine( platform );
 
+	for( int i = 1; i + 1 < argc; i += 2 ) {
+
+		std::string option = argv[i];
+
+		bool opened;
+		uint16_t port = 0;
+
+		if( ( option == "--serve" || option == "--spectate" ) && !parse_port( argv[i + 1], port ) ) {
+			std::cerr << "racetrack: bad port " << argv[i + 1] << "\n";
+			return 1;
+		}
+
+		if( option == "--record" )
+			opened = engine.record_session( argv[i + 1] );
+		else if( option == "--replay" )
+			opened = engine.replay_session( argv[i + 1] );
+		else if( option == "--telemetry" )
+			opened = engine.record_telemetry( argv[i + 1] );
+		else if( option == "--serve" )
+			opened = engine.serve( port );
+		else if( option == "--spectate" )
+			opened = engine.spectate( "127.0.0.1", port );
+		else {
+			std::cerr << "racetrack: unknown option " << option << "\n";
+			return 1;
+		}
+
+		if( !opened ) {
+			std::cerr << "racetrack: can not open " << argv[i + 1] << "\n";
+			return 1;
+		}
+	}
+
     engine.init();
     engine.run();
     engine.shutdown();
@@ -0,0 +1,111 @@
+/*
+ * racetrack_sim.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+/*
+ * Races a scene in many worlds at once without a window, as fast as the machine allows, and
+ * reports the laps driven and how many simulated seconds each wall clock second bought.
+ *
+ *   racetrack_sim [scene] [worlds] [seconds] [threads]
+ *
+ * or plays a session recorded with racetrack --record through one headless engine as fast as it
+ * goes, to time the same session on different builds:
+ *
+ *   racetrack_sim --replay session
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "core/engine.h"
+#include "core/headless_runner.h"
+#include "commands/load_request.h"
+#include "platforms/headless_platform.h"
+#include "systems/vehicle_system.h"
+
+static int replay( const std::string& session )
+{
+	HeadlessPlatform platform;
+	Engine engine( platform, true );
+
+	engine.init();
+
+	if( !engine.replay_session( session ) ) {
+		std::cerr << "racetrack_sim: can not open " << session << "\n";
+		return 1;
+	}
+
+	size_t frames = 0;
+	auto start = std::chrono::steady_clock::now();
+
+	for( ;; ++frames ) {
+		engine.step( 0.0 );
+		if( !engine.is_running() )
+			break;
+	}
+
+	double ms = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+	engine.shutdown();
+
+	std::cout << frames << " frames in " << ms << " ms, " << ms / std::max<size_t>( frames, 1 ) << " ms per frame\n";
+
+	return 0;
+}
+
+int main( int argc, char** argv )
+{
+	if( argc > 2 && std::string( argv[1] ) == "--replay" )
+		return replay( argv[2] );
+
+	std::string scene = argc > 1 ? argv[1] : "../data/race.json";
+	size_t worlds = argc > 2 ? std::stoul( argv[2] ) : 4 * std::max( 1u, std::thread::hardware_concurrency() );
+	double seconds = argc > 3 ? std::stod( argv[3] ) : 300.0;
+	unsigned threads = argc > 4 ? unsigned( std::stoul( argv[4] ) ) : 0;
+
+	HeadlessRunner runner;
+
+	runner.run( worlds, seconds, VehicleSystem::step, [&scene]( Engine& engine, size_t )
+	{
+		LoadRequest( scene ).execute( engine );
+	}, threads );
+
+	size_t cars = 0, laps = 0;
+	float best = 0.0f;
+	double total = 0.0;
+
+	for( auto& result : runner.get_results() ) {
+		cars += result.cars;
+		laps += result.laps;
+		total += double( result.mean_lap ) * result.laps;
+		if( result.laps && ( best == 0.0f || result.best_lap < best ) )
+			best = result.best_lap;
+	}
+
+	std::cout << worlds << " worlds of " << seconds << " s, " << cars << " cars, " << laps << " laps";
+	if( laps )
+		std::cout << ", best " << best << " s, mean " << total / laps << " s";
+	std::cout << "\n" << runner.simulated() << " simulated s in " << runner.wall() << " wall s, "
+		<< runner.throughput() << " simulated s per wall s\n";
+
+	return 0;
+}
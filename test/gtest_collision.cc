@@ -0,0 +1,135 @@
+/*
+ * gtest_collision.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include <glm/gtc/constants.hpp>
+
+#include "geometry/collision.h"
+
+namespace {
+
+Box box( glm::vec2 centre, float heading, glm::vec2 half_extents )
+{
+	return { centre, glm::vec2( std::cos( heading ), std::sin( heading ) ), half_extents };
+}
+
+void expect_near( glm::vec2 a, glm::vec2 b )
+{
+	EXPECT_NEAR( a.x, b.x, 1e-5f );
+	EXPECT_NEAR( a.y, b.y, 1e-5f );
+}
+
+}
+
+// the normal is along the axis of least overlap, from a towards b
+TEST( Collision, SideBySide )
+{
+	Box a = box( glm::vec2( 0.0f ), 0.0f, glm::vec2( 2.0f, 1.0f ) );
+	Contact contact;
+
+	ASSERT_TRUE( collide( a, box( glm::vec2( 3.5f, 0.5f ), 0.0f, glm::vec2( 2.0f, 1.0f ) ), contact ) );
+	expect_near( contact.normal, glm::vec2( 1.0f, 0.0f ) );
+	EXPECT_NEAR( contact.depth, 0.5f, 1e-5f );
+
+	ASSERT_TRUE( collide( a, box( glm::vec2( -1.0f, -1.5f ), 0.0f, glm::vec2( 2.0f, 1.0f ) ), contact ) );
+	expect_near( contact.normal, glm::vec2( 0.0f, -1.0f ) );
+	EXPECT_NEAR( contact.depth, 0.5f, 1e-5f );
+}
+
+// b turned a quarter of a half turn on top of a, its corner pointing down into it
+TEST( Collision, Turned )
+{
+	Box a = box( glm::vec2( 0.0f ), 0.0f, glm::vec2( 2.0f, 1.0f ) );
+	Box b = box( glm::vec2( 0.0f, 2.2f ), glm::pi<float>() / 4.0f, glm::vec2( 1.0f ) );
+
+	Contact contact;
+	ASSERT_TRUE( collide( a, b, contact ) );
+	expect_near( contact.normal, glm::vec2( 0.0f, 1.0f ) );
+	EXPECT_NEAR( contact.depth, 1.0f + std::sqrt( 2.0f ) - 2.2f, 1e-5f );
+
+	// moved clear along the normal by the depth, they only touch
+	b.centre += contact.normal * ( contact.depth + 1e-4f );
+	EXPECT_FALSE( collide( a, b, contact ) );
+}
+
+TEST( Collision, Touching )
+{
+	Box a = box( glm::vec2( 0.0f ), 0.0f, glm::vec2( 2.0f, 1.0f ) );
+	Contact contact;
+
+	EXPECT_FALSE( collide( a, box( glm::vec2( 4.0f, 0.0f ), 0.0f, glm::vec2( 2.0f, 1.0f ) ), contact ) );
+	EXPECT_FALSE( collide( a, box( glm::vec2( 0.0f, 5.0f ), 0.0f, glm::vec2( 2.0f, 1.0f ) ), contact ) );
+
+	ASSERT_TRUE( collide( a, box( glm::vec2( 3.99f, 0.0f ), 0.0f, glm::vec2( 2.0f, 1.0f ) ), contact ) );
+	expect_near( contact.normal, glm::vec2( 1.0f, 0.0f ) );
+	EXPECT_NEAR( contact.depth, 0.01f, 1e-5f );
+}
+
+// the sweep finds what testing every pair finds, as the boxes move and the sweep axis changes
+TEST( Collision, SweepFindsEveryContact )
+{
+	std::mt19937 random( 7 );
+	std::uniform_real_distribution<float> unit( 0.0f, 1.0f );
+
+	std::vector<Box> boxes;
+	for( int i = 0; i < 200; ++i )
+		boxes.push_back( box( glm::vec2( 100.0f * unit( random ), 10.0f * unit( random ) ), 6.3f * unit( random ), glm::vec2( 2.0f, 1.0f ) ) );
+
+	SweepAndPrune sweep;
+	std::vector<Contact> found;
+
+	for( int tick = 0; tick < 20; ++tick ) {
+
+		// along x at first, then spread out along y
+		for( auto& b : boxes ) {
+			b.centre += glm::vec2( unit( random ) - 0.5f, unit( random ) - 0.5f );
+			if( tick == 10 )
+				std::swap( b.centre.x, b.centre.y );
+		}
+
+		sweep.contacts( boxes, found );
+
+		std::vector<Contact> expected;
+		for( uint32_t a = 0; a < boxes.size(); ++a )
+			for( uint32_t b = a + 1; b < boxes.size(); ++b ) {
+				Contact contact;
+				if( collide( boxes[a], boxes[b], contact ) ) {
+					contact.a = a;
+					contact.b = b;
+					expected.push_back( contact );
+				}
+			}
+
+		ASSERT_EQ( found.size(), expected.size() ) << tick;
+		EXPECT_FALSE( expected.empty() );
+
+		for( size_t i = 0; i < found.size(); ++i ) {
+			EXPECT_EQ( found[i].a, expected[i].a );
+			EXPECT_EQ( found[i].b, expected[i].b );
+			EXPECT_EQ( found[i].normal, expected[i].normal );
+			EXPECT_EQ( found[i].depth, expected[i].depth );
+		}
+	}
+}
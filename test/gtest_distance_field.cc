@@ -0,0 +1,90 @@
+/*
+ * gtest_distance_field.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "geometry/distance_field.h"
+
+namespace {
+
+DistanceField::Distance ring( float radius )
+{
+	return [radius]( glm::vec2 p ) { return glm::length( p ) - radius; };
+}
+
+}
+
+TEST( DistanceField, CloseToExact )
+{
+	auto exact = ring( 20.0f );
+
+	DistanceField field;
+	field.build( glm::vec2( -25.0f ), glm::vec2( 25.0f ), 0.5f, 4.0f, exact );
+
+	std::mt19937 random( 3 );
+	std::uniform_real_distribution<float> coordinate( -25.0f, 25.0f );
+
+	for( int i = 0; i < 10000; ++i ) {
+
+		glm::vec2 p( coordinate( random ), coordinate( random ) );
+		float d = exact( p );
+
+		if( std::abs( d ) < 3.5f ) {
+			EXPECT_NEAR( field.distance( p ), d, 0.02f ) << p.x << ", " << p.y;
+		}
+		else {
+			EXPECT_GE( std::abs( field.distance( p ) ), 3.5f - 0.02f ) << p.x << ", " << p.y;
+		}
+
+		if( std::abs( d ) > 0.02f ) {
+			EXPECT_EQ( field.inside( p ), d < 0.0f );
+		}
+	}
+}
+
+TEST( DistanceField, OutsideTheField )
+{
+	DistanceField field;
+	field.build( glm::vec2( -25.0f ), glm::vec2( 25.0f ), 0.5f, 4.0f, ring( 20.0f ) );
+
+	EXPECT_TRUE( field.covers( glm::vec2( -10.0f ), glm::vec2( 10.0f ) ) );
+	EXPECT_FALSE( field.covers( glm::vec2( -10.0f ), glm::vec2( 100.0f ) ) );
+	EXPECT_EQ( field.distance( glm::vec2( 500.0f, 0.0f ) ), 4.0f );
+	EXPECT_FALSE( field.inside( glm::vec2( 500.0f, 0.0f ) ) );
+}
+
+TEST( DistanceField, RebakeFollowsTheShape )
+{
+	DistanceField field;
+	field.build( glm::vec2( -25.0f ), glm::vec2( 25.0f ), 0.5f, 4.0f, ring( 20.0f ) );
+
+	auto moved = ring( 21.0f );
+	ASSERT_TRUE( field.rebake( glm::vec2( -25.0f ), glm::vec2( 25.0f ), moved ) );
+
+	for( float angle = 0.0f; angle < 6.28f; angle += 0.1f ) {
+		glm::vec2 p = 20.5f * glm::vec2( std::cos( angle ), std::sin( angle ) );
+		EXPECT_NEAR( field.distance( p ), moved( p ), 0.02f );
+		EXPECT_TRUE( field.inside( p ) );
+	}
+
+	EXPECT_FALSE( field.rebake( glm::vec2( -25.0f ), glm::vec2( 100.0f ), moved ) );
+}
@@ -0,0 +1,110 @@
+/*
+ * gtest_geometry_system.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+
+#include <gtest/gtest.h>
+
+#include "core/engine.h"
+#include "platforms/headless_platform.h"
+#include "components/geometry_component.h"
+#include "components/mesh_component.h"
+
+namespace {
+
+class GeometryMeshes : public ::testing::Test
+{
+protected:
+	HeadlessPlatform platform;
+	Engine engine { platform, true };
+
+	void SetUp() override { engine.init(); }
+
+	Entity add( float a, float b, int segments, bool filled, glm::vec3 colour )
+	{
+		Entity e = engine.get_registry().create_entity();
+		engine.get_registry().create_component( e, "GeometryComponent" );
+
+		auto * geometry = engine.get_world().get_component<GeometryComponent>( e );
+		geometry->axis_a = a;
+		geometry->axis_b = b;
+		geometry->segments = segments;
+		geometry->closed = true;
+		geometry->filled = filled;
+		geometry->colour = colour;
+		geometry->dirty = true;
+
+		return e;
+	}
+
+	const MeshComponent& mesh( Entity e ) { return *engine.get_world().get_component<MeshComponent>( e ); }
+};
+
+}
+
+// ellipses of any size share the unit circle of their segments, fill and colour
+TEST_F( GeometryMeshes, EllipsesShareTheUnitCircle )
+{
+	glm::vec3 red( 1.0f, 0.0f, 0.0f );
+
+	Entity small = add( 2.0f, 1.0f, 32, true, red );
+	Entity large = add( 5.0f, 12.0f, 32, true, red );
+	Entity outline = add( 2.0f, 1.0f, 32, false, red );
+	Entity blue = add( 2.0f, 1.0f, 32, true, glm::vec3( 0.0f, 0.0f, 1.0f ) );
+	Entity coarse = add( 2.0f, 1.0f, 16, true, red );
+
+	engine.step( 0.0 );
+
+	ASSERT_NE( mesh( small ).data, nullptr );
+	EXPECT_EQ( mesh( small ).data, mesh( large ).data );
+	EXPECT_NE( mesh( small ).data, mesh( outline ).data );
+	EXPECT_NE( mesh( small ).data, mesh( blue ).data );
+	EXPECT_NE( mesh( small ).data, mesh( coarse ).data );
+
+	// the shared mesh is the unit circle, each entity's scale makes it its own size
+	for( auto& vertex : mesh( small ).data->vertices )
+		EXPECT_NEAR( glm::length( vertex ), vertex == glm::vec3( 0.0f ) ? 0.0f : 1.0f, 1e-5f );
+
+	EXPECT_EQ( mesh( small ).scale, glm::vec3( 2.0f, 1.0f, 1.0f ) );
+	EXPECT_EQ( mesh( large ).scale, glm::vec3( 12.0f, 5.0f, 1.0f ) );
+}
+
+// an edited shape gets a mesh of its own again, the others keep theirs
+TEST_F( GeometryMeshes, EditingOneLeavesTheOther )
+{
+	glm::vec3 red( 1.0f, 0.0f, 0.0f );
+
+	Entity first = add( 2.0f, 1.0f, 32, false, red );
+	Entity second = add( 3.0f, 3.0f, 32, false, red );
+
+	engine.step( 0.0 );
+	auto shared = mesh( first ).data;
+
+	auto * geometry = engine.get_world().get_component<GeometryComponent>( second );
+	geometry->axis_a = 4.0f;
+	geometry->segments = 64;
+	geometry->dirty = true;
+
+	engine.step( 0.0 );
+
+	EXPECT_EQ( mesh( first ).data, shared );
+	EXPECT_NE( mesh( second ).data, shared );
+	EXPECT_EQ( mesh( second ).data->vertices.size(), 65u );
+	EXPECT_EQ( mesh( second ).scale, glm::vec3( 4.0f, 3.0f, 1.0f ) );
+}
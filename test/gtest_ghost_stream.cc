@@ -0,0 +1,143 @@
+/*
+ * gtest_ghost_stream.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "geometry/ghost_stream.h"
+
+namespace {
+
+constexpr double rate = 120.0;
+constexpr size_t samples = 1200;
+
+TransformComponent on_lap( size_t i )
+{
+	double t = double( i ) / rate;
+
+	TransformComponent transform;
+	transform.translation = glm::vec3( 50.0 * std::cos( 0.3 * t ), 30.0 * std::sin( 0.3 * t ), 0.0f );
+	transform.rotation.z = float( 0.3 * t + 1.5707963 );
+
+	// a reset to the pits half way, which no prediction sees coming
+	if( i >= samples / 2 && i < samples / 2 + 3 )
+		transform.translation = glm::vec3( -200.0f, 75.0f, 0.0f );
+
+	return transform;
+}
+
+std::shared_ptr<const GhostLap> record( double start )
+{
+	GhostEncoder encoder;
+
+	for( size_t i = 0; i < samples; ++i )
+		encoder.add( start + double( i ) / rate, on_lap( i ) );
+
+	EXPECT_EQ( encoder.samples(), samples );
+	EXPECT_EQ( encoder.start_time(), start );
+
+	return std::make_shared<const GhostLap>( encoder.finish() );
+}
+
+void expect_near( const TransformComponent& a, const TransformComponent& b )
+{
+	for( int k = 0; k < 3; ++k ) {
+		EXPECT_NEAR( a.translation[k], b.translation[k], 1e-3 );
+		EXPECT_NEAR( a.rotation[k], b.rotation[k], 1e-4 );
+		EXPECT_NEAR( a.scale[k], b.scale[k], 1e-4 );
+	}
+}
+
+}
+
+TEST( GhostStream, EverySampleComesBack )
+{
+	auto lap = record( 12.5 );
+
+	EXPECT_EQ( lap->samples, samples );
+	EXPECT_NEAR( lap->duration, double( samples - 1 ) / rate, 1e-3 );
+	EXPECT_LT( lap->bytes.size(), samples * 6 );
+
+	GhostPlayer player( lap );
+	TransformComponent transform;
+
+	for( size_t i = 0; i < samples; ++i ) {
+		SCOPED_TRACE( i );
+		EXPECT_TRUE( player.transform_at( double( i ) / rate, transform ) );
+		expect_near( transform, on_lap( i ) );
+	}
+
+	EXPECT_FALSE( player.transform_at( double( samples ) / rate, transform ) );
+	expect_near( transform, on_lap( samples - 1 ) );
+}
+
+TEST( GhostStream, BetweenSamples )
+{
+	GhostPlayer player( record( 0.0 ) );
+	TransformComponent transform;
+
+	ASSERT_TRUE( player.transform_at( 100.5 / rate, transform ) );
+
+	auto a = on_lap( 100 ), b = on_lap( 101 );
+	EXPECT_NEAR( transform.translation.x, 0.5f * ( a.translation.x + b.translation.x ), 1e-3 );
+	EXPECT_NEAR( transform.translation.y, 0.5f * ( a.translation.y + b.translation.y ), 1e-3 );
+}
+
+TEST( GhostStream, BackwardsInTime )
+{
+	GhostPlayer player( record( 0.0 ) );
+	TransformComponent transform;
+
+	for( size_t i : { size_t( 900 ), size_t( 10 ), size_t( 601 ), size_t( 0 ), size_t( 1199 ) } ) {
+		SCOPED_TRACE( i );
+		player.transform_at( double( i ) / rate, transform );
+		expect_near( transform, on_lap( i ) );
+	}
+}
+
+TEST( GhostStream, EncoderStartsAfresh )
+{
+	GhostEncoder encoder;
+	encoder.add( 0.0, on_lap( 0 ) );
+	encoder.add( 1.0 / rate, on_lap( 1 ) );
+	encoder.finish();
+
+	// the next lap does not predict from the last
+	for( size_t i = 0; i < 10; ++i )
+		encoder.add( 50.0 + double( i ) / rate, on_lap( 300 + i ) );
+
+	GhostPlayer player( std::make_shared<const GhostLap>( encoder.finish() ) );
+	TransformComponent transform;
+
+	for( size_t i = 0; i < 10; ++i ) {
+		player.transform_at( double( i ) / rate, transform );
+		expect_near( transform, on_lap( 300 + i ) );
+	}
+}
+
+TEST( GhostStream, EmptyLap )
+{
+	GhostPlayer player( std::make_shared<const GhostLap>() );
+	TransformComponent transform;
+
+	EXPECT_FALSE( player.transform_at( 0.0, transform ) );
+	EXPECT_FALSE( GhostPlayer().transform_at( 0.0, transform ) );
+}
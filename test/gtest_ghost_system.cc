@@ -0,0 +1,89 @@
+/*
+ * gtest_ghost_system.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "core/engine.h"
+#include "platforms/headless_platform.h"
+#include "systems/ghost_system.h"
+#include "systems/vehicle_system.h"
+#include "components/ghost_component.h"
+#include "components/transform_component.h"
+
+namespace {
+
+// 20 s along the x axis at 10 m/s
+std::shared_ptr<const GhostLap> straight_lap()
+{
+	GhostEncoder encoder;
+
+	for( int i = 0; i <= 20 * 120; ++i ) {
+		TransformComponent transform;
+		transform.translation.x = 10.0f * float( i ) / 120.0f;
+		encoder.add( double( i ) / 120.0, transform );
+	}
+
+	auto lap = std::make_shared<GhostLap>( encoder.finish() );
+	lap->lap_time = 20.0f;
+	return lap;
+}
+
+void run( Engine& engine, int frames )
+{
+	for( int i = 0; i < frames; ++i )
+		engine.step( 1.0 / 60.0 );
+}
+
+}
+
+TEST( GhostSystem, RestoreTakesTheGhostBack )
+{
+	HeadlessPlatform platform;
+	Engine engine( platform, true );
+	engine.init();
+
+	// a parked car, so the cars' clock runs and is put back with the snapshot
+	auto& registry = engine.get_registry();
+	Entity car = registry.create_entity();
+	registry.create_component( car, "TransformComponent" );
+	registry.create_component( car, "VehicleComponent" );
+
+	Entity ghost = engine.get_system<GhostSystem>()->spawn( straight_lap() );
+	auto& world = engine.get_world();
+
+	run( engine, 60 );
+
+	Registry::Snapshot snapshot;
+	engine.snapshot( snapshot );
+	double time = world.get_component<GhostComponent>( ghost )->time;
+
+	run( engine, 60 );
+	double later = world.get_component<GhostComponent>( ghost )->time;
+	float x = world.get_component<TransformComponent>( ghost )->translation.x;
+	EXPECT_NEAR( later - time, 1.0, 1e-6 );
+
+	engine.restore( snapshot );
+	EXPECT_EQ( world.get_component<GhostComponent>( ghost )->time, time );
+
+	// the same frames again put the ghost where it was
+	run( engine, 60 );
+	EXPECT_NEAR( world.get_component<GhostComponent>( ghost )->time, later, 1e-9 );
+	EXPECT_NEAR( world.get_component<TransformComponent>( ghost )->translation.x, x, 1e-3 );
+}
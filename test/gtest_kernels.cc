@@ -0,0 +1,166 @@
+/*
+ * gtest_kernels.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "geometry/kernels.h"
+
+namespace {
+
+// runs fn under every instruction set the processor has, the results of the first are compared against
+template<typename Fn>
+void each_isa( Fn&& fn )
+{
+	kernels::Isa was = kernels::active_isa();
+
+	for( auto isa : { kernels::Isa::Scalar, kernels::Isa::SSE2, kernels::Isa::AVX2 } ) {
+		if( isa > kernels::best_isa() )
+			continue;
+
+		kernels::use_isa( isa );
+		SCOPED_TRACE( kernels::isa_name( isa ) );
+		fn();
+	}
+
+	kernels::use_isa( was );
+}
+
+// compared as bits, the versions have to agree exactly
+void expect_same( const std::vector<float>& a, const std::vector<float>& b )
+{
+	ASSERT_EQ( a.size(), b.size() );
+	EXPECT_EQ( std::memcmp( a.data(), b.data(), a.size() * sizeof(float) ), 0 );
+}
+
+// odd counts so the wide versions also run their tails
+constexpr size_t count = 1003;
+
+}
+
+TEST( Kernels, SinCosSameEverywhere )
+{
+	std::mt19937 random( 7 );
+	std::uniform_real_distribution<float> angle( -1000.0f, 1000.0f );
+
+	std::vector<float> angles( count );
+	for( float& a : angles )
+		a = angle( random );
+
+	std::vector<float> first_s, first_c;
+
+	each_isa( [&]
+	{
+		std::vector<float> s( count ), c( count );
+		kernels::sincos( angles.data(), s.data(), c.data(), count );
+
+		for( size_t i = 0; i < count; ++i ) {
+			EXPECT_NEAR( s[i], std::sin( double( angles[i] ) ), 1e-4 );
+			EXPECT_NEAR( c[i], std::cos( double( angles[i] ) ), 1e-4 );
+		}
+
+		if( first_s.empty() ) {
+			first_s = s;
+			first_c = c;
+		}
+		expect_same( s, first_s );
+		expect_same( c, first_c );
+	} );
+}
+
+TEST( Kernels, StepsSameEverywhere )
+{
+	std::vector<float> first_s, first_c;
+
+	each_isa( [&]
+	{
+		std::vector<float> s( count ), c( count );
+		kernels::sincos_steps( 0.25f, 0.01f, s.data(), c.data(), count );
+
+		if( first_s.empty() ) {
+			first_s = s;
+			first_c = c;
+		}
+		expect_same( s, first_s );
+		expect_same( c, first_c );
+	} );
+}
+
+TEST( Kernels, LakeNoiseSameEverywhere )
+{
+	std::vector<float> t( count );
+	for( size_t i = 0; i < count; ++i )
+		t[i] = float( i ) * 0.05f;
+
+	std::vector<float> first;
+
+	each_isa( [&]
+	{
+		std::vector<float> noise( count );
+		kernels::lake_noise( t.data(), 3.0f, 2.5f, noise.data(), count );
+
+		if( first.empty() )
+			first = noise;
+		expect_same( noise, first );
+	} );
+}
+
+TEST( Kernels, NormalsAndMitersSameEverywhere )
+{
+	std::mt19937 random( 11 );
+	std::uniform_real_distribution<float> jitter( -1.0f, 1.0f );
+
+	// a wiggly line with a repeated point and a reversal in it
+	std::vector<float> x( count ), y( count );
+	for( size_t i = 0; i < count; ++i ) {
+		x[i] = float( i ) + jitter( random );
+		y[i] = 10.0f * std::sin( float( i ) * 0.1f ) + jitter( random );
+	}
+	x[100] = x[99]; y[100] = y[99];
+	x[200] = x[198]; y[200] = y[198];
+
+	std::vector<float> first_nx, first_ny, first_mx, first_my, first_length;
+
+	each_isa( [&]
+	{
+		std::vector<float> nx( count - 1 ), ny( count - 1 );
+		kernels::segment_normals( x.data(), y.data(), nx.data(), ny.data(), count );
+
+		std::vector<float> mx( count - 1 ), my( count - 1 ), length( count - 1 );
+		kernels::miters( nx.data(), ny.data(), mx.data(), my.data(), length.data(), count - 1 );
+
+		EXPECT_EQ( nx[99], 0.0f );
+		EXPECT_EQ( ny[99], 0.0f );
+
+		if( first_nx.empty() ) {
+			first_nx = nx; first_ny = ny;
+			first_mx = mx; first_my = my; first_length = length;
+		}
+		expect_same( nx, first_nx );
+		expect_same( ny, first_ny );
+		expect_same( mx, first_mx );
+		expect_same( my, first_my );
+		expect_same( length, first_length );
+	} );
+}
@@ -0,0 +1,192 @@
+/*
+ * gtest_loaders.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "core/engine.h"
+#include "platforms/headless_platform.h"
+#include "commands/json_loaders.h"
+#include "commands/load_request.h"
+#include "commands/stream_load_request.h"
+#include "components/components.h"
+
+namespace {
+
+const char * scene_json = R"({
+	"prefabs": {
+		"car": {
+			"components": {
+				"Transform": { "scale": [ 2.0, 2.0, 1.0 ] },
+				"Vehicle": { "mass": 700.0, "grip": 1.4 },
+				"Collider": {}
+			}
+		}
+	},
+	"entities": [
+		{
+			"id": "track",
+			"components": {
+				"Track": { "width": 12.0, "closed": true, "colour": [ 0.5, 0.5, 0.5 ], "sectors": [ 0.5 ],
+						   "points": [ [ 0.0, 0.0 ], [ 100.0, 0.0 ], [ 100.0, 50.0 ], [ 0.0, 50.0 ] ] }
+			}
+		},
+		{
+			"id": "ring",
+			"components": {
+				"Transform": { "translation": [ 10.0, 20.0, 0.0 ] },
+				"Geometry": { "axis_a": 5.0, "axis_b": 3.0, "segments": 30.0, "filled": false, "colour": [ 0.0, 1.0, 0.0 ] }
+			}
+		},
+		{
+			"id": "car0",
+			"prefab": "car",
+			"components": { "Transform": { "translation": [ 1.0, 2.0, 0.0 ] } }
+		},
+		{
+			"prefab": "car",
+			"components": { "Vehicle": { "mass": 900.0 } }
+		}
+	]
+})";
+
+class Loaders : public ::testing::Test
+{
+protected:
+	std::filesystem::path file = std::filesystem::temp_directory_path() / "racetrack_gtest_loaders.json";
+
+	void SetUp() override { std::ofstream( file ) << scene_json; }
+	void TearDown() override { std::filesystem::remove( file ); }
+};
+
+void expect_same( const TransformComponent * a, const TransformComponent * b )
+{
+	ASSERT_EQ( a == nullptr, b == nullptr );
+	if( !a )
+		return;
+	EXPECT_EQ( a->translation, b->translation );
+	EXPECT_EQ( a->rotation, b->rotation );
+	EXPECT_EQ( a->scale, b->scale );
+}
+
+void expect_same( const TrackComponent * a, const TrackComponent * b )
+{
+	ASSERT_EQ( a == nullptr, b == nullptr );
+	if( !a )
+		return;
+	EXPECT_EQ( a->centreline, b->centreline );
+	EXPECT_EQ( a->width, b->width );
+	EXPECT_EQ( a->closed, b->closed );
+	EXPECT_EQ( a->colour, b->colour );
+	EXPECT_EQ( a->sectors, b->sectors );
+}
+
+void expect_same( const GeometryComponent * a, const GeometryComponent * b )
+{
+	ASSERT_EQ( a == nullptr, b == nullptr );
+	if( a ) {
+		EXPECT_TRUE( *a == *b );
+	}
+}
+
+void expect_same( const VehicleComponent * a, const VehicleComponent * b )
+{
+	ASSERT_EQ( a == nullptr, b == nullptr );
+	if( !a )
+		return;
+	EXPECT_EQ( a->mass, b->mass );
+	EXPECT_EQ( a->grip, b->grip );
+	EXPECT_EQ( a->engine_force, b->engine_force );
+}
+
+}
+
+TEST_F( Loaders, StreamMatchesDom )
+{
+	HeadlessPlatform platform;
+	Engine dom( platform, true ), stream( platform, true );
+	dom.init();
+	stream.init();
+
+	LoadRequest( file.string() ).execute( dom );
+	StreamLoadRequest( file.string() ).execute( stream );
+
+	auto& scene = dom.get_scene();
+	ASSERT_EQ( scene.entities.size(), 4u );
+	ASSERT_EQ( stream.get_scene().entities.size(), scene.entities.size() );
+
+	for( auto& [id, entity] : scene.entities ) {
+
+		SCOPED_TRACE( id );
+
+		auto other = stream.get_scene().entities.find( id );
+		ASSERT_NE( other, stream.get_scene().entities.end() );
+
+		// the same fingerprints, so a reload after either finds nothing changed
+		EXPECT_EQ( entity.components, other->second.components );
+
+		Entity a = entity.entity, b = other->second.entity;
+		auto& wa = dom.get_world();
+		auto& wb = stream.get_world();
+
+		expect_same( wa.get_component<TransformComponent>( a ), wb.get_component<TransformComponent>( b ) );
+		expect_same( wa.get_component<TrackComponent>( a ), wb.get_component<TrackComponent>( b ) );
+		expect_same( wa.get_component<GeometryComponent>( a ), wb.get_component<GeometryComponent>( b ) );
+		expect_same( wa.get_component<VehicleComponent>( a ), wb.get_component<VehicleComponent>( b ) );
+		EXPECT_EQ( wa.get_component<ColliderComponent>( a ) == nullptr, wb.get_component<ColliderComponent>( b ) == nullptr );
+	}
+
+	auto * track = stream.get_world().get_component<TrackComponent>( stream.get_scene().entities.at( "track" ).entity );
+	ASSERT_NE( track, nullptr );
+	EXPECT_EQ( track->centreline.size(), 4u );
+	EXPECT_EQ( track->centreline[2], glm::vec2( 100.0f, 50.0f ) );
+}
+
+TEST_F( Loaders, ParallelDecodeMatchesSerial )
+{
+	auto data = nlohmann::json::parse( scene_json );
+
+	PrefabLibrary prefabs( data["prefabs"] );
+	std::vector<ComponentPayload> serial, parallel;
+	std::unordered_map<std::string, uint64_t> hashes;
+	std::deque<nlohmann::json> merged;
+
+	for( size_t i = 0; i < data["entities"].size(); ++i )
+		prefabs.resolve( data["entities"][i], i, serial, hashes, merged );
+	parallel = serial;
+
+	decode_components( serial, 1 );
+	decode_components( parallel, 4 );
+
+	ASSERT_EQ( serial.size(), parallel.size() );
+
+	for( size_t i = 0; i < serial.size(); ++i ) {
+		EXPECT_EQ( serial[i].entity, parallel[i].entity );
+		EXPECT_EQ( serial[i].json_data, parallel[i].json_data );
+		EXPECT_EQ( serial[i].component.type(), parallel[i].component.type() );
+
+		if( auto * transform = std::any_cast<TransformComponent>( &serial[i].component ) )
+			expect_same( transform, std::any_cast<TransformComponent>( &parallel[i].component ) );
+		if( auto * track = std::any_cast<TrackComponent>( &serial[i].component ) )
+			expect_same( track, std::any_cast<TrackComponent>( &parallel[i].component ) );
+	}
+}
@@ -0,0 +1,75 @@
+/*
+ * gtest_lod.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+
+#include <gtest/gtest.h>
+
+#include <glm/gtc/constants.hpp>
+
+#include "geometry/lod.h"
+
+namespace {
+
+// the radius in pixels at which a shape needs the given number of segments
+float radius_needing( float segments )
+{
+	float a = segments / glm::pi<float>();
+	return a * a * 2.0f * lod::pixel_tolerance;
+}
+
+}
+
+TEST( Lod, Levels )
+{
+	EXPECT_EQ( lod::level_count( 64 ), 4 );
+	EXPECT_EQ( lod::level_segments( 64, 3 ), 8 );
+	EXPECT_EQ( lod::level_count( 12 ), 1 );
+}
+
+TEST( Lod, FineEnough )
+{
+	EXPECT_EQ( lod::select_level( 64, 3, radius_needing( 60.0f ) ), 0 );
+	EXPECT_EQ( lod::select_level( 64, 0, radius_needing( 20.0f ) ), 1 );
+	EXPECT_EQ( lod::select_level( 64, 0, 0.0f ), 3 );
+}
+
+// 16 segments do from 16 needed down, but are only taken from 32 once 16 is half as many again
+TEST( Lod, StaysWithinTheBand )
+{
+	for( float needed : { 11.0f, 13.0f, 15.9f } ) {
+		EXPECT_EQ( lod::select_level( 64, 1, radius_needing( needed ) ), 1 ) << needed;
+		EXPECT_EQ( lod::select_level( 64, 2, radius_needing( needed ) ), 2 ) << needed;
+	}
+
+	EXPECT_EQ( lod::select_level( 64, 1, radius_needing( 10.5f ) ), 2 );
+	EXPECT_EQ( lod::select_level( 64, 2, radius_needing( 16.5f ) ), 1 );
+}
+
+// a shape wobbling across the edge of a level keeps the one it has
+TEST( Lod, NoFlipping )
+{
+	int level = lod::select_level( 64, 0, radius_needing( 16.5f ) );
+	EXPECT_EQ( level, 1 );
+
+	for( int i = 0; i < 10; ++i ) {
+		level = lod::select_level( 64, level, radius_needing( i % 2 ? 16.5f : 15.5f ) );
+		EXPECT_EQ( level, 1 );
+	}
+}
@@ -0,0 +1,75 @@
+/*
+ * gtest_parallel.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "core/parallel.h"
+
+static std::set<std::thread::id> threads_of( size_t count )
+{
+	std::set<std::thread::id> seen;
+	std::mutex mutex;
+
+	parallel_for( count, [&]( size_t ) {
+		std::lock_guard<std::mutex> lock( mutex );
+		seen.insert( std::this_thread::get_id() );
+	}, 4 );
+
+	return seen;
+}
+
+TEST( Parallel, LimitOfOneRunsInLine )
+{
+	ThreadLimit limit( 1 );
+
+	auto seen = threads_of( 100 );
+
+	ASSERT_EQ( seen.size(), 1u );
+	EXPECT_EQ( *seen.begin(), std::this_thread::get_id() );
+
+	WorkerPool pool;
+	EXPECT_EQ( pool.size(), 1u );
+}
+
+TEST( Parallel, NestedRunsInLine )
+{
+	std::atomic<size_t> nested_threads = 0;
+
+	parallel_for( 8, [&]( size_t ) { nested_threads += threads_of( 50 ).size(); }, 4 );
+
+	EXPECT_EQ( nested_threads.load(), 8u );
+	EXPECT_EQ( thread_limit, 0u );
+}
+
+TEST( Parallel, EveryIndexOnce )
+{
+	std::vector<std::atomic<int>> hits( 1000 );
+
+	parallel_for( hits.size(), [&]( size_t i ) { ++hits[i]; }, 4 );
+
+	WorkerPool pool( 4 );
+	pool.run( hits.size(), [&]( size_t i ) { ++hits[i]; } );
+
+	for( auto& hit : hits )
+		EXPECT_EQ( hit.load(), 2 );
+}
@@ -0,0 +1,130 @@
+/*
+ * gtest_prefabs.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include "commands/json_loaders.h"
+#include "components/components.h"
+
+namespace {
+
+const nlohmann::json prefab_json = nlohmann::json::parse( R"({
+	"ring": {
+		"components": {
+			"Geometry": { "axis_a": 20.0, "axis_b": 10.0, "segments": 50.0, "filled": false, "colour": [ 1.0, 1.0, 1.0 ] },
+			"Transform": { "translation": [ 1.0, 2.0, 3.0 ], "scale": [ 2.0, 2.0, 2.0 ] }
+		}
+	}
+})" );
+
+struct Resolved
+{
+	std::vector<ComponentPayload> payloads;
+	std::unordered_map<std::string, uint64_t> hashes;
+	std::deque<nlohmann::json> merged;
+
+	template<typename T> const T * get() const
+	{
+		for( auto& payload : payloads )
+			if( auto * component = std::any_cast<T>( &payload.component ) )
+				return component;
+		return nullptr;
+	}
+};
+
+Resolved resolve( const PrefabLibrary& prefabs, const char * entity )
+{
+	// the payloads point into the json until they are decoded
+	auto json = nlohmann::json::parse( entity );
+
+	Resolved resolved;
+	prefabs.resolve( json, 0, resolved.payloads, resolved.hashes, resolved.merged );
+	decode_components( resolved.payloads );
+	return resolved;
+}
+
+}
+
+TEST( Prefabs, InstanceGetsEveryComponent )
+{
+	PrefabLibrary prefabs( prefab_json );
+	auto ring = resolve( prefabs, R"({ "prefab": "ring" })" );
+
+	ASSERT_EQ( ring.payloads.size(), 2u );
+	ASSERT_NE( ring.get<GeometryComponent>(), nullptr );
+	EXPECT_EQ( ring.get<GeometryComponent>()->axis_a, 20.0f );
+	EXPECT_EQ( ring.get<TransformComponent>()->scale, glm::vec3( 2.0f ) );
+
+	// the same fingerprint as the prefab's component written out in full
+	EXPECT_EQ( ring.hashes.at( "Geometry" ), component_hash( prefab_json["ring"]["components"]["Geometry"] ) );
+}
+
+TEST( Prefabs, OverridesAreMergedOver )
+{
+	PrefabLibrary prefabs( prefab_json );
+	auto ring = resolve( prefabs, R"({ "prefab": "ring", "components": {
+		"Geometry": { "axis_a": 5.0, "colour": [ 0.0, 1.0, 0.0 ] },
+		"Transform": { "scale": null }
+	} })" );
+
+	ASSERT_EQ( ring.payloads.size(), 2u );
+
+	auto * geometry = ring.get<GeometryComponent>();
+	ASSERT_NE( geometry, nullptr );
+	EXPECT_EQ( geometry->axis_a, 5.0f );
+	EXPECT_EQ( geometry->axis_b, 10.0f );
+	EXPECT_EQ( geometry->segments, 50 );
+	EXPECT_FALSE( geometry->filled );
+	EXPECT_EQ( geometry->colour, glm::vec3( 0.0f, 1.0f, 0.0f ) );		// arrays are replaced whole
+
+	// null takes the key out, the loader's default is used
+	auto * transform = ring.get<TransformComponent>();
+	ASSERT_NE( transform, nullptr );
+	EXPECT_EQ( transform->translation, glm::vec3( 1.0f, 2.0f, 3.0f ) );
+	EXPECT_EQ( transform->scale, glm::vec3( 1.0f ) );
+
+	auto expected = prefab_json["ring"]["components"]["Geometry"];
+	expected["axis_a"] = 5.0;
+	expected["colour"] = { 0.0, 1.0, 0.0 };
+	EXPECT_EQ( ring.hashes.at( "Geometry" ), component_hash( expected ) );
+}
+
+TEST( Prefabs, ExtraComponentsAndPlainEntities )
+{
+	PrefabLibrary prefabs( prefab_json );
+
+	auto ring = resolve( prefabs, R"({ "prefab": "ring", "components": { "Velocity": { "speed": [ 1.0, 0.0, 0.0 ] } } })" );
+	EXPECT_EQ( ring.payloads.size(), 3u );
+	ASSERT_NE( ring.get<VelocityComponent>(), nullptr );
+	EXPECT_EQ( ring.get<VelocityComponent>()->speed.x, 1.0f );
+
+	auto plain = resolve( prefabs, R"({ "components": { "Transform": { "translation": [ 4.0, 0.0, 0.0 ] } } })" );
+	ASSERT_EQ( plain.payloads.size(), 1u );
+	EXPECT_EQ( plain.get<TransformComponent>()->translation.x, 4.0f );
+}
+
+TEST( Prefabs, UnknownPrefabThrows )
+{
+	PrefabLibrary prefabs( prefab_json );
+
+	EXPECT_THROW( resolve( prefabs, R"({ "prefab": "square" })" ), std::runtime_error );
+}
@@ -0,0 +1,77 @@
+/*
+ * gtest_racing_line.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "geometry/racing_line.h"
+#include "geometry/track_index.h"
+
+static std::vector<glm::vec2> circle( float radius, int samples )
+{
+	std::vector<glm::vec2> line;
+	for( int i = 0; i < samples; ++i ) {
+		float angle = 2.0f * 3.14159265f * i / samples;
+		line.push_back( glm::vec2( radius * std::cos( angle ), radius * std::sin( angle ) ) );
+	}
+	return line;
+}
+
+TEST( RacingLine, ShortClosedTrack )
+{
+	// about 8 m round, four samples at the 2 m spacing, fewer than any coarse level has
+	TrackIndex index;
+	index.build( circle( 1.3f, 12 ), true, 10.0f );
+
+	RacingLine line;
+	line.build( index );
+
+	ASSERT_FALSE( line.empty() );
+	EXPECT_GE( line.size(), 3u );
+	EXPECT_LT( line.size(), 8u );
+
+	for( size_t i = 0; i < line.size(); ++i )
+		EXPECT_GT( line.speed_squared( i ), 0.0f );
+}
+
+TEST( RacingLine, StaysOnTrack )
+{
+	TrackIndex index;
+	index.build( circle( 100.0f, 200 ), true, 14.0f );
+
+	RacingLine line;
+	line.build( index );
+
+	ASSERT_FALSE( line.empty() );
+
+	for( size_t i = 0; i < line.size(); ++i )
+		EXPECT_LE( index.query( line.point( i ) ).distance, 7.0f - RacingLine::margin + 0.01f );
+}
+
+TEST( RacingLine, OpenTrackHasNone )
+{
+	TrackIndex index;
+	index.build( circle( 100.0f, 200 ), false, 14.0f );
+
+	RacingLine line;
+	line.build( index );
+
+	EXPECT_TRUE( line.empty() );
+}
@@ -0,0 +1,155 @@
+/*
+ * gtest_reload.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "core/engine.h"
+#include "platforms/headless_platform.h"
+#include "commands/load_request.h"
+#include "commands/reload_request.h"
+#include "components/components.h"
+
+namespace {
+
+const char * before_json = R"({
+	"entities": [
+		{ "id": "still", "components": { "Transform": { "translation": [ 1.0, 0.0, 0.0 ] }, "Velocity": { "speed": [ 1.0, 0.0, 0.0 ] } } },
+		{ "id": "moved", "components": { "Transform": { "translation": [ 2.0, 0.0, 0.0 ] } } },
+		{ "id": "gone", "components": { "Transform": { "translation": [ 3.0, 0.0, 0.0 ] } } },
+		{ "id": "stripped", "components": { "Transform": {}, "Velocity": { "speed": [ 0.0, 1.0, 0.0 ] } } }
+	]
+})";
+
+// still: the same, moved: a new translation, gone: left out, stripped: lost its velocity, new: added
+const char * after_json = R"({
+	"entities": [
+		{ "id": "new", "components": { "Transform": { "translation": [ 4.0, 0.0, 0.0 ] } } },
+		{ "id": "stripped", "components": { "Transform": {} } },
+		{ "id": "moved", "components": { "Transform": { "translation": [ 5.0, 0.0, 0.0 ] } } },
+		{ "id": "still", "components": { "Velocity": { "speed": [ 1.0, 0.0, 0.0 ] }, "Transform": { "translation": [ 1.0, 0.0, 0.0 ] } } }
+	]
+})";
+
+class Reload : public ::testing::Test
+{
+protected:
+	std::filesystem::path file = std::filesystem::temp_directory_path() / "racetrack_gtest_reload.json";
+
+	HeadlessPlatform platform;
+	Engine engine { platform, true };
+
+	void SetUp() override
+	{
+		engine.init();
+		std::ofstream( file ) << before_json;
+		LoadRequest( file.string() ).execute( engine );
+	}
+
+	void TearDown() override { std::filesystem::remove( file ); }
+
+	Entity entity( const std::string& id ) { return engine.get_scene().entities.at( id ).entity; }
+	World& world() { return engine.get_world(); }
+};
+
+}
+
+TEST_F( Reload, AppliesOnlyTheDifferences )
+{
+	Entity still = entity( "still" ), moved = entity( "moved" ), gone = entity( "gone" ), stripped = entity( "stripped" );
+
+	// changed in the world since the load, only components the file changes are loaded again
+	world().get_component<TransformComponent>( still )->translation.y = 7.0f;
+	world().get_component<TransformComponent>( moved )->translation.y = 7.0f;
+
+	std::ofstream( file ) << after_json;
+	ReloadRequest( file.string() ).execute( engine );
+	engine.get_registry().flush();
+
+	auto& scene = engine.get_scene();
+	EXPECT_EQ( scene.entities.size(), 4u );
+	EXPECT_FALSE( scene.entities.count( "gone" ) );
+
+	// entities keep their ids
+	EXPECT_EQ( entity( "still" ), still );
+	EXPECT_EQ( entity( "moved" ), moved );
+	EXPECT_EQ( entity( "stripped" ), stripped );
+
+	EXPECT_EQ( world().get_component<TransformComponent>( still )->translation, glm::vec3( 1.0f, 7.0f, 0.0f ) );
+	EXPECT_EQ( world().get_component<TransformComponent>( moved )->translation, glm::vec3( 5.0f, 0.0f, 0.0f ) );
+
+	EXPECT_EQ( world().get_component<TransformComponent>( gone ), nullptr );
+	EXPECT_EQ( world().get_component<VelocityComponent>( stripped ), nullptr );
+	ASSERT_NE( world().get_component<TransformComponent>( stripped ), nullptr );
+
+	Entity added = entity( "new" );
+	EXPECT_NE( added, InvalidEntity );
+	ASSERT_NE( world().get_component<TransformComponent>( added ), nullptr );
+	EXPECT_EQ( world().get_component<TransformComponent>( added )->translation.x, 4.0f );
+}
+
+TEST_F( Reload, SameAsLoadingAfresh )
+{
+	std::ofstream( file ) << after_json;
+	ReloadRequest( file.string() ).execute( engine );
+	engine.get_registry().flush();
+
+	Engine fresh( platform, true );
+	fresh.init();
+	LoadRequest( file.string() ).execute( fresh );
+
+	ASSERT_EQ( engine.get_scene().entities.size(), fresh.get_scene().entities.size() );
+
+	for( auto& [id, scene_entity] : fresh.get_scene().entities ) {
+
+		SCOPED_TRACE( id );
+
+		auto& reloaded = engine.get_scene().entities.at( id );
+		EXPECT_EQ( reloaded.components, scene_entity.components );
+
+		auto * a = world().get_component<TransformComponent>( reloaded.entity );
+		auto * b = fresh.get_world().get_component<TransformComponent>( scene_entity.entity );
+		ASSERT_EQ( a == nullptr, b == nullptr );
+		if( a ) {
+			EXPECT_EQ( a->translation, b->translation );
+		}
+
+		EXPECT_EQ( world().get_component<VelocityComponent>( reloaded.entity ) == nullptr,
+				   fresh.get_world().get_component<VelocityComponent>( scene_entity.entity ) == nullptr );
+	}
+}
+
+TEST_F( Reload, BadFileLeavesTheWorld )
+{
+	Entity moved = entity( "moved" );
+
+	// a duplicate id, and a file saved half way through typing
+	for( const char * bad : { R"({ "entities": [ { "id": "a" }, { "id": "a" } ] })", R"({ "entities": [ { "id": "a", )" } ) {
+
+		std::ofstream( file ) << bad;
+		EXPECT_NO_THROW( ReloadRequest( file.string() ).execute( engine ) );
+		engine.get_registry().flush();
+
+		EXPECT_EQ( engine.get_scene().entities.size(), 4u );
+		EXPECT_EQ( world().get_component<TransformComponent>( moved )->translation.x, 2.0f );
+	}
+}
@@ -0,0 +1,224 @@
+/*
+ * gtest_replication.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <tuple>
+
+#include "core/engine.h"
+#include "core/replication.h"
+#include "core/view.h"
+#include "platforms/headless_platform.h"
+#include "components/components.h"
+
+namespace {
+
+using Seen = std::tuple<float, float, float, bool, float, bool>;
+
+// what a viewer can tell of a world, the entities themselves are numbered differently
+std::vector<Seen> seen( World& world )
+{
+	std::vector<Seen> seen;
+
+	for( auto [entity, transform] : world.view<TransformComponent>() ) {
+		auto * velocity = world.get_component<VelocityComponent>( entity );
+		seen.emplace_back( transform.translation.x, transform.translation.y, transform.rotation.z,
+						   velocity != nullptr, velocity ? velocity->speed.x : 0.0f, world.get_component<PointComponent>( entity ) != nullptr );
+	}
+
+	std::sort( seen.begin(), seen.end() );
+	return seen;
+}
+
+class Replication : public ::testing::Test
+{
+protected:
+	HeadlessPlatform platform;
+	Engine server { platform, true };
+	Engine viewer { platform, true };
+
+	void SetUp() override
+	{
+		server.init();
+		viewer.init();
+
+		ASSERT_TRUE( server.serve( 0 ) );
+		ASSERT_TRUE( viewer.spectate( "127.0.0.1", server.get_replication_server()->get_port() ) );
+	}
+
+	Entity add( float x, bool moving, bool point )
+	{
+		auto& registry = server.get_registry();
+
+		Entity e = registry.create_entity();
+		registry.create_component( e, "TransformComponent" );
+		server.get_world().get_component<TransformComponent>( e )->translation = glm::vec3( x, 2.0f * x, 0.0f );
+
+		if( moving ) {
+			registry.create_component( e, "VelocityComponent" );
+			server.get_world().get_component<VelocityComponent>( e )->speed.x = x;
+		}
+		if( point )
+			registry.create_component( e, "PointComponent" );
+
+		return e;
+	}
+
+	// steps both until the viewer sees what the server has, the datagrams only go over loopback
+	bool in_step()
+	{
+		for( int i = 0; i < 100; ++i ) {
+			server.step( 0.0 );
+			std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+			viewer.step( 0.0 );
+
+			if( seen( viewer.get_world() ) == seen( server.get_world() ) )
+				return true;
+		}
+		return false;
+	}
+};
+
+}
+
+TEST_F( Replication, ViewerFollowsTheServer )
+{
+	std::vector<Entity> entities;
+	for( int i = 0; i < 200; ++i )
+		entities.push_back( add( float( i ), i % 3 == 0, i % 5 == 0 ) );
+
+	ASSERT_TRUE( in_step() );
+	EXPECT_EQ( viewer.get_replication_client()->get_entity_count(), entities.size() );
+	EXPECT_GE( server.get_replication_server()->get_stats().full_states, 1u );
+
+	// a few changes go as a delta against what the viewer acknowledged
+	auto& world = server.get_world();
+	auto& registry = server.get_registry();
+
+	for( int i = 0; i < 200; i += 7 )
+		world.get_component<TransformComponent>( entities[i] )->rotation.z = 0.5f;
+	registry.remove_entity( entities[1] );
+	registry.remove_component( entities[3], "VelocityComponent" );
+	add( -1.0f, true, true );
+
+	uint64_t full = server.get_replication_server()->get_stats().full_states;
+	ASSERT_TRUE( in_step() );
+	EXPECT_EQ( viewer.get_replication_client()->get_entity_count(), entities.size() );
+	EXPECT_EQ( server.get_replication_server()->get_stats().full_states, full );
+	EXPECT_EQ( server.get_replication_server()->get_stats().clients, 1u );
+}
+
+TEST_F( Replication, NothingChangedSendsLittle )
+{
+	for( int i = 0; i < 500; ++i )
+		add( float( i ), true, false );
+
+	ASSERT_TRUE( in_step() );
+
+	// let the acknowledgements come back so the server deltas against the latest state
+	for( int i = 0; i < 5; ++i ) {
+		server.step( 0.0 );
+		std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+		viewer.step( 0.0 );
+	}
+
+	auto& stats = server.get_replication_server()->get_stats();
+	uint64_t bytes = stats.bytes_sent, packets = stats.packets_sent;
+
+	server.step( 0.0 );
+
+	EXPECT_EQ( stats.packets_sent, packets + 1 );
+	EXPECT_LT( stats.bytes_sent - bytes, 64u );
+}
+
+TEST_F( Replication, LargeStateToASmallBuffer )
+{
+	for( int i = 0; i < 3000; ++i )
+		add( float( i ), true, false );
+
+	// a whole state is several times what this viewer's buffer takes, it goes over several updates
+	Engine small { platform, true };
+	small.init();
+
+	ReplicationClient client;
+	ASSERT_TRUE( client.connect( "127.0.0.1", server.get_replication_server()->get_port(), 32 << 10 ) );
+
+	bool caught_up = false;
+	int updates = 0;
+
+	for( ; updates < 200 && !caught_up; ++updates ) {
+		server.step( 0.0 );
+		std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+		client.update( small.get_registry(), small.get_world() );
+		small.step( 0.0 );
+
+		caught_up = seen( small.get_world() ) == seen( server.get_world() );
+	}
+
+	EXPECT_TRUE( caught_up );
+	EXPECT_GT( updates, 2 );
+	EXPECT_EQ( client.get_entity_count(), 3000u );
+}
+
+TEST_F( Replication, ServerRestarted )
+{
+	for( int i = 0; i < 50; ++i )
+		add( float( i ), i % 2 == 0, false );
+
+	Engine watcher { platform, true };
+	watcher.init();
+
+	auto first = std::make_unique<ReplicationServer>();
+	ASSERT_TRUE( first->open( 0 ) );
+	uint16_t port = first->get_port();
+
+	ReplicationClient client;
+	ASSERT_TRUE( client.connect( "127.0.0.1", port ) );
+
+	auto caught_up = [&]( ReplicationServer& serving ) {
+		for( int i = 0; i < 200; ++i ) {
+			server.step( 0.0 );
+			serving.update( server.get_world() );
+			std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+			client.update( watcher.get_registry(), watcher.get_world() );
+			watcher.step( 0.0 );
+
+			if( seen( watcher.get_world() ) == seen( server.get_world() ) )
+				return true;
+		}
+		return false;
+	};
+
+	ASSERT_TRUE( caught_up( *first ) );
+
+	// the new server counts its states from 1 again and knows nothing of the client
+	first.reset();
+	add( -1.0f, true, true );
+
+	ReplicationServer second;
+	ASSERT_TRUE( second.open( port ) );
+
+	EXPECT_TRUE( caught_up( second ) );
+	EXPECT_EQ( client.get_entity_count(), 51u );
+	EXPECT_EQ( seen( watcher.get_world() ).size(), 51u );
+}
@@ -0,0 +1,180 @@
+/*
+ * gtest_session_log.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <typeinfo>
+
+#include "core/session_log.h"
+#include "core/inputqueue.h"
+#include "core/commandqueue.h"
+#include "events/key_event.h"
+#include "events/mouse_event.h"
+#include "commands/load_request.h"
+#include "commands/region_load_request.h"
+
+namespace {
+
+struct Frame
+{
+	double elapsed;
+	std::vector<std::shared_ptr<IEvent>> events;
+	std::vector<std::shared_ptr<ICommand>> commands;
+};
+
+std::vector<Frame> frames()
+{
+	return {
+		{ 1.0 / 60.0, { std::make_shared<KeyPressEvent>( 'W', 17, 0 ), std::make_shared<MouseMoveEvent>( 10.5, -3.25 ) }, {} },
+		{ 1.0 / 30.0, {}, { std::make_shared<LoadRequest>( "data/race.json" ) } },
+		{ 0.0, {}, {} },
+		{ 0.02, { std::make_shared<MouseButtonEvent>( 1.0, 2.0, 0, 1, 4 ), std::make_shared<KeyReleaseEvent>( 'W', 17, 0 ) },
+		  { std::make_shared<RegionLoadRequest>( "data/data.json", 50.0f ), std::make_shared<LoadRequest>( "" ) } },
+	};
+}
+
+template<typename T>
+std::vector<uint8_t> bytes_of( const T& written )
+{
+	BinaryWriter out;
+	written.write( out );
+	return out.data();
+}
+
+class SessionLog : public ::testing::Test
+{
+protected:
+	std::filesystem::path file = std::filesystem::temp_directory_path() / "racetrack_gtest_session.rtsl";
+
+	void TearDown() override { std::filesystem::remove( file ); }
+
+	void record( const std::vector<Frame>& session )
+	{
+		SessionRecorder recorder;
+		ASSERT_TRUE( recorder.open( file.string() ) );
+
+		for( auto& frame : session ) {
+			recorder.begin_frame( frame.elapsed );
+			for( auto& event : frame.events )
+				recorder.record( *event );
+			for( auto& command : frame.commands )
+				recorder.record( *command );
+			recorder.end_frame();
+		}
+	}
+};
+
+}
+
+TEST_F( SessionLog, RoundTrip )
+{
+	auto session = frames();
+	record( session );
+
+	SessionReplay replay;
+	ASSERT_TRUE( replay.open( file.string() ) );
+
+	for( auto& frame : session ) {
+
+		double elapsed = -1.0;
+		InputQueue events;
+		CommandQueue commands;
+
+		ASSERT_TRUE( replay.read_events( elapsed, events ) );
+		replay.read_commands( commands );
+
+		EXPECT_EQ( elapsed, frame.elapsed );
+
+		for( auto& expected : frame.events ) {
+			auto event = events.pop();
+			ASSERT_NE( event, nullptr );
+			EXPECT_EQ( typeid( *event ), typeid( *expected ) );
+			EXPECT_EQ( bytes_of( *event ), bytes_of( *expected ) );
+		}
+		EXPECT_EQ( events.pop(), nullptr );
+
+		for( auto& expected : frame.commands ) {
+			auto command = commands.pop();
+			ASSERT_NE( command, nullptr );
+			EXPECT_EQ( typeid( *command ), typeid( *expected ) );
+			EXPECT_EQ( bytes_of( *command ), bytes_of( *expected ) );
+		}
+		EXPECT_EQ( commands.pop(), nullptr );
+	}
+
+	double elapsed;
+	InputQueue events;
+	EXPECT_FALSE( replay.read_events( elapsed, events ) );
+	EXPECT_EQ( replay.frames(), session.size() );
+}
+
+TEST_F( SessionLog, NotASession )
+{
+	std::ofstream( file ) << "{ \"entities\": [] }";
+
+	SessionReplay replay;
+	EXPECT_FALSE( replay.open( file.string() ) );
+	EXPECT_FALSE( replay.open( file.string() + ".missing" ) );
+}
+
+TEST_F( SessionLog, CutShort )
+{
+	record( frames() );
+	std::filesystem::resize_file( file, std::filesystem::file_size( file ) - 3 );
+
+	SessionReplay replay;
+	ASSERT_TRUE( replay.open( file.string() ) );
+
+	// the last frame lost its tail, the three before it still play
+	double elapsed;
+	InputQueue events;
+	CommandQueue commands;
+
+	EXPECT_NO_THROW(
+	{
+		while( replay.read_events( elapsed, events ) )
+			replay.read_commands( commands );
+	} );
+	EXPECT_EQ( replay.frames(), frames().size() - 1 );
+
+	EXPECT_FALSE( replay.read_events( elapsed, events ) );
+}
+
+TEST_F( SessionLog, Damaged )
+{
+	record( frames() );
+	std::ofstream( file, std::ios::binary | std::ios::app ) << 'X';
+
+	SessionReplay replay;
+	ASSERT_TRUE( replay.open( file.string() ) );
+
+	double elapsed;
+	InputQueue events;
+	CommandQueue commands;
+
+	EXPECT_NO_THROW(
+	{
+		while( replay.read_events( elapsed, events ) )
+			replay.read_commands( commands );
+	} );
+	EXPECT_EQ( replay.frames(), frames().size() );
+}
@@ -0,0 +1,158 @@
+/*
+ * gtest_telemetry.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <tuple>
+
+#include "core/telemetry.h"
+
+namespace {
+
+// a car driving in a circle, so neighbouring ticks differ by a little
+TelemetryRecord sample( Entity car, uint64_t tick )
+{
+	float t = float( tick ) * 0.01f + float( car );
+	return { tick, car, 100.0f * std::cos( t ), 100.0f * std::sin( t ), t, -std::sin( t ), std::cos( t ), 0.01f, 1.0f, 0.0f, float( car ) * 0.1f };
+}
+
+bool by_car( const TelemetryRecord& a, const TelemetryRecord& b ) { return std::tie( a.entity, a.tick ) < std::tie( b.entity, b.tick ); }
+
+void expect_same( const TelemetryRecord& a, const TelemetryRecord& b )
+{
+	EXPECT_EQ( a.tick, b.tick );
+	EXPECT_EQ( a.entity, b.entity );
+	EXPECT_EQ( a.x, b.x );
+	EXPECT_EQ( a.y, b.y );
+	EXPECT_EQ( a.heading, b.heading );
+	EXPECT_EQ( a.vx, b.vx );
+	EXPECT_EQ( a.vy, b.vy );
+	EXPECT_EQ( a.yaw_rate, b.yaw_rate );
+	EXPECT_EQ( a.throttle, b.throttle );
+	EXPECT_EQ( a.brake, b.brake );
+	EXPECT_EQ( a.steer, b.steer );
+}
+
+class TelemetryRoundTrip : public ::testing::TestWithParam<bool>
+{
+protected:
+	std::filesystem::path file = std::filesystem::temp_directory_path() / "racetrack_gtest_telemetry.bin";
+
+	void TearDown() override { std::filesystem::remove( file ); }
+};
+
+}
+
+// several threads push cars of their own, more than fit in one block
+TEST_P( TelemetryRoundTrip, EveryRecordComesBack )
+{
+	constexpr unsigned threads = 4;
+	constexpr Entity cars = 3;
+	constexpr uint64_t ticks = 2000;
+
+	Telemetry telemetry;
+	ASSERT_TRUE( telemetry.open( file.string(), GetParam(), 1 << 16 ) );
+
+	std::vector<std::thread> producers;
+	for( unsigned t = 0; t < threads; ++t )
+		producers.emplace_back( [&telemetry, t]
+		{
+			for( uint64_t tick = 0; tick < ticks; ++tick )
+				for( Entity car = t * cars; car < ( t + 1 ) * cars; ++car )
+					while( !telemetry.push( sample( car, tick ) ) )
+						std::this_thread::yield();
+		} );
+
+	for( auto& producer : producers )
+		producer.join();
+
+	telemetry.close();
+
+	auto stats = telemetry.get_stats();
+	size_t total = threads * cars * ticks;
+	EXPECT_EQ( stats.written, total );
+	EXPECT_EQ( stats.bytes, std::filesystem::file_size( file ) );
+
+	std::vector<TelemetryRecord> records;
+	ASSERT_TRUE( read_telemetry( file.string(), records ) );
+	ASSERT_EQ( records.size(), total );
+
+	std::sort( records.begin(), records.end(), by_car );
+
+	size_t i = 0;
+	for( Entity car = 0; car < threads * cars; ++car )
+		for( uint64_t tick = 0; tick < ticks; ++tick )
+			expect_same( records[i++], sample( car, tick ) );
+}
+
+// a count the block's size can not hold is refused before anything is sized by it
+TEST_P( TelemetryRoundTrip, DamagedCount )
+{
+	Telemetry telemetry;
+	ASSERT_TRUE( telemetry.open( file.string(), GetParam() ) );
+	for( uint64_t tick = 0; tick < 100; ++tick )
+		telemetry.push( sample( 1, tick ) );
+	telemetry.close();
+
+	for( uint32_t count : { 0x7fffffffu, 101u, 99u } ) {
+
+		{
+			std::fstream out( file, std::ios::binary | std::ios::in | std::ios::out );
+			out.seekp( 3 * sizeof( uint32_t ) );
+			out.write( reinterpret_cast<const char*>( &count ), sizeof( count ) );
+		}
+
+		std::vector<TelemetryRecord> records;
+		EXPECT_FALSE( read_telemetry( file.string(), records ) ) << count;
+	}
+}
+
+INSTANTIATE_TEST_SUITE_P( Telemetry, TelemetryRoundTrip, ::testing::Values( false, true ),
+	[]( const ::testing::TestParamInfo<bool>& info ) { return info.param ? "Delta" : "Plain"; } );
+
+TEST( Telemetry, DeltaIsSmaller )
+{
+	auto plain = std::filesystem::temp_directory_path() / "racetrack_gtest_plain.bin";
+	auto delta = std::filesystem::temp_directory_path() / "racetrack_gtest_delta.bin";
+
+	for( auto& [path, encoded] : { std::pair( plain, false ), std::pair( delta, true ) } ) {
+		Telemetry telemetry;
+		ASSERT_TRUE( telemetry.open( path.string(), encoded ) );
+		for( uint64_t tick = 0; tick < 5000; ++tick )
+			telemetry.push( sample( 1, tick ) );
+		telemetry.close();
+	}
+
+	EXPECT_LT( std::filesystem::file_size( delta ), std::filesystem::file_size( plain ) );
+
+	std::filesystem::remove( plain );
+	std::filesystem::remove( delta );
+}
+
+TEST( Telemetry, NotATelemetryFile )
+{
+	std::vector<TelemetryRecord> records;
+	EXPECT_FALSE( read_telemetry( ( std::filesystem::temp_directory_path() / "racetrack_gtest_missing.bin" ).string(), records ) );
+}
@@ -0,0 +1,166 @@
+/*
+ * gtest_timing.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <numeric>
+
+#include "core/engine.h"
+#include "platforms/headless_platform.h"
+#include "systems/timing_system.h"
+#include "components/track_component.h"
+#include "components/transform_component.h"
+
+namespace {
+
+constexpr float radius = 50.0f;
+constexpr float two_pi = 6.2831853f;
+constexpr double frame = 1.0 / 60.0;
+
+// a circle with the finish line at angle 0, driven round the way its points go
+class Timing : public ::testing::Test
+{
+protected:
+	HeadlessPlatform platform;
+	Engine engine { platform, true };
+	Entity track_entity = InvalidEntity, car = InvalidEntity;
+	float angle = 0.0f;
+
+	void SetUp() override
+	{
+		engine.init();
+
+		auto& registry = engine.get_registry();
+		track_entity = registry.create_entity();
+		registry.create_component( track_entity, "TrackComponent" );
+
+		auto& track = *engine.get_world().get_component<TrackComponent>( track_entity );
+		for( int i = 0; i < 32; ++i ) {
+			float a = float( i ) * two_pi / 32.0f;
+			track.centreline.push_back( radius * glm::vec2( std::cos( a ), std::sin( a ) ) );
+		}
+		track.width = 10.0f;
+		track.closed = true;
+		track.sectors = { 0.25f, 0.5f, 0.75f };
+		track.dirty = true;
+
+		engine.step( 0.0 );
+	}
+
+	// the car is put on the circle every frame, it has no inputs of its own
+	void place( float at )
+	{
+		angle = at;
+
+		auto& registry = engine.get_registry();
+		if( car == InvalidEntity ) {
+			car = registry.create_entity();
+			registry.create_component( car, "TransformComponent" );
+			registry.create_component( car, "VehicleComponent" );
+		}
+
+		auto * transform = engine.get_world().get_component<TransformComponent>( car );
+		transform->translation = glm::vec3( radius * std::cos( at ), radius * std::sin( at ), 0.0f );
+		transform->rotation.z = at + two_pi / 4.0f;
+	}
+
+	// at rate radians a second, until the angle is reached
+	void drive( float to, float rate )
+	{
+		float step = rate * float( frame ) * ( to > angle ? 1.0f : -1.0f );
+
+		while( ( step > 0.0f && angle < to ) || ( step < 0.0f && angle > to ) ) {
+			place( angle + step );
+			engine.step( frame );
+		}
+	}
+
+	TimingSystem& timing() { return *engine.get_system<TimingSystem>(); }
+};
+
+}
+
+TEST_F( Timing, OneLapWithItsSectors )
+{
+	place( -0.3f );
+	engine.step( frame );
+
+	// the line is crossed twice, the first starts the timing
+	drive( two_pi * 1.5f, 1.0f );
+
+	ASSERT_EQ( timing().get_laps().size(), 1u );
+	auto& lap = timing().get_laps()[0];
+
+	EXPECT_EQ( lap.car, car );
+	EXPECT_EQ( lap.lap, 1u );
+	EXPECT_NEAR( lap.time, two_pi, 0.05f );
+
+	auto sectors = timing().get_sectors( lap );
+	ASSERT_EQ( sectors.size(), 4u );
+	for( float sector : sectors )
+		EXPECT_NEAR( sector, two_pi / 4.0f, 0.05f );
+	EXPECT_NEAR( std::accumulate( sectors.begin(), sectors.end(), 0.0f ), lap.time, 1e-3f );
+
+	EXPECT_EQ( timing().get_lap( car ), 1u );
+	EXPECT_NEAR( timing().get_lap_time( car ), two_pi * 0.5f, 0.05f );
+}
+
+TEST_F( Timing, BackwardsOverTheLineDoesNotCount )
+{
+	place( 0.3f );
+	engine.step( frame );
+
+	drive( -0.3f, 1.0f );
+	drive( 0.3f, 1.0f );
+	EXPECT_LT( timing().get_lap_start( car ), 0.0 );
+
+	// round once forwards is the start of the timing, not a lap
+	drive( two_pi + 0.3f, 1.0f );
+	EXPECT_GE( timing().get_lap_start( car ), 0.0 );
+	EXPECT_TRUE( timing().get_laps().empty() );
+}
+
+TEST_F( Timing, TrackChangeKeepsEarlierLaps )
+{
+	place( -0.3f );
+	engine.step( frame );
+	drive( two_pi * 1.1f, 1.0f );
+	ASSERT_EQ( timing().get_laps().size(), 1u );
+
+	// fewer sectors from now on, timing starts over
+	auto& track = *engine.get_world().get_component<TrackComponent>( track_entity );
+	track.sectors = { 0.5f };
+	track.dirty = true;
+
+	drive( two_pi * 3.5f, 1.0f );
+
+	auto& laps = timing().get_laps();
+	ASSERT_EQ( laps.size(), 2u );
+	EXPECT_EQ( timing().sector_count(), 2u );
+
+	EXPECT_EQ( timing().get_sectors( laps[0] ).size(), 4u );
+	EXPECT_EQ( timing().get_sectors( laps[1] ).size(), 2u );
+
+	for( auto& lap : laps ) {
+		auto sectors = timing().get_sectors( lap );
+		EXPECT_NEAR( std::accumulate( sectors.begin(), sectors.end(), 0.0f ), lap.time, 1e-3f );
+	}
+}
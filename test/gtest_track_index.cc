@@ -0,0 +1,117 @@
+/*
+ * gtest_track_index.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include "core/parallel.h"
+#include "geometry/track_index.h"
+
+// a stadium, two straights joined by half circles
+static std::vector<glm::vec2> stadium( int samples )
+{
+	const float pi = 3.14159265f, straight = 400.0f, radius = 100.0f;
+	float perimeter = 2.0f * straight + 2.0f * pi * radius;
+
+	std::vector<glm::vec2> line;
+	for( int i = 0; i < samples; ++i ) {
+		float s = perimeter * i / samples;
+		if( s < straight )
+			line.push_back( { s, 0.0f } );
+		else if( ( s -= straight ) < pi * radius )
+			line.push_back( { straight + radius * std::sin( s / radius ), radius - radius * std::cos( s / radius ) } );
+		else if( ( s -= pi * radius ) < straight )
+			line.push_back( { straight - s, 2.0f * radius } );
+		else {
+			s -= straight;
+			line.push_back( { -radius * std::sin( s / radius ), radius + radius * std::cos( s / radius ) } );
+		}
+	}
+	return line;
+}
+
+static std::vector<glm::vec2> scattered( size_t count )
+{
+	std::mt19937 random( 7 );
+	std::uniform_real_distribution<float> x( -150.0f, 550.0f ), y( -60.0f, 260.0f );
+
+	std::vector<glm::vec2> positions;
+	for( size_t i = 0; i < count; ++i )
+		positions.push_back( { x( random ), y( random ) } );
+	return positions;
+}
+
+static void expect_same( const TrackQuery& got, const TrackQuery& expected )
+{
+	EXPECT_EQ( got.segment, expected.segment );
+	EXPECT_EQ( got.distance, expected.distance );
+	EXPECT_EQ( got.arc_length, expected.arc_length );
+	EXPECT_EQ( got.on_surface, expected.on_surface );
+}
+
+TEST( TrackIndex, QueryMatchesLinearScan )
+{
+	for( bool closed : { true, false } ) {
+
+		TrackIndex index;
+		index.build( stadium( 1500 ), closed, 12.0f );
+
+		for( auto position : scattered( 2000 ) )
+			expect_same( index.query( position ), index.query_linear( position ) );
+	}
+}
+
+TEST( TrackIndex, QueryFromMatchesLinearScan )
+{
+	TrackIndex index;
+	index.build( stadium( 1500 ), true, 12.0f );
+
+	size_t segment = 0;
+	for( int i = 0; i < 3000; ++i ) {
+		// a car going round a little off the centreline, starting each query where the last ended
+		glm::vec2 position = index.point_at( index.length() * i / 3000.0f ) + glm::vec2( 0.0f, 3.0f );
+		TrackQuery got = index.query_from( position, segment );
+		expect_same( got, index.query_linear( position ) );
+		segment = got.segment;
+	}
+}
+
+TEST( TrackIndex, BatchedMatchesSingle )
+{
+	TrackIndex index;
+	index.build( stadium( 1500 ), true, 12.0f );
+
+	for( size_t count : { size_t( 10 ), size_t( 300 ), size_t( 10000 ) } ) {
+
+		auto positions = scattered( count );
+		std::vector<TrackQuery> batched( count ), pooled( count );
+
+		WorkerPool pool( 4 );
+		index.query( positions.data(), batched.data(), count );
+		index.query( positions.data(), pooled.data(), count, &pool );
+
+		for( size_t i = 0; i < count; ++i ) {
+			TrackQuery single = index.query( positions[i] );
+			expect_same( batched[i], single );
+			expect_same( pooled[i], single );
+		}
+	}
+}
@@ -0,0 +1,139 @@
+/*
+ * gtest_track_system.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "core/engine.h"
+#include "platforms/headless_platform.h"
+#include "systems/track_system.h"
+#include "geometry/tessellation.h"
+#include "geometry/track_index.h"
+#include "geometry/distance_field.h"
+#include "components/track_component.h"
+
+namespace {
+
+class TrackFields : public ::testing::Test
+{
+protected:
+	HeadlessPlatform platform;
+	Engine engine { platform, true };
+	Entity entity = InvalidEntity;
+
+	void SetUp() override
+	{
+		engine.init();
+		engine.get_system<TrackSystem>()->set_field_spacing( 0.5f );
+
+		auto& registry = engine.get_registry();
+		entity = registry.create_entity();
+		registry.create_component( entity, "TrackComponent" );
+
+		auto& track = *engine.get_world().get_component<TrackComponent>( entity );
+		for( int i = 0; i < 12; ++i ) {
+			float a = float( i ) * 6.2831853f / 12.0f;
+			track.centreline.push_back( glm::vec2( 60.0f * std::cos( a ), 40.0f * std::sin( a ) ) );
+		}
+		track.width = 8.0f;
+		track.closed = true;
+		track.dirty = true;
+
+		engine.step( 0.0 );
+	}
+
+	TrackComponent& track() { return *engine.get_world().get_component<TrackComponent>( entity ); }
+
+	// drags a point over a few frames and lets go, the field catches up once the edit stops
+	void drag( size_t point, glm::vec2 by )
+	{
+		for( int i = 0; i < 3; ++i ) {
+			track().move_point( point, track().centreline[point] + by / 3.0f );
+			engine.step( 0.0 );
+		}
+		engine.step( 0.0 );
+	}
+
+	// the field and the index against the exact distance from the centreline as it is, all the way round
+	void expect_field_matches()
+	{
+		auto& t = track();
+		ASSERT_NE( t.field, nullptr );
+		ASSERT_NE( t.index, nullptr );
+
+		TrackIndex exact_index;
+		exact_index.build( tessellate_spline( t.centreline, true, 0.01f ), true, t.width );
+
+		for( int i = 0; i < 720; ++i ) {
+			float a = float( i ) * 6.2831853f / 720.0f;
+			for( float scale : { 0.85f, 1.0f, 1.1f } ) {
+				glm::vec2 p( 60.0f * scale * std::cos( a ), 40.0f * scale * std::sin( a ) );
+				float exact = exact_index.query( p ).distance - t.width * 0.5f;
+				EXPECT_NEAR( t.index->query( p ).distance - t.width * 0.5f, exact, 1e-3f ) << p.x << ", " << p.y;
+				if( std::abs( exact ) < 3.0f ) {
+					EXPECT_NEAR( t.field->distance( p ), exact, 0.05f ) << p.x << ", " << p.y;
+				}
+			}
+		}
+	}
+};
+
+}
+
+TEST_F( TrackFields, EditsRebakeTheField )
+{
+	drag( 3, glm::vec2( 10.0f, 5.0f ) );
+	expect_field_matches();
+}
+
+TEST_F( TrackFields, RestoreThenEdit )
+{
+	Registry::Snapshot snapshot;
+	engine.snapshot( snapshot );
+
+	drag( 3, glm::vec2( 15.0f, 10.0f ) );
+	engine.restore( snapshot );
+	engine.step( 0.0 );
+
+	expect_field_matches();
+
+	// an edit elsewhere after the restore still leaves no trace of the undone one
+	drag( 9, glm::vec2( -5.0f, 5.0f ) );
+	expect_field_matches();
+}
+
+TEST_F( TrackFields, RestoreToTheMiddleOfAnEdit )
+{
+	// taken while the point is held, the index and field still lag behind it then
+	track().move_point( 3, track().centreline[3] + glm::vec2( 15.0f, 10.0f ) );
+	engine.step( 0.0 );
+
+	Registry::Snapshot snapshot;
+	engine.snapshot( snapshot );
+
+	engine.step( 0.0 );
+	drag( 9, glm::vec2( -5.0f, 5.0f ) );
+
+	engine.restore( snapshot );
+	engine.step( 0.0 );
+
+	expect_field_matches();
+}
@@ -0,0 +1,121 @@
+/*
+ * gtest_triangulation.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "geometry/triangulation.h"
+
+namespace {
+
+using Polygon = std::vector<glm::vec2>;
+
+Polygon square( glm::vec2 centre, float half, bool clockwise = false )
+{
+	Polygon square { centre + glm::vec2( -half, -half ), centre + glm::vec2( half, -half ), centre + glm::vec2( half, half ), centre + glm::vec2( -half, half ) };
+	if( clockwise )
+		std::reverse( square.begin(), square.end() );
+	return square;
+}
+
+float cross( glm::vec2 a, glm::vec2 b, glm::vec2 c ) { return ( b.x - a.x ) * ( c.y - a.y ) - ( b.y - a.y ) * ( c.x - a.x ); }
+
+// every triangle counter clockwise, the area they cover, and none of them over a hole
+float covered_area( const Polygon& outline, const std::vector<Polygon>& holes, const std::vector<uint32_t>& indices )
+{
+	Polygon points = outline;
+	for( auto& hole : holes )
+		points.insert( points.end(), hole.begin(), hole.end() );
+
+	EXPECT_EQ( indices.size() % 3, 0u );
+
+	float area = 0.0f;
+
+	for( size_t i = 0; i + 2 < indices.size(); i += 3 ) {
+
+		for( size_t k = 0; k < 3; ++k )
+			EXPECT_LT( indices[i + k], points.size() );
+
+		glm::vec2 a = points[ indices[i] ], b = points[ indices[i + 1] ], c = points[ indices[i + 2] ];
+		float twice = cross( a, b, c );
+
+		EXPECT_GE( twice, 0.0f );
+		area += 0.5f * twice;
+
+		glm::vec2 centroid = ( a + b + c ) / 3.0f;
+		for( auto& hole : holes ) {
+			auto [low, high] = std::minmax_element( hole.begin(), hole.end(), []( glm::vec2 p, glm::vec2 q ) { return p.x + p.y < q.x + q.y; } );
+			bool in_hole = centroid.x > low->x && centroid.x < high->x && centroid.y > low->y && centroid.y < high->y;
+			EXPECT_FALSE( in_hole );
+		}
+	}
+
+	return area;
+}
+
+}
+
+TEST( Triangulation, PlainPolygon )
+{
+	Polygon outline = square( glm::vec2( 0.0f ), 5.0f );
+
+	EXPECT_FLOAT_EQ( covered_area( outline, {}, triangulate_polygon( outline ) ), 100.0f );
+}
+
+TEST( Triangulation, OneHole )
+{
+	Polygon outline = square( glm::vec2( 0.0f ), 5.0f );
+	std::vector<Polygon> holes { square( glm::vec2( 0.5f, -0.5f ), 2.0f, true ) };
+
+	auto indices = triangulate_polygon( outline, holes );
+
+	EXPECT_FLOAT_EQ( covered_area( outline, holes, indices ), 100.0f - 16.0f );
+}
+
+TEST( Triangulation, EitherWinding )
+{
+	// a clockwise outline with a counter clockwise hole covers the same
+	Polygon outline = square( glm::vec2( 0.0f ), 5.0f, true );
+	std::vector<Polygon> holes { square( glm::vec2( 0.0f ), 2.0f ) };
+
+	EXPECT_FLOAT_EQ( covered_area( outline, holes, triangulate_polygon( outline, holes ) ), 100.0f - 16.0f );
+}
+
+TEST( Triangulation, SeveralHoles )
+{
+	Polygon outline = square( glm::vec2( 0.0f ), 10.0f );
+	std::vector<Polygon> holes { square( glm::vec2( -5.0f, -5.0f ), 1.0f, true ), square( glm::vec2( 5.0f, -5.0f ), 1.5f, true ), square( glm::vec2( 0.0f, 5.0f ), 2.0f, true ) };
+
+	EXPECT_FLOAT_EQ( covered_area( outline, holes, triangulate_polygon( outline, holes ) ), 400.0f - 4.0f - 9.0f - 16.0f );
+}
+
+TEST( Triangulation, HoleOutsideLeftOut )
+{
+	Polygon outline = square( glm::vec2( 0.0f ), 5.0f );
+	std::vector<Polygon> holes { square( glm::vec2( 20.0f, 0.0f ), 2.0f, true ) };
+
+	auto indices = triangulate_polygon( outline, holes );
+
+	EXPECT_FLOAT_EQ( covered_area( outline, {}, indices ), 100.0f );
+	for( uint32_t index : indices )
+		EXPECT_LT( index, outline.size() );
+}
@@ -0,0 +1,133 @@
+/*
+ * gtest_vehicle.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "core/engine.h"
+#include "platforms/headless_platform.h"
+#include "systems/vehicle_system.h"
+#include "components/transform_component.h"
+#include "components/vehicle_component.h"
+
+namespace {
+
+Entity add_car( Engine& engine, glm::vec2 at, float throttle )
+{
+	auto& registry = engine.get_registry();
+
+	Entity car = registry.create_entity();
+	registry.create_component( car, "TransformComponent" );
+	registry.create_component( car, "VehicleComponent" );
+
+	engine.get_world().get_component<TransformComponent>( car )->translation = glm::vec3( at, 0.0f );
+	engine.get_world().get_component<VehicleComponent>( car )->throttle = throttle;
+
+	return car;
+}
+
+}
+
+TEST( Vehicle, RestoreTakesTheClockBack )
+{
+	HeadlessPlatform platform;
+	Engine engine( platform, true );
+	engine.init();
+
+	Entity car = add_car( engine, glm::vec2( 0.0f ), 1.0f );
+	auto * vehicles = engine.get_system<VehicleSystem>();
+
+	for( int i = 0; i < 30; ++i )
+		engine.step( 1.0 / 60.0 );
+
+	Registry::Snapshot snapshot;
+	engine.snapshot( snapshot );
+
+	double time = vehicles->get_time();
+	float x = engine.get_world().get_component<TransformComponent>( car )->translation.x;
+
+	for( int i = 0; i < 30; ++i )
+		engine.step( 1.0 / 60.0 );
+
+	float later = engine.get_world().get_component<TransformComponent>( car )->translation.x;
+	EXPECT_GT( vehicles->get_time(), time );
+
+	engine.restore( snapshot );
+
+	EXPECT_EQ( vehicles->get_time(), time );
+	EXPECT_EQ( engine.get_world().get_component<VehicleComponent>( car )->tick, uint64_t( time / VehicleSystem::step + 0.5 ) );
+
+	// the same frames again give the same race
+	for( int i = 0; i < 30; ++i )
+		engine.step( 1.0 / 60.0 );
+
+	EXPECT_NE( x, later );
+	EXPECT_EQ( engine.get_world().get_component<TransformComponent>( car )->translation.x, later );
+}
+
+TEST( Vehicle, ContactsOfThisFrame )
+{
+	HeadlessPlatform platform;
+	Engine engine( platform, true );
+	engine.init();
+
+	// placed side by side overlapping, they are pushed apart on the first step
+	Entity a = add_car( engine, glm::vec2( 0.0f, 0.0f ), 0.0f );
+	Entity b = add_car( engine, glm::vec2( 0.0f, 1.0f ), 0.0f );
+	engine.get_registry().create_component( a, "ColliderComponent" );
+	engine.get_registry().create_component( b, "ColliderComponent" );
+
+	engine.step( 1.0 / 60.0 );
+
+	auto& world = engine.get_world();
+	EXPECT_LT( world.get_component<TransformComponent>( a )->translation.y, 0.0f );
+	EXPECT_GT( world.get_component<TransformComponent>( b )->translation.y, 1.0f );
+}
+
+TEST( Vehicle, PlacedFromOutside )
+{
+	HeadlessPlatform platform;
+	Engine engine( platform, true );
+	engine.init();
+
+	Entity car = add_car( engine, glm::vec2( 0.0f ), 0.0f );
+	auto& world = engine.get_world();
+
+	for( int i = 0; i < 10; ++i )
+		engine.step( 1.0 / 60.0 );
+
+	// as a reload or a replicated state would
+	auto * transform = world.get_component<TransformComponent>( car );
+	transform->translation = glm::vec3( 50.0f, -20.0f, 0.0f );
+	transform->rotation.z = 1.0f;
+	world.get_component<VehicleComponent>( car )->velocity = glm::vec2( 0.0f, 10.0f );
+
+	engine.step( 1.0 / 60.0 );
+
+	transform = world.get_component<TransformComponent>( car );
+	EXPECT_NEAR( transform->translation.x, 50.0f, 0.01f );
+	EXPECT_GT( transform->translation.y, -20.0f );
+	EXPECT_LT( transform->translation.y, -19.0f );
+	EXPECT_NEAR( transform->rotation.z, 1.0f, 0.01f );
+
+	// and it is not moved back on the frames after
+	for( int i = 0; i < 10; ++i )
+		engine.step( 1.0 / 60.0 );
+	EXPECT_NEAR( world.get_component<TransformComponent>( car )->translation.x, 50.0f, 0.5f );
+}
@@ -0,0 +1,155 @@
+/*
+ * gtest_world.cc Copyright 2026 Alwin Leerling dna.leerling@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "core/world.h"
+#include "core/registry.h"
+
+namespace {
+
+struct Position { float x = 0.0f; float y = 0.0f; };
+struct Tag { int value = 0; };
+
+class WorldTest : public ::testing::Test
+{
+protected:
+	World world;
+	Registry registry { world };
+
+	void SetUp() override
+	{
+		registry.register_component<Position>( "Position" );
+		registry.register_component<Tag>( "Tag" );
+	}
+
+	Entity make( float x, int tag )
+	{
+		Entity e = registry.create_entity();
+		registry.create_component( e, "Position" );
+		registry.create_component( e, "Tag" );
+		*world.get_component<Position>( e ) = Position { x, -x };
+		world.get_component<Tag>( e )->value = tag;
+		return e;
+	}
+};
+
+}
+
+TEST_F( WorldTest, RemovalKeepsTheOthers )
+{
+	std::vector<Entity> entities;
+	for( int i = 0; i < 50; ++i )
+		entities.push_back( make( float(i), i ) );
+
+	for( int i = 0; i < 50; i += 3 )
+		registry.remove_component( entities[i], "Tag" );
+	registry.flush();
+
+	for( int i = 0; i < 50; ++i ) {
+		ASSERT_NE( world.get_component<Position>( entities[i] ), nullptr );
+		EXPECT_EQ( world.get_component<Position>( entities[i] )->x, float(i) );
+
+		Tag * tag = world.get_component<Tag>( entities[i] );
+		if( i % 3 == 0 )
+			EXPECT_EQ( tag, nullptr );
+		else {
+			ASSERT_NE( tag, nullptr );
+			EXPECT_EQ( tag->value, i );
+		}
+	}
+}
+
+TEST_F( WorldTest, SnapshotRoundTrip )
+{
+	std::vector<Entity> entities;
+	for( int i = 0; i < 100; ++i )
+		entities.push_back( make( float(i), i ) );
+
+	Registry::Snapshot before;
+	registry.snapshot( before );
+
+	// move everything, drop some, add some
+	for( Entity e : entities )
+		world.get_component<Position>( e )->x += 1000.0f;
+	for( int i = 0; i < 100; i += 7 )
+		registry.remove_entity( entities[i] );
+	registry.flush();
+
+	Entity added = make( -1.0f, -1 );
+
+	Registry::Snapshot after;
+	registry.snapshot( after, &before );
+
+	registry.restore( before );
+
+	for( int i = 0; i < 100; ++i ) {
+		ASSERT_NE( world.get_component<Position>( entities[i] ), nullptr );
+		EXPECT_EQ( world.get_component<Position>( entities[i] )->x, float(i) );
+		EXPECT_EQ( world.get_component<Position>( entities[i] )->y, -float(i) );
+		ASSERT_NE( world.get_component<Tag>( entities[i] ), nullptr );
+		EXPECT_EQ( world.get_component<Tag>( entities[i] )->value, i );
+	}
+	EXPECT_EQ( world.get_component<Position>( added ), nullptr );
+	EXPECT_EQ( world.get_component<Tag>( added ), nullptr );
+
+	// and forward again
+	registry.restore( after );
+
+	for( int i = 0; i < 100; ++i ) {
+		if( i % 7 == 0 )
+			EXPECT_EQ( world.get_component<Position>( entities[i] ), nullptr );
+		else {
+			ASSERT_NE( world.get_component<Position>( entities[i] ), nullptr );
+			EXPECT_EQ( world.get_component<Position>( entities[i] )->x, float(i) + 1000.0f );
+		}
+	}
+	ASSERT_NE( world.get_component<Tag>( added ), nullptr );
+	EXPECT_EQ( world.get_component<Tag>( added )->value, -1 );
+
+	// ids go on from where the snapshot was taken
+	EXPECT_EQ( registry.create_entity(), added + 1 );
+}
+
+TEST_F( WorldTest, IdsFarApart )
+{
+	auto entities = registry.create_entities( 20000 );
+
+	for( Entity e : { entities[0], entities[4095], entities[4096], entities[19999] } ) {
+		registry.create_component( e, "Tag" );
+		world.get_component<Tag>( e )->value = int(e);
+	}
+
+	EXPECT_EQ( world.get_component<Tag>( entities[1] ), nullptr );
+	EXPECT_EQ( world.get_component<Tag>( entities[10000] ), nullptr );
+	EXPECT_EQ( world.get_component<Tag>( entities[19999] )->value, int(entities[19999]) );
+
+	// the last one on a page going empties it, the entity is still asked about
+	registry.remove_component( entities[10000], "Tag" );
+	registry.remove_component( entities[19999], "Tag" );
+	registry.flush();
+
+	EXPECT_EQ( world.get_component<Tag>( entities[19999] ), nullptr );
+	EXPECT_EQ( world.get_component<Tag>( entities[4096] )->value, int(entities[4096]) );
+	EXPECT_EQ( world.get_component<Tag>( entities[4095] )->value, int(entities[4095]) );
+
+	registry.create_component( entities[19999], "Tag" );
+	EXPECT_EQ( world.get_component<Tag>( entities[19999] )->value, 0 );
+}